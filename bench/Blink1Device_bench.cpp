@@ -0,0 +1,460 @@
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "CommandTrace.hpp"
+#include "PatternFolder.hpp"
+#include "PatternSimplifier.hpp"
+#include "TraceReplayer.hpp"
+
+using namespace blink1_lib;
+
+namespace {
+    void resetFake() {
+        fake_blink1_lib::CLEAR_ALL();
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        fake_blink1_lib::SET_SERIAL("AAAA0001");
+        fake_blink1_lib::SET_CACHE_INDEX(1);
+    }
+
+    // Resets the fake library before any device members are opened
+    class FakeLibrary {
+        public:
+            FakeLibrary() {
+                resetFake();
+            }
+    };
+
+    // Opens a device with every LED and pattern line initialized, so reads succeed
+    class BenchDevice : private FakeLibrary {
+        public:
+            Blink1Device device;
+
+            BenchDevice() {
+                device.fadeToRGB(0, RGB(1, 2, 3));
+                for (std::uint8_t pos = 0; pos < 32; ++pos) {
+                    device.writePatternLineN(PatternLineN(1, 2, 3, 1, 100), pos);
+                }
+            }
+    };
+
+    // A recorded trace named by BLINK1_BENCH_TRACE, or a synthetic mix of commands if it isn't set
+    std::optional<CommandTrace> loadBenchTrace() {
+        if (const char* path = std::getenv("BLINK1_BENCH_TRACE")) {
+            return CommandTrace::load(path);
+        }
+
+        CommandTrace trace;
+        for (std::uint8_t i = 0; i < 100; ++i) {
+            CommandTrace::Entry entry;
+            entry.time = std::chrono::milliseconds(i * 10);
+            entry.command = (i % 4 == 3) ? CommandTrace::COMMAND::WRITE_PATTERN_LINE_N : CommandTrace::COMMAND::FADE_TO_RGBN;
+            entry.fadeMillis = 100;
+            entry.rgbn = RGBN(i, i, i, static_cast<std::uint8_t>(i % 2 + 1));
+            entry.pos = static_cast<std::uint8_t>(i % 32);
+            trace.add(entry);
+        }
+        return trace;
+    }
+
+    std::vector<PatternLineN> makePattern(std::size_t count) {
+        std::vector<PatternLineN> lines;
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto value = static_cast<std::uint8_t>(i);
+            lines.emplace_back(value, value, value, static_cast<std::uint8_t>(i % 2 + 1), 100);
+        }
+        return lines;
+    }
+}
+
+/****************
+ * CONSTRUCTORS *
+ ****************/
+
+static void BM_ConstructDefault(benchmark::State& state) {
+    resetFake();
+    for (auto _ : state) {
+        Blink1Device device;
+        benchmark::DoNotOptimize(device.good());
+    }
+}
+BENCHMARK(BM_ConstructDefault);
+
+static void BM_ConstructById(benchmark::State& state) {
+    resetFake();
+    for (auto _ : state) {
+        Blink1Device device(1);
+        benchmark::DoNotOptimize(device.good());
+    }
+}
+BENCHMARK(BM_ConstructById);
+
+static void BM_ConstructByPath(benchmark::State& state) {
+    resetFake();
+    const std::string path = "/dev/hidraw1";
+    for (auto _ : state) {
+        Blink1Device device(path, Blink1Device::STRING_INIT_TYPE::PATH);
+        benchmark::DoNotOptimize(device.good());
+    }
+}
+BENCHMARK(BM_ConstructByPath);
+
+static void BM_ConstructBySerial(benchmark::State& state) {
+    resetFake();
+    for (auto _ : state) {
+        Blink1Device device("AAAA0001", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        benchmark::DoNotOptimize(device.good());
+    }
+}
+BENCHMARK(BM_ConstructBySerial);
+
+static void BM_ConstructWithManyOpen(benchmark::State& state) {
+    resetFake();
+    std::vector<std::unique_ptr<Blink1Device>> openDevices;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        openDevices.push_back(std::make_unique<Blink1Device>());
+    }
+
+    for (auto _ : state) {
+        Blink1Device device;
+        benchmark::DoNotOptimize(device.getVersion());
+    }
+}
+BENCHMARK(BM_ConstructWithManyOpen)->Arg(10)->Arg(1000)->Arg(10000);
+
+static void BM_ConstructFailed(benchmark::State& state) {
+    resetFake();
+    fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(false);
+    for (auto _ : state) {
+        Blink1Device device;
+        benchmark::DoNotOptimize(device.good());
+    }
+}
+BENCHMARK(BM_ConstructFailed);
+
+/***********
+ * GETTERS *
+ ***********/
+
+static void BM_Good(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.good());
+    }
+}
+BENCHMARK(BM_Good);
+
+static void BM_GetVersion(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.getVersion());
+    }
+}
+BENCHMARK(BM_GetVersion);
+
+static void BM_GetSerial(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.getSerial());
+    }
+}
+BENCHMARK(BM_GetSerial);
+
+static void BM_IsMk2(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.isMk2());
+    }
+}
+BENCHMARK(BM_IsMk2);
+
+static void BM_GetCacheIndex(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.getCacheIndex());
+    }
+}
+BENCHMARK(BM_GetCacheIndex);
+
+static void BM_ClearCache(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.clearCache());
+    }
+}
+BENCHMARK(BM_ClearCache);
+
+static void BM_VidPid(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Blink1Device::vid());
+        benchmark::DoNotOptimize(Blink1Device::pid());
+    }
+}
+BENCHMARK(BM_VidPid);
+
+/**********
+ * COLORS *
+ **********/
+
+static void BM_FadeToRGB(benchmark::State& state) {
+    BenchDevice bench;
+    std::uint8_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.fadeToRGB(100, RGB(i, i, i)));
+        ++i;
+    }
+}
+BENCHMARK(BM_FadeToRGB);
+
+static void BM_FadeToRGBN(benchmark::State& state) {
+    BenchDevice bench;
+    std::uint8_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.fadeToRGBN(100, RGBN(i, i, i, 1)));
+        ++i;
+    }
+}
+BENCHMARK(BM_FadeToRGBN);
+
+static void BM_SetRGB(benchmark::State& state) {
+    BenchDevice bench;
+    std::uint8_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.setRGB(RGB(i, i, i)));
+        ++i;
+    }
+}
+BENCHMARK(BM_SetRGB);
+
+static void BM_SetRGBN(benchmark::State& state) {
+    BenchDevice bench;
+    std::uint8_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.setRGBN(RGBN(i, i, i, 2)));
+        ++i;
+    }
+}
+BENCHMARK(BM_SetRGBN);
+
+static void BM_FadeToRGBShadowCacheHit(benchmark::State& state) {
+    BenchDevice bench;
+    bench.device.setShadowCache(true);
+    bench.device.fadeToRGB(100, RGB(1, 2, 3));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.fadeToRGB(100, RGB(1, 2, 3)));
+    }
+}
+BENCHMARK(BM_FadeToRGBShadowCacheHit);
+
+static void BM_SetRGBWithMetrics(benchmark::State& state) {
+    BenchDevice bench;
+    bench.device.setMetricsEnabled(true);
+    std::uint8_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.setRGB(RGB(i, i, i)));
+        ++i;
+    }
+}
+BENCHMARK(BM_SetRGBWithMetrics);
+
+static void BM_ReadRGBWithFade(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.readRGBWithFade(0));
+    }
+}
+BENCHMARK(BM_ReadRGBWithFade);
+
+static void BM_ReadRGB(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.readRGB(0));
+    }
+}
+BENCHMARK(BM_ReadRGB);
+
+/************
+ * PLAYBACK *
+ ************/
+
+static void BM_Play(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.play(0));
+    }
+}
+BENCHMARK(BM_Play);
+
+static void BM_PlayLoop(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.playLoop(0, 10, 2));
+    }
+}
+BENCHMARK(BM_PlayLoop);
+
+static void BM_Stop(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.stop());
+    }
+}
+BENCHMARK(BM_Stop);
+
+static void BM_ReadPlayState(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.readPlayState());
+    }
+}
+BENCHMARK(BM_ReadPlayState);
+
+/************
+ * PATTERNS *
+ ************/
+
+static void BM_WritePatternLine(benchmark::State& state) {
+    BenchDevice bench;
+    const PatternLine line(1, 2, 3, 100);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.writePatternLine(line, 5));
+    }
+}
+BENCHMARK(BM_WritePatternLine);
+
+static void BM_WritePatternLineN(benchmark::State& state) {
+    BenchDevice bench;
+    const PatternLineN line(1, 2, 3, 2, 100);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.writePatternLineN(line, 5));
+    }
+}
+BENCHMARK(BM_WritePatternLineN);
+
+static void BM_ReadPatternLine(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.readPatternLine(5));
+    }
+}
+BENCHMARK(BM_ReadPatternLine);
+
+static void BM_ReadPatternLineN(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.readPatternLineN(5));
+    }
+}
+BENCHMARK(BM_ReadPatternLineN);
+
+static void BM_WritePattern(benchmark::State& state) {
+    BenchDevice bench;
+    const auto lines = makePattern(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.writePattern(lines, 0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WritePattern)->Arg(1)->Arg(8)->Arg(32);
+
+static void BM_SyncPatternUnchanged(benchmark::State& state) {
+    BenchDevice bench;
+    const auto lines = makePattern(static_cast<std::size_t>(state.range(0)));
+    if (bench.device.writePattern(lines, 0)) {
+        state.SkipWithError("Failed to write the initial pattern");
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.syncPattern(lines, 0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SyncPatternUnchanged)->Arg(1)->Arg(8)->Arg(32);
+
+static void BM_WriteSimplifiedPattern(benchmark::State& state) {
+    BenchDevice bench;
+    const PatternSimplifier simplifier(2);
+
+    // A slow ramp on one LED, which simplifies down to a couple of lines
+    std::vector<PatternLineN> lines;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        const auto value = static_cast<std::uint8_t>(i * 4);
+        lines.emplace_back(value, value, value, 1, 100);
+    }
+
+    std::size_t written = 0;
+    for (auto _ : state) {
+        const auto simplified = simplifier.simplify(lines);
+        benchmark::DoNotOptimize(bench.device.writePattern(simplified, 0));
+        written = simplified.size();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["lines_written"] = static_cast<double>(written);
+}
+BENCHMARK(BM_WriteSimplifiedPattern)->Arg(8)->Arg(32);
+
+static void BM_WriteFoldedPattern(benchmark::State& state) {
+    BenchDevice bench;
+
+    // The same four lines over and over, which folds down to one repetition
+    const auto block = makePattern(4);
+    std::vector<PatternLineN> lines;
+    while (lines.size() < static_cast<std::size_t>(state.range(0))) {
+        lines.insert(lines.end(), block.begin(), block.end());
+    }
+
+    std::size_t written = 0;
+    for (auto _ : state) {
+        const auto folded = PatternFolder::fold(lines);
+        benchmark::DoNotOptimize(bench.device.writePattern(folded->lines, 0));
+        benchmark::DoNotOptimize(bench.device.playLoop(folded->startPos, folded->endPos, folded->count));
+        written = folded->lines.size();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["lines_written"] = static_cast<double>(written);
+}
+BENCHMARK(BM_WriteFoldedPattern)->Arg(8)->Arg(32);
+
+static void BM_ReadPattern(benchmark::State& state) {
+    BenchDevice bench;
+    const auto count = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.readPattern(0, count));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadPattern)->Arg(1)->Arg(8)->Arg(32);
+
+static void BM_SavePattern(benchmark::State& state) {
+    BenchDevice bench;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bench.device.savePattern());
+    }
+}
+BENCHMARK(BM_SavePattern);
+
+/****************
+ * TRACE REPLAY *
+ ****************/
+
+static void BM_ReplayTrace(benchmark::State& state) {
+    BenchDevice bench;
+    const auto trace = loadBenchTrace();
+    if (!trace) {
+        state.SkipWithError("Failed to load the trace named by BLINK1_BENCH_TRACE");
+        return;
+    }
+
+    TraceReplayer replayer(bench.device);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(replayer.replay(*trace, TraceReplayer::MAX_SPEED));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(trace->size()));
+}
+BENCHMARK(BM_ReplayTrace);
@@ -0,0 +1,118 @@
+#include <cstdint>
+#include <sstream>
+
+#include "benchmark/benchmark.h"
+#include "PatternLine.hpp"
+#include "PatternLineN.hpp"
+#include "PlayState.hpp"
+#include "RGB.hpp"
+#include "RGBN.hpp"
+
+using namespace blink1_lib;
+
+namespace {
+    template <typename T>
+    T makeValue(std::uint8_t i);
+
+    template <>
+    RGB makeValue<RGB>(std::uint8_t i) {
+        return RGB(i, 2, 3);
+    }
+
+    template <>
+    RGBN makeValue<RGBN>(std::uint8_t i) {
+        return RGBN(i, 2, 3, 4);
+    }
+
+    template <>
+    PatternLine makeValue<PatternLine>(std::uint8_t i) {
+        return PatternLine(i, 2, 3, 100);
+    }
+
+    template <>
+    PatternLineN makeValue<PatternLineN>(std::uint8_t i) {
+        return PatternLineN(i, 2, 3, 4, 100);
+    }
+
+    template <>
+    PlayState makeValue<PlayState>(std::uint8_t i) {
+        return PlayState(true, i, 2, 3, 4);
+    }
+}
+
+template <typename T>
+static void BM_Construct(benchmark::State& state) {
+    std::uint8_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeValue<T>(i++));
+    }
+}
+BENCHMARK_TEMPLATE(BM_Construct, RGB);
+BENCHMARK_TEMPLATE(BM_Construct, RGBN);
+BENCHMARK_TEMPLATE(BM_Construct, PatternLine);
+BENCHMARK_TEMPLATE(BM_Construct, PatternLineN);
+BENCHMARK_TEMPLATE(BM_Construct, PlayState);
+
+template <typename T>
+static void BM_Equal(benchmark::State& state) {
+    const T first = makeValue<T>(1);
+    const T second = makeValue<T>(1);
+    benchmark::DoNotOptimize(&first);
+    benchmark::DoNotOptimize(&second);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(first == second);
+    }
+}
+BENCHMARK_TEMPLATE(BM_Equal, RGB);
+BENCHMARK_TEMPLATE(BM_Equal, RGBN);
+BENCHMARK_TEMPLATE(BM_Equal, PatternLine);
+BENCHMARK_TEMPLATE(BM_Equal, PatternLineN);
+BENCHMARK_TEMPLATE(BM_Equal, PlayState);
+
+template <typename T>
+static void BM_NotEqual(benchmark::State& state) {
+    const T first = makeValue<T>(1);
+    const T second = makeValue<T>(2);
+    benchmark::DoNotOptimize(&first);
+    benchmark::DoNotOptimize(&second);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(first != second);
+    }
+}
+BENCHMARK_TEMPLATE(BM_NotEqual, RGB);
+BENCHMARK_TEMPLATE(BM_NotEqual, RGBN);
+BENCHMARK_TEMPLATE(BM_NotEqual, PatternLine);
+BENCHMARK_TEMPLATE(BM_NotEqual, PatternLineN);
+BENCHMARK_TEMPLATE(BM_NotEqual, PlayState);
+
+template <typename T>
+static void BM_Less(benchmark::State& state) {
+    const T first = makeValue<T>(1);
+    const T second = makeValue<T>(2);
+    benchmark::DoNotOptimize(&first);
+    benchmark::DoNotOptimize(&second);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(first < second);
+    }
+}
+BENCHMARK_TEMPLATE(BM_Less, RGB);
+BENCHMARK_TEMPLATE(BM_Less, RGBN);
+BENCHMARK_TEMPLATE(BM_Less, PatternLine);
+BENCHMARK_TEMPLATE(BM_Less, PatternLineN);
+BENCHMARK_TEMPLATE(BM_Less, PlayState);
+
+template <typename T>
+static void BM_Output(benchmark::State& state) {
+    const T value = makeValue<T>(1);
+    std::ostringstream os;
+    for (auto _ : state) {
+        os.str("");
+        os << value;
+        benchmark::DoNotOptimize(os.tellp());
+    }
+}
+BENCHMARK_TEMPLATE(BM_Output, RGB);
+BENCHMARK_TEMPLATE(BM_Output, RGBN);
+BENCHMARK_TEMPLATE(BM_Output, PatternLine);
+BENCHMARK_TEMPLATE(BM_Output, PatternLineN);
+BENCHMARK_TEMPLATE(BM_Output, PlayState);
@@ -0,0 +1,147 @@
+/**
+ * @file Animation.hpp
+ * @brief Header file for blink1_lib::Animation
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Clock.hpp"
+#include "PatternLineN.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * A set of keyframe tracks, one per LED, played on a device by AnimationEngine.
+     *
+     * Each keyframe is a PatternLineN. Its LED selects the track it is added to, and its
+     * fade time is how long the LED takes to fade to the keyframe's color from the
+     * previous keyframe on the same track. A track's keyframes play one after another,
+     * so a keyframe is reached at the sum of the fade times up to and including it.
+     * Tracks play at the same time, and each one loops on its own when looping is enabled.
+     */
+    class Animation {
+        public:
+            /**
+             * The keyframe a track is fading to at some point in time
+             */
+            struct Segment {
+                /**
+                 * Position of the keyframe in the track, counting on from the end of the
+                 * track every time it loops, so it is different for every pass
+                 */
+                std::uint64_t index{0};
+
+                /**
+                 * The keyframe being faded to
+                 */
+                PatternLineN keyframe;
+
+                /**
+                 * The keyframe being faded from, or std::nullopt for the first keyframe
+                 * of a track that hasn't looped yet
+                 */
+                std::optional<PatternLineN> previous;
+
+                /**
+                 * How much of the fade is left, rounded up to the next millisecond
+                 */
+                std::chrono::milliseconds remaining{0};
+            };
+
+        private:
+            std::map<std::uint8_t, std::vector<PatternLineN>> tracks;
+            bool looping{false};
+
+        public:
+            /**
+             * Default constructor. Creates an animation with no keyframes that doesn't loop.
+             */
+            Animation() = default;
+
+            /**
+             * @param keyframes Keyframes to add, in order
+             * @param looping Whether the animation loops
+             */
+            explicit Animation(std::span<const PatternLineN> keyframes, const bool looping = false);
+
+            /**
+             * Adds a keyframe to the end of the track for its LED
+             *
+             * @param keyframe The keyframe to add
+             */
+            void addKeyframe(const PatternLineN& keyframe);
+
+            /**
+             * Sets whether each track starts again once it reaches its end
+             *
+             * @param looping Whether the animation loops
+             */
+            void setLooping(const bool looping) noexcept;
+
+            /**
+             * Returns whether the animation loops
+             *
+             * @return Whether the animation loops
+             */
+            [[nodiscard]] bool isLooping() const noexcept;
+
+            /**
+             * Returns the LEDs that have tracks
+             *
+             * @return The LEDs, in ascending order
+             */
+            [[nodiscard]] std::vector<std::uint8_t> getLeds() const;
+
+            /**
+             * Returns the keyframes on one LED's track
+             *
+             * @param ledn The LED to look up
+             *
+             * @return The keyframes, which are empty if the LED has no track
+             */
+            [[nodiscard]] const std::vector<PatternLineN>& getTrack(const std::uint8_t ledn) const noexcept;
+
+            /**
+             * Returns whether the animation has no keyframes
+             *
+             * @return true if the animation is empty, false otherwise
+             */
+            [[nodiscard]] bool empty() const noexcept;
+
+            /**
+             * Returns how long the longest track takes to play once
+             *
+             * @return The length of the animation
+             */
+            [[nodiscard]] std::chrono::milliseconds getDuration() const noexcept;
+
+            /**
+             * Returns whether the animation has played to the end. Looping animations only
+             * finish if every track has a length of 0.
+             *
+             * @param elapsed The time since the animation started
+             *
+             * @return true if nothing changes after this point, false otherwise
+             */
+            [[nodiscard]] bool isFinished(const Clock::duration elapsed) const noexcept;
+
+            /**
+             * Returns the keyframe an LED's track is fading to at a point in time. Once a
+             * track that doesn't loop has played to the end, its last keyframe is returned
+             * with no time remaining.
+             *
+             * @param ledn The LED to look up
+             * @param elapsed The time since the animation started
+             *
+             * @return The segment, or std::nullopt if the LED has no track
+             */
+            [[nodiscard]] std::optional<Segment> segmentAt(const std::uint8_t ledn, const Clock::duration elapsed) const noexcept;
+    };
+}
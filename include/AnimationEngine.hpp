@@ -0,0 +1,194 @@
+/**
+ * @file AnimationEngine.hpp
+ * @brief Header file for blink1_lib::AnimationEngine
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Animation.hpp"
+#include "Blink1Device.hpp"
+#include "Clock.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Plays Animation objects on any number of devices from a single scheduler thread.
+     *
+     * The scheduler ticks at a fixed frame rate. On each frame it works out which keyframe
+     * every track is fading to and sends a fade only when that keyframe changed since the
+     * last frame, with the fade time shortened to however much of the fade is left. The
+     * device does the fading itself, so an LED that is part way through a long fade costs
+     * nothing until its next keyframe starts.
+     *
+     * If a frame runs late, the frames that were missed are skipped rather than played
+     * in a burst, and the next frame plays wherever the animation should be by then.
+     * Keyframes that were passed over in the meantime are not sent. If the keyframe a
+     * fade starts from was passed over, it is set first so the fade starts from the
+     * right color.
+     *
+     * @note Devices should be in non-blocking mode, since a blocking fade holds up every
+     *       other device until it finishes.
+     */
+    class AnimationEngine {
+        public:
+            /**
+             * Frame rate used when none is given to the constructor
+             */
+            static constexpr double DEFAULT_FRAME_RATE = 50;
+
+            /**
+             * Highest frame rate the scheduler ticks at. A blink1 takes about a millisecond to
+             * accept each command, so faster rates would only skip frames.
+             */
+            static constexpr double MAX_FRAME_RATE = 1000;
+
+        private:
+            struct Playing {
+                std::shared_ptr<Blink1Device> device;
+                Animation animation;
+                Clock::time_point start;
+
+                // The last segment sent for each LED
+                std::map<std::uint8_t, std::uint64_t> sent;
+            };
+
+            struct FadeCommand {
+                std::uint16_t fadeMillis;
+                RGBN rgbn;
+            };
+
+            const std::shared_ptr<Clock> clock;
+            const double frameRate;
+            const Clock::duration framePeriod;
+
+            mutable std::mutex mutex;
+            std::condition_variable wakeUp;
+            std::unordered_map<const Blink1Device*, Playing> playing;
+            bool stopping{false};
+
+            // Set while a frame is being sent with the mutex released, so that play() and
+            // stop() can wait for it instead of racing the commands it's still sending
+            bool sendingFrame{false};
+            std::condition_variable frameSent;
+
+            std::uint64_t frames{0};
+            std::uint64_t skippedFrames{0};
+            std::uint64_t commandsSent{0};
+            std::uint64_t failedCommands{0};
+
+            std::thread schedulerThread;
+
+            void run();
+            void waitForFrame(std::unique_lock<std::mutex>& lock);
+            [[nodiscard]] std::vector<std::pair<std::shared_ptr<Blink1Device>, std::vector<FadeCommand>>> planFrame(const Clock::time_point now);
+
+        public:
+            /**
+             * Starts the scheduler thread
+             *
+             * @param framesPerSecond How often to tick. Values that aren't positive, and NaN, select DEFAULT_FRAME_RATE.
+             *                        Values above MAX_FRAME_RATE, including infinity, select MAX_FRAME_RATE.
+             * @param clock The clock frames are scheduled against
+             */
+            explicit AnimationEngine(const double framesPerSecond = DEFAULT_FRAME_RATE, std::shared_ptr<Clock> clock = Clock::steady());
+
+            AnimationEngine(const AnimationEngine& other) = delete;
+            AnimationEngine& operator=(const AnimationEngine& other) = delete;
+
+            /**
+             * Destructor. Stops the scheduler thread. The LEDs are left as they are.
+             */
+            ~AnimationEngine();
+
+            /**
+             * Starts playing an animation on a device from the beginning, replacing anything
+             * already playing on it. The first frame is sent on the next tick. If a frame is
+             * being sent, this waits for it to finish, so nothing from the replaced animation
+             * reaches the device afterwards.
+             *
+             * @param device The device to play on
+             * @param animation The animation to play
+             */
+            void play(std::shared_ptr<Blink1Device> device, Animation animation);
+
+            /**
+             * Stops the animation playing on a device. The LEDs are left as they are. If a
+             * frame is being sent, this waits for it to finish, so no command from the
+             * animation reaches the device after this returns.
+             *
+             * @param device The device to stop
+             *
+             * @return true if an animation was playing on the device, false otherwise
+             */
+            bool stop(const Blink1Device& device);
+
+            /**
+             * Stops every animation. Waits for a frame that is being sent, like stop().
+             */
+            void stopAll();
+
+            /**
+             * Returns whether an animation is playing on a device. Animations that don't
+             * loop stop playing once their last keyframe has been sent.
+             *
+             * @param device The device to check
+             *
+             * @return true if an animation is playing, false otherwise
+             */
+            [[nodiscard]] bool isPlaying(const Blink1Device& device) const;
+
+            /**
+             * Returns the number of devices with an animation playing
+             *
+             * @return The number of devices
+             */
+            [[nodiscard]] std::size_t playingCount() const;
+
+            /**
+             * Returns the frame rate the scheduler ticks at
+             *
+             * @return The number of frames per second
+             */
+            [[nodiscard]] double getFrameRate() const noexcept;
+
+            /**
+             * Returns the number of frames played. Frames are only counted while at least one
+             * animation is playing.
+             *
+             * @return The number of frames
+             */
+            [[nodiscard]] std::uint64_t getFrameCount() const;
+
+            /**
+             * Returns the number of frames skipped because an earlier frame ran late
+             *
+             * @return The number of skipped frames
+             */
+            [[nodiscard]] std::uint64_t getSkippedFrameCount() const;
+
+            /**
+             * Returns the number of commands sent to devices
+             *
+             * @return The number of commands
+             */
+            [[nodiscard]] std::uint64_t getCommandCount() const;
+
+            /**
+             * Returns the number of commands that failed
+             *
+             * @return The number of failed commands
+             */
+            [[nodiscard]] std::uint64_t getFailedCommandCount() const;
+    };
+}
@@ -0,0 +1,325 @@
+/**
+ * @file AsyncBlink1Device.hpp
+ * @brief Header file for blink1_lib::AsyncBlink1Device
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Blink1Device.hpp"
+#include "Clock.hpp"
+#include "PatternLine.hpp"
+#include "PatternLineN.hpp"
+#include "PlayState.hpp"
+#include "RGB.hpp"
+#include "RGBN.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Sends commands to a Blink1Device from a dedicated I/O thread.
+     *
+     * Each call places a command in a bounded queue and returns immediately with a
+     * std::future for the result. The queue is drained in order by a single thread
+     * per AsyncBlink1Device, so the calling thread never waits on a USB transfer.
+     * The results reported through the futures are the same as the ones returned by
+     * the matching Blink1Device function.
+     *
+     * Optionally, color writes that are still waiting in the queue can be coalesced
+     * so that only the newest one per LED reaches the device. See setCoalescing(bool).
+     *
+     * While the device is traced with Blink1Device::setTraceWriter(std::shared_ptr<ChromeTraceWriter>),
+     * the time each command spends waiting in the queue is traced as a "queued" span.
+     *
+     * @note The Blink1Device must outlive this object. Any commands still queued when
+     *       this object is destroyed are sent before the destructor returns.
+     */
+    class AsyncBlink1Device {
+        public:
+            /**
+             * Defines what happens when a command is submitted while the queue is full
+             */
+            enum class OVERFLOW_POLICY {
+                /** Wait for the I/O thread to make room in the queue */
+                BLOCK,
+                /** Drop the command, failing its future immediately */
+                REJECT
+            };
+
+            /**
+             * Queue capacity used when none is given to the constructor
+             */
+            static constexpr std::size_t DEFAULT_CAPACITY = 64;
+
+        private:
+            struct Command {
+                std::function<void(Blink1Device&)> run;
+
+                // Only set for color writes, which are the commands that can be coalesced
+                std::function<bool(Blink1Device&)> colorWrite;
+                std::vector<std::shared_ptr<std::promise<bool>>> colorWritePromises;
+                std::uint8_t ledn{0};
+
+                // Only set while the device is being traced
+                bool traced{false};
+                Clock::time_point enqueueTime;
+            };
+
+            Blink1Device& device;
+            const std::size_t maxQueued;
+            const OVERFLOW_POLICY policy;
+
+            mutable std::mutex queueMutex;
+            std::condition_variable commandAvailable;
+            std::condition_variable spaceAvailable;
+            std::condition_variable queueIdle;
+            std::deque<Command> commands;
+            bool commandRunning{false};
+            bool stopping{false};
+            bool coalescing{false};
+            std::uint64_t coalescedWrites{0};
+
+            std::thread ioThread;
+
+            template <typename T>
+            std::future<T> enqueue(std::function<T(Blink1Device&)> command, T rejectedValue);
+
+            std::future<bool> enqueueColorWrite(const std::uint8_t ledn, std::function<bool(Blink1Device&)> write);
+            bool coalesceColorWrite(const std::uint8_t ledn, std::function<bool(Blink1Device&)>& write, std::shared_ptr<std::promise<bool>>& promise);
+            bool waitForSpace(std::unique_lock<std::mutex>& lock);
+
+            void markEnqueued(Command& command) const;
+            void traceQueued(const Command& command) const noexcept;
+
+            void run();
+
+        public:
+            /**
+             * @param device The device to send commands to
+             * @param capacity Maximum number of commands waiting to be sent
+             * @param overflowPolicy What to do when a command is submitted to a full queue
+             */
+            explicit AsyncBlink1Device(Blink1Device& device, const std::size_t capacity = DEFAULT_CAPACITY, const OVERFLOW_POLICY overflowPolicy = OVERFLOW_POLICY::BLOCK);
+
+            AsyncBlink1Device(const AsyncBlink1Device& other) = delete;
+            AsyncBlink1Device& operator=(const AsyncBlink1Device& other) = delete;
+
+            /**
+             * Destructor. Sends any queued commands and stops the I/O thread.
+             */
+            ~AsyncBlink1Device();
+
+            /**
+             * Queues Blink1Device::fadeToRGB(const std::uint16_t, const RGB&)
+             *
+             * @param fadeMillis The amount of time in milliseconds for the fade to last
+             * @param rgb RGB color to fade to
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb);
+
+            /**
+             * Queues Blink1Device::fadeToRGBN(const std::uint16_t, const RGBN&)
+             *
+             * @param fadeMillis The amount of time in milliseconds for the fade to last
+             * @param rgbn RGB color to fade to along with which LED on the device to fade to
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn);
+
+            /**
+             * Queues Blink1Device::setRGB(const RGB&)
+             *
+             * @param rgb The color to set
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> setRGB(const RGB& rgb);
+
+            /**
+             * Queues Blink1Device::setRGBN(const RGBN&)
+             *
+             * @param rgbn The color to set along with which LED to set it on
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> setRGBN(const RGBN& rgbn);
+
+            /**
+             * Queues Blink1Device::readRGBWithFade(const std::uint8_t)
+             *
+             * @param ledn The index of the LED to read
+             *
+             * @return A future holding the PatternLine if it could be read, std::nullopt otherwise
+             */
+            std::future<std::optional<PatternLine>> readRGBWithFade(const std::uint8_t ledn);
+
+            /**
+             * Queues Blink1Device::readRGB(const std::uint8_t)
+             *
+             * @param ledn The index of the LED to read
+             *
+             * @return A future holding the RGB value if it could be read, std::nullopt otherwise
+             */
+            std::future<std::optional<RGB>> readRGB(const std::uint8_t ledn);
+
+            /**
+             * Queues Blink1Device::play(const std::uint8_t)
+             *
+             * @param pos Position to start playing from
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> play(const std::uint8_t pos);
+
+            /**
+             * Queues Blink1Device::playLoop(const std::uint8_t, const std::uint8_t, const std::uint8_t)
+             *
+             * @param startpos Start position for the loop
+             * @param endpos End position for the loop
+             * @param count Number of times to repeat (0 to repeat forever)
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> playLoop(const std::uint8_t startpos, const std::uint8_t endpos, const std::uint8_t count);
+
+            /**
+             * Queues Blink1Device::stop()
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> stop();
+
+            /**
+             * Queues Blink1Device::readPlayState()
+             *
+             * @return A future holding the PlayState if it could be read, std::nullopt otherwise
+             */
+            std::future<std::optional<PlayState>> readPlayState();
+
+            /**
+             * Queues Blink1Device::writePatternLine(const PatternLine&, const std::uint8_t)
+             *
+             * @param line The line to write
+             * @param pos The position to write the line to
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> writePatternLine(const PatternLine& line, const std::uint8_t pos);
+
+            /**
+             * Queues Blink1Device::writePatternLineN(const PatternLineN&, const std::uint8_t)
+             *
+             * @param line The line to write
+             * @param pos The position to write the line to
+             *
+             * @return A future that becomes true once the command was successfully sent to the device
+             */
+            std::future<bool> writePatternLineN(const PatternLineN& line, const std::uint8_t pos);
+
+            /**
+             * Queues Blink1Device::readPatternLine(const std::uint8_t)
+             *
+             * @param pos The position to read
+             *
+             * @return A future holding the PatternLine if it could be read, std::nullopt otherwise
+             */
+            std::future<std::optional<PatternLine>> readPatternLine(const std::uint8_t pos);
+
+            /**
+             * Queues Blink1Device::readPatternLineN(const std::uint8_t)
+             *
+             * @param pos The position to read
+             *
+             * @return A future holding the PatternLineN if it could be read, std::nullopt otherwise
+             */
+            std::future<std::optional<PatternLineN>> readPatternLineN(const std::uint8_t pos);
+
+            /**
+             * Queues Blink1Device::savePattern()
+             *
+             * @return A future that becomes true once the pattern was saved
+             */
+            std::future<bool> savePattern();
+
+            /**
+             * Queues an arbitrary command to be run against the device on the I/O thread
+             *
+             * @param command The command to run. Its return value is reported through the future.
+             *
+             * @return A future holding the value returned by the command
+             */
+            std::future<bool> submit(std::function<bool(Blink1Device&)> command);
+
+            /**
+             * Sets whether queued color writes are coalesced.
+             *
+             * When coalescing is enabled, a color write (fadeToRGB(), fadeToRGBN(), setRGB()
+             * or setRGBN()) replaces any queued color write for the same LED that has not
+             * been sent yet, and a write to the whole device (LED 0) replaces all queued
+             * per-LED writes. Writes are never coalesced across other commands, such as
+             * play() or writePatternLine(), queued between them. The futures of replaced
+             * writes report the result of the write that replaced them. By default,
+             * coalescing is disabled.
+             *
+             * @param coalesce Whether or not to coalesce color writes
+             */
+            void setCoalescing(bool coalesce);
+
+            /**
+             * Returns whether queued color writes are coalesced.
+             *
+             * @return Whether coalescing is enabled
+             *
+             * @see setCoalescing(bool)
+             */
+            [[nodiscard]] bool isCoalescing() const;
+
+            /**
+             * Returns the number of color writes that were replaced by a newer write
+             * before being sent to the device
+             *
+             * @return The number of coalesced writes
+             */
+            [[nodiscard]] std::uint64_t coalescedCount() const;
+
+            /**
+             * Waits until every command submitted so far has been sent
+             */
+            void flush();
+
+            /**
+             * Returns the number of commands waiting to be sent, not counting the one being sent
+             *
+             * @return The number of queued commands
+             */
+            [[nodiscard]] std::size_t queueDepth() const;
+
+            /**
+             * Returns the maximum number of commands that can be waiting to be sent
+             *
+             * @return The capacity of the queue
+             */
+            [[nodiscard]] std::size_t capacity() const noexcept;
+
+            /**
+             * Returns the device this object sends commands to
+             *
+             * @return The underlying Blink1Device
+             */
+            [[nodiscard]] Blink1Device& getDevice() const noexcept;
+    };
+}
@@ -5,11 +5,23 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <blink1-lib.h>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <string>
+#include <vector>
 
+#include "ChromeTraceWriter.hpp"
+#include "Clock.hpp"
+#include "DeviceMetrics.hpp"
 #include "PatternLine.hpp"
 #include "PatternLineN.hpp"
 #include "PlayState.hpp"
@@ -18,15 +30,74 @@
 
 namespace blink1_lib {
 
+    class FadeTimer;
+
     /**
      * A wrapper around the blink1 C library used to control blink1 devices
+     *
+     * All member functions are thread safe. Commands sent to one device are serialized
+     * by a mutex owned by that device, so separate devices can be used from separate
+     * threads in parallel. In blocking mode, the wait for a fade to finish happens
+     * after the mutex is released, so other threads (for example, ones calling
+     * readPlayState()) are not held up by it.
+     *
+     * Blink1Device::clearColor and Blink1Device::clearOnExit are plain members and are
+     * not protected by the mutex.
      */
     class Blink1Device {
         std::unique_ptr<blink1_device, std::function<void(blink1_device*)>> device;
-        bool blocking{false};
+        std::atomic<bool> blocking{false};
+
+        // Serializes access to the device handle and all of the state below
+        mutable std::mutex deviceMutex;
+
+        // When the last fade sent to each LED will finish, indexed by LED number
+        std::array<std::chrono::steady_clock::time_point, 256> fadeDeadlines{};
+
+        // The clock fade deadlines are measured against, and the timer for onFadeComplete()
+        // when it isn't the default clock. The clock is only changed under the mutex, but is
+        // atomic so getClock() doesn't wait for a command that is being sent.
+        std::atomic<std::shared_ptr<Clock>> clock{Clock::steady()};
+        std::shared_ptr<FadeTimer> fadeTimer;
+
+        // Last committed state of each LED, indexed by LED number. Index 0 holds the
+        // state of the whole device and is only set while every LED has the same state.
+        bool shadowCacheEnabled{false};
+        std::array<std::optional<PatternLine>, 256> shadowState;
+        std::uint64_t shadowCacheHits{0};
+        std::uint64_t shadowCacheMisses{0};
+
+        // Host-side copy of the pattern table, indexed by position. Empty slots are unknown.
+        mutable std::array<std::optional<PatternLineN>, 256> patternMirror;
+        bool patternChangedSinceSave{true};
+
+        // Per-operation metrics, or nullptr while they're disabled so that timing costs nothing
+        std::unique_ptr<DeviceMetrics> metrics;
+
+        // Where spans are recorded while tracing, and the serial they're labelled with
+        std::shared_ptr<ChromeTraceWriter> traceWriter;
+        std::string traceSerial;
+        std::atomic<bool> tracing{false};
+
+        // Whether the last command sent to the device succeeded, kept whether or not metrics are enabled
+        mutable std::atomic<bool> lastCommandSucceeded{true};
 
         static void destroyBlinkDevice(blink1_device* device) noexcept;
 
+        void updateFadeDeadline(const std::uint8_t ledn, const std::uint16_t fadeMillis) noexcept;
+        void waitIfBlocking(const std::uint8_t ledn) const noexcept;
+
+        bool shadowCacheHit(const std::uint8_t ledn, const PatternLine& line) noexcept;
+        void updateShadowCache(const std::uint8_t ledn, const std::optional<PatternLine>& line) noexcept;
+
+        bool writeMirroredPatternLine(const PatternLineN& line, const std::uint8_t pos, std::optional<std::uint8_t>& currentLedn) noexcept;
+        void updatePatternMirror(const std::uint8_t pos, const std::optional<PatternLineN>& line) noexcept;
+        bool sendSavePattern() noexcept;
+
+        [[nodiscard]] Clock::time_point startOperation() const noexcept;
+        void finishOperation(const DeviceMetrics::OPERATION operation, const Clock::time_point start, const bool success,
+                             const std::optional<std::uint8_t> ledn = std::nullopt, const std::optional<std::uint16_t> fadeMillis = std::nullopt) const noexcept;
+
         public:
             /**
              * Defines how to interpret the string initializer passed into the constructors
@@ -95,6 +166,16 @@ namespace blink1_lib {
              */
             [[nodiscard]] explicit operator bool() const noexcept;
 
+            /**
+             * Returns whether the last command sent to the device succeeded, without sending
+             * anything or locking the device. Unlike good(), which stays true once the device
+             * has been opened, this turns false when a command fails, for example because the
+             * device was unplugged, and true again when one succeeds.
+             *
+             * @return false if the last command failed, true if it succeeded or nothing has been sent yet
+             */
+            [[nodiscard]] bool isResponding() const noexcept;
+
             /**
              * Gets the version of the device that is connected. Returns std::nullopt if good() returns false
              *
@@ -107,7 +188,9 @@ namespace blink1_lib {
              * all LEDs will fade to that color.
              *
              * By default this function is non-blocking to allow for processing while the
-             * fade is occurring. This behavior can be changed with setBlocking(bool).
+             * fade is occurring. This behavior can be changed with setBlocking(bool). The
+             * end of the fade can also be waited for with waitForFade(), whenFadeComplete()
+             * or onFadeComplete().
              *
              * @param fadeMillis The amount of time in milliseconds for the fade to last
              * @param rgb RGB color to fade to
@@ -125,7 +208,9 @@ namespace blink1_lib {
              * the RGBN value.
              *
              * By default this function is non-blocking to allow for processing while the
-             * fade is occurring. This behavior can be changed with setBlocking(bool).
+             * fade is occurring. This behavior can be changed with setBlocking(bool). The
+             * end of the fade can also be waited for with waitForFade(), whenFadeComplete()
+             * or onFadeComplete().
              *
              * @param fadeMillis The amount of time in milliseconds for the fade to last
              * @param rgbn RGB color to fade to along with which LED on the device to fade to
@@ -268,22 +353,109 @@ namespace blink1_lib {
              * @note The documentation doesn't say whether this reads from volatile or
              *       non-volatile memory, but I'd assume is the volatile memory
              *
+             * The line that was read is also stored in the pattern mirror used by syncPattern().
+             *
              * @param pos The position to read
              *
              * @return The PatternLineN if it could be read successfully, std::nullopt otherwise
              */
             [[nodiscard]] std::optional<PatternLineN> readPatternLineN(const std::uint8_t pos) const noexcept;
 
+            /**
+             * Writes consecutive PatternLineN values to the device, starting at the specified position
+             *
+             * This is equivalent to calling writePatternLineN(const PatternLineN&, const std::uint8_t)
+             * for each line, except that the LED index is only sent when it differs from the
+             * one used by the previous line. Writing stops at the first line that fails.
+             *
+             * @note On mk2 devices, this saves the pattern to volatile memory. Call savePattern()
+             *       to save the pattern in volatile memory into non-volatile memory
+             *
+             * @param lines The lines to write
+             * @param startPos The position to write the first line to
+             * @see savePattern()
+             *
+             * @return std::nullopt if every line was written successfully, otherwise the position of the
+             *         first line that could not be written. Lines that would land past position 255 are not written.
+             */
+            [[nodiscard]] std::optional<std::size_t> writePattern(std::span<const PatternLineN> lines, const std::uint8_t startPos) noexcept;
+
+            /**
+             * Reads consecutive pattern lines from the device, starting at the specified position
+             *
+             * @param startPos The position of the first line to read
+             * @param count The number of lines to read
+             *
+             * @return The lines if all of them could be read successfully, std::nullopt otherwise
+             */
+            [[nodiscard]] std::optional<std::vector<PatternLineN>> readPattern(const std::uint8_t startPos, const std::size_t count) const;
+
+            /**
+             * Writes only the pattern lines that differ from what is already on the device
+             *
+             * The device's pattern table is tracked in a host-side mirror that is filled in by
+             * writePatternLineN(), writePattern(), syncPattern(), readPatternLineN() and
+             * readPattern(). Lines whose mirrored value already matches are skipped; lines
+             * that have never been written or read through this object are always written.
+             * Call readPattern() first to fill the mirror from a device that was programmed
+             * elsewhere.
+             *
+             * @param lines The lines the pattern should contain
+             * @param startPos The position of the first line
+             * @see writePattern(std::span<const PatternLineN>, const std::uint8_t)
+             * @see clearPatternMirror()
+             *
+             * @return std::nullopt if every differing line was written successfully, otherwise the
+             *         position of the first line that could not be written
+             */
+            [[nodiscard]] std::optional<std::size_t> syncPattern(std::span<const PatternLineN> lines, const std::uint8_t startPos) noexcept;
+
+            /**
+             * Returns the mirrored value of the pattern line at the given position, without
+             * communicating with the device
+             *
+             * @param pos The position to look up
+             *
+             * @return The last line written to or read from that position, or std::nullopt if it is unknown
+             * @see syncPattern(std::span<const PatternLineN>, const std::uint8_t)
+             */
+            [[nodiscard]] std::optional<PatternLineN> getMirroredPatternLine(const std::uint8_t pos) const noexcept;
+
+            /**
+             * Forgets the mirrored pattern table, so that the next syncPattern() writes every
+             * line and the next savePatternIfChanged() is sent to the device. Call this if
+             * something other than this object changes the device's pattern.
+             *
+             * @see syncPattern(std::span<const PatternLineN>, const std::uint8_t)
+             */
+            void clearPatternMirror() noexcept;
+
             /**
              * Saves the pattern in volatile memory into the non-volatile storage
              *
              * @note Based on the documentation, this probably will always return a failure due
              *       to the function call timing out before it is actually able to save to the flash
              *
+             * @see savePatternIfChanged()
+             *
              * @return true if it was saved successfully, false otherwise
              */
             bool savePattern() noexcept;
 
+            /**
+             * Same as savePattern(), except that nothing is sent and true is returned if no
+             * pattern line has changed through this object since the last successful save.
+             * Changes made by anything else, such as another process or another Blink1Device
+             * for the same device, are not noticed, so use savePattern() unless this object is
+             * the only thing that writes the pattern.
+             *
+             * @see syncPattern(std::span<const PatternLineN>, const std::uint8_t)
+             * @see clearPatternMirror()
+             *
+             * @return true if it was saved successfully or didn't need saving, false otherwise
+             */
+            bool savePatternIfChanged() noexcept;
+
             /**
              * Enables the blink1-lib gamma curve
              *
@@ -373,5 +545,222 @@ namespace blink1_lib {
              * @see setBlocking(bool)
              */
             [[nodiscard]] bool isBlocking() const noexcept;
+
+            /**
+             * Sets the clock used to track fades and to wait for them in blocking mode.
+             * Tests can pass a VirtualClock so that blocking fades and waits finish as
+             * soon as the clock is advanced instead of in real time.
+             *
+             * @param clock The clock to use. nullptr selects the default steady clock.
+             *
+             * @see getClock()
+             */
+            void setClock(std::shared_ptr<Clock> clock);
+
+            /**
+             * Returns the clock used to track fades. Unlike most methods, this doesn't wait for
+             * a command that another thread is sending.
+             *
+             * @return The device's clock
+             *
+             * @see setClock(std::shared_ptr<Clock>)
+             */
+            [[nodiscard]] std::shared_ptr<Clock> getClock() const noexcept;
+
+            /**
+             * Returns when the last fade sent to an LED will finish, measured against getClock(). Only fades sent through
+             * this object are tracked, and a fade sent to LED 0 applies to every LED.
+             *
+             * @param ledn Which LED to check. 0 returns the latest deadline of all of the LEDs.
+             *
+             * @return The time the fade finishes, which is in the past if it already finished
+             */
+            [[nodiscard]] std::chrono::steady_clock::time_point getFadeDeadline(const std::uint8_t ledn = 0) const noexcept;
+
+            /**
+             * Waits for the current fade on an LED to finish
+             *
+             * @param ledn Which LED to wait for. 0 waits for every LED.
+             *
+             * @see getFadeDeadline(const std::uint8_t)
+             */
+            void waitForFade(const std::uint8_t ledn = 0) const noexcept;
+
+            /**
+             * Waits for the current fade on an LED to finish, giving up after a timeout
+             *
+             * @param ledn Which LED to wait for. 0 waits for every LED.
+             * @param timeout The longest amount of time to wait
+             *
+             * @return true if the fade finished within the timeout, false otherwise
+             *
+             * @see getFadeDeadline(const std::uint8_t)
+             */
+            bool waitForFade(const std::uint8_t ledn, const std::chrono::milliseconds timeout) const noexcept;
+
+            /**
+             * Returns a future that becomes ready once the current fade on an LED finishes.
+             * The future is served by a FadeTimer, so no thread waits for it.
+             *
+             * @param ledn Which LED to wait for. 0 waits for every LED.
+             *
+             * @return A future that becomes ready when the fade finishes
+             *
+             * @see getFadeDeadline(const std::uint8_t)
+             */
+            [[nodiscard]] std::future<void> whenFadeComplete(const std::uint8_t ledn = 0) const;
+
+            /**
+             * Runs a callback once the current fade on an LED finishes. The callback is run
+             * on a FadeTimer's thread, so it should be short and must not throw. With the
+             * default clock it may be run after this object is destroyed. With any other
+             * clock, callbacks still pending when this object is destroyed are discarded.
+             *
+             * @param ledn Which LED to wait for. 0 waits for every LED.
+             * @param callback The callback to run
+             *
+             * @see getFadeDeadline(const std::uint8_t)
+             */
+            void onFadeComplete(const std::uint8_t ledn, std::function<void()> callback) const;
+
+            /**
+             * Enables or disables the shadow cache for this device.
+             *
+             * When the shadow cache is enabled, the device keeps a copy of the color and
+             * fade time last written to each LED. fadeToRGB(), fadeToRGBN(), setRGB() and
+             * setRGBN() are skipped when they would not change anything, and return true
+             * without sending a command to the device, even in blocking mode.
+             *
+             * The cache is cleared by play(), playLoop() and any color write that fails,
+             * as well as by enabling or disabling it. If something other than this object
+             * changes the LEDs, call invalidateShadowCache(). By default, the shadow cache
+             * is disabled.
+             *
+             * @param enabled Whether or not to use the shadow cache
+             */
+            void setShadowCache(bool enabled) noexcept;
+
+            /**
+             * Returns whether the shadow cache is enabled.
+             *
+             * @return Whether the shadow cache is enabled
+             *
+             * @see setShadowCache(bool)
+             */
+            [[nodiscard]] bool isShadowCacheEnabled() const noexcept;
+
+            /**
+             * Forgets the cached state of every LED, so that the next write to each LED
+             * is sent to the device.
+             *
+             * @see setShadowCache(bool)
+             */
+            void invalidateShadowCache() noexcept;
+
+            /**
+             * Returns the number of color writes that were skipped by the shadow cache
+             *
+             * @return The number of cache hits
+             */
+            [[nodiscard]] std::uint64_t getShadowCacheHits() const noexcept;
+
+            /**
+             * Returns the number of color writes that were sent to the device while the
+             * shadow cache was enabled
+             *
+             * @return The number of cache misses
+             */
+            [[nodiscard]] std::uint64_t getShadowCacheMisses() const noexcept;
+
+            /**
+             * Enables or disables metrics for this device.
+             *
+             * While metrics are enabled, every call that communicates with the device is
+             * counted and timed against getClock(), separately for each type of operation.
+             * The time measured is how long the blink1 C library call took, which for real
+             * devices is mostly the USB round trip; time spent waiting for other threads or
+             * for fades in blocking mode is not included. While metrics are disabled, which
+             * is the default, nothing is measured and the only cost is one pointer check
+             * per call.
+             *
+             * Disabling metrics discards everything recorded. Enabling them when they are
+             * already enabled keeps what has been recorded.
+             *
+             * @param enabled Whether or not to record metrics
+             *
+             * @see getMetrics()
+             */
+            void setMetricsEnabled(bool enabled);
+
+            /**
+             * Returns whether metrics are enabled.
+             *
+             * @return Whether metrics are enabled
+             *
+             * @see setMetricsEnabled(bool)
+             */
+            [[nodiscard]] bool isMetricsEnabled() const noexcept;
+
+            /**
+             * Returns a snapshot of the metrics recorded so far. The snapshot is a copy, so it
+             * is not changed by later calls and can be read without holding up the device.
+             *
+             * @return The metrics, or std::nullopt if metrics are disabled
+             *
+             * @see setMetricsEnabled(bool)
+             */
+            [[nodiscard]] std::optional<DeviceMetrics> getMetrics() const;
+
+            /**
+             * Clears the metrics recorded so far, without disabling them
+             *
+             * @see setMetricsEnabled(bool)
+             */
+            void resetMetrics() noexcept;
+
+            /**
+             * Starts or stops tracing this device.
+             *
+             * While tracing, every call that communicates with the device adds a span to the
+             * writer, on a track named after the device's serial, holding the LED and fade time
+             * the call used and whether it succeeded. Successful fades also add a span lasting
+             * as long as the fade. Spans are timed against getClock() and cover the same time
+             * as the latencies recorded by setMetricsEnabled(bool). By default, tracing is
+             * disabled.
+             *
+             * @param writer The writer to add spans to. nullptr stops tracing.
+             *
+             * @see ChromeTraceWriter
+             */
+            void setTraceWriter(std::shared_ptr<ChromeTraceWriter> writer);
+
+            /**
+             * Returns the writer spans are added to
+             *
+             * @return The writer, or nullptr if tracing is disabled
+             *
+             * @see setTraceWriter(std::shared_ptr<ChromeTraceWriter>)
+             */
+            [[nodiscard]] std::shared_ptr<ChromeTraceWriter> getTraceWriter() const noexcept;
+
+            /**
+             * Returns whether this device is being traced, without locking the device
+             *
+             * @return Whether tracing is enabled
+             *
+             * @see setTraceWriter(std::shared_ptr<ChromeTraceWriter>)
+             */
+            [[nodiscard]] bool isTracing() const noexcept;
+
+            /**
+             * Adds a span to this device's track, labelled with its serial. Does nothing while
+             * tracing is disabled. AsyncBlink1Device uses this to trace the time commands spend
+             * queued, and applications can use it to put their own work on the same timeline.
+             *
+             * @param span The span to add. Its serial is replaced by this device's. Spans that can't be stored are dropped.
+             *
+             * @see setTraceWriter(std::shared_ptr<ChromeTraceWriter>)
+             */
+            void traceSpan(ChromeTraceWriter::Span span) const noexcept;
     };
 }
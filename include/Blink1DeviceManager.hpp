@@ -0,0 +1,141 @@
+/**
+ * @file Blink1DeviceManager.hpp
+ * @brief Header file for blink1_lib::Blink1DeviceManager
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Blink1Device.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Keeps track of every blink1 device connected to the system and hands out
+     * shared handles to them by serial number.
+     *
+     * The USB bus is enumerated once when the manager is created, and the result is
+     * kept in an index from serial number to device path, so looking up a device does
+     * not enumerate the bus again. The index is refreshed when refresh() is called, or
+     * when a serial number that isn't in the index is requested, since that is the
+     * only sign of a bus change that the blink1 library exposes.
+     *
+     * Devices are opened by path the first time they are requested and the open handle
+     * is cached, so every caller asking for the same serial shares one Blink1Device.
+     * A cached handle whose last command failed (see Blink1Device::isResponding()) is
+     * treated as stale: the next request for it enumerates the bus again and opens the
+     * device afresh. Nothing else notices an unplugged device, so callers that want
+     * removed devices dropped from the index without sending them a command must call
+     * refresh() themselves.
+     *
+     * All functions are safe to call from multiple threads.
+     */
+    class Blink1DeviceManager {
+        public:
+            /**
+             * Information about a connected device, as reported by enumeration
+             */
+            struct DeviceInfo {
+                /**
+                 * Serial number of the device
+                 */
+                std::string serial;
+
+                /**
+                 * Path to the device
+                 */
+                std::string path;
+
+                /**
+                 * Index of the device in the blink1 library's device cache
+                 */
+                std::uint32_t id{0};
+            };
+
+        private:
+            mutable std::mutex mutex;
+            std::unordered_map<std::string, DeviceInfo> devicesBySerial;
+            std::unordered_map<std::string, std::shared_ptr<Blink1Device>> openDevices;
+
+            void enumerate();
+            std::shared_ptr<Blink1Device> getOpen(const std::string& serial) const;
+            static bool isStale(const Blink1Device& device) noexcept;
+
+        public:
+            /**
+             * Enumerates the connected devices
+             */
+            Blink1DeviceManager();
+
+            Blink1DeviceManager(const Blink1DeviceManager& other) = delete;
+            Blink1DeviceManager& operator=(const Blink1DeviceManager& other) = delete;
+
+            /**
+             * Enumerates the connected devices again. Cached handles are kept for devices
+             * that are still connected and released for devices that are not.
+             *
+             * @return The number of connected devices
+             */
+            std::size_t refresh();
+
+            /**
+             * Returns the number of devices found by the last enumeration
+             *
+             * @return The number of connected devices
+             */
+            [[nodiscard]] std::size_t deviceCount() const;
+
+            /**
+             * Returns the serial numbers of the devices found by the last enumeration
+             *
+             * @return The serial number of every connected device
+             */
+            [[nodiscard]] std::vector<std::string> getSerials() const;
+
+            /**
+             * Looks up a device in the index, without enumerating or opening it
+             *
+             * @param serial The serial number of the device
+             *
+             * @return The device's information if it was found by the last enumeration, std::nullopt otherwise
+             */
+            [[nodiscard]] std::optional<DeviceInfo> find(const std::string& serial) const;
+
+            /**
+             * Returns a handle to the device with the given serial number, opening it if
+             * it isn't already open. If the serial number isn't in the index, the devices
+             * are enumerated again before giving up. If the last command sent through the
+             * cached handle failed, the handle is released, the devices are enumerated
+             * again and the device is opened again. Callers still holding the old handle
+             * keep it until they release it.
+             *
+             * @param serial The serial number of the device
+             *
+             * @return The device if it was found and opened, nullptr otherwise
+             */
+            std::shared_ptr<Blink1Device> get(const std::string& serial);
+
+            /**
+             * Opens every device found by the last enumeration that isn't already open,
+             * or whose cached handle is stale. The devices are opened in parallel.
+             *
+             * @return Handles to every device that is open, in the order of getSerials()
+             */
+            std::vector<std::shared_ptr<Blink1Device>> openAll();
+
+            /**
+             * Releases the cached handle for a device. The device is closed once every
+             * other holder of the handle releases it as well.
+             *
+             * @param serial The serial number of the device
+             */
+            void close(const std::string& serial);
+    };
+}
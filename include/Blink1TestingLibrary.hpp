@@ -5,50 +5,179 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
-#include <map>
 
+#include "Clock.hpp"
 #include "RGB.hpp"
 #include "PlayState.hpp"
 #include "PatternLineN.hpp"
 
 #include "blink1-lib.h"
 
-/// @cond
-typedef struct hid_device_ {} hid_device_;
-/// @endcond
-
 /**
  * @brief Testing library namespace.
  *
  * This library simulates blink(1) devices for use in testing. It keeps track of
- * each device opened by the application, but for simplicity each one maps to the
- * same simulated device. For example, setting LED 1 to red on device 1 and then
- * reading the color of LED 1 on device 2 will return red, despite device 2 not
- * having the color set.
+ * each device opened by the application, and each one is connected to a simulated
+ * device that holds the state of its LEDs, pattern and playback.
+ *
+ * There is always a default simulated device, which is the one opened by `blink1_open()`.
+ * More can be added with ADD_DEVICE(), and are opened by serial, path or ID. Until any
+ * are added, every way of opening a device connects to the default device, so several
+ * blink1_lib::Blink1Device objects share the same state. For example, setting LED 1 to
+ * red on device 1 and then reading the color of LED 1 on device 2 will return red,
+ * despite device 2 not having the color set.
+ *
+ * Functions that do not take a serial act on the default device. Their overloads that
+ * take a serial act on the added device with that serial.
+ *
+ * The simulated devices are safe to use from several threads at once. Each device has
+ * its own mutex, so calls to separate devices do not wait on each other. The functions
+ * in this namespace that configure the library as a whole, such as CLEAR_ALL() and
+ * ADD_DEVICE(), should only be called while no other thread is using the library.
  *
  * Additional functions provided in this namespace allow for controlling the
  * simulated device in ways that are not normally possible.
  */
 namespace fake_blink1_lib {
+    /**
+     * Defines how the simulated USB latency of each call is distributed
+     */
+    enum class LATENCY_DISTRIBUTION {
+        /** Every call takes exactly TimingModel::latency */
+        CONSTANT,
+        /** Calls take TimingModel::latency plus or minus up to TimingModel::jitter, uniformly distributed */
+        UNIFORM,
+        /** Calls take a normally distributed time with mean TimingModel::latency and standard deviation TimingModel::jitter */
+        NORMAL
+    };
+
+    /**
+     * Controls how long simulated calls take and how fades behave over time.
+     * The default model makes every call complete instantly, as if there were no timing model.
+     */
+    struct TimingModel {
+        /** Average time each call that talks to the device takes */
+        std::chrono::microseconds latency{0};
+
+        /** How much the time taken varies. See LATENCY_DISTRIBUTION. 0 or less makes every call take TimingModel::latency. */
+        std::chrono::microseconds jitter{0};
+
+        /** How the time taken by each call is distributed */
+        LATENCY_DISTRIBUTION distribution{LATENCY_DISTRIBUTION::CONSTANT};
+
+        /** The most commands that change the device that can be sent per second. 0 means no limit. */
+        double maxWritesPerSecond{0};
+
+        /**
+         * Whether fades take place over time. If set, reading the color of an LED with
+         * `blink1_readRGB()` during a fade returns a color between the start and end colors.
+         */
+        bool interpolateFades{false};
+
+        /** Seed for the random number generator used for jitter, so runs can be repeated */
+        std::uint32_t seed{0};
+    };
+
+    /**
+     * The simulated functions that faults can be injected into. These are the functions that
+     * communicate with the device.
+     */
+    enum class BLINK1_FUNCTION {
+        FADE_TO_RGB,
+        FADE_TO_RGBN,
+        SET_RGB,
+        READ_RGB,
+        PLAY,
+        PLAYLOOP,
+        READ_PLAY_STATE,
+        WRITE_PATTERN_LINE,
+        READ_PATTERN_LINE,
+        READ_PATTERN_LINE_N,
+        SAVE_PATTERN,
+        SET_LEDN
+    };
+
+    /**
+     * Controls which calls to the simulated devices fail, on top of SET_BLINK1_SUCCESSFUL_OPERATION().
+     * The default model injects no faults.
+     */
+    struct FaultModel {
+        /** Chance that each call fails, from 0 to 1 */
+        double failureProbability{0};
+
+        /**
+         * Number of calls that succeed before every call starts failing. 0 means calls never
+         * start failing. Calls are counted from when the model is set.
+         */
+        std::uint64_t failAfterCalls{0};
+
+        /** Functions that always fail */
+        std::unordered_set<BLINK1_FUNCTION> failingFunctions;
+
+        /** Seed for the random number generator used for FaultModel::failureProbability, so runs can be repeated */
+        std::uint32_t seed{0};
+    };
+
+    /// @cond
+    struct FadeStart {
+        blink1_lib::RGB from;
+        std::chrono::steady_clock::time_point time;
+    };
+    /// @endcond
+
+    /**
+     * The state of one simulated blink(1) device. The LED, pattern and play state are
+     * protected by SimulatedDevice::mutex. The serial and path are not expected to change
+     * while the device is in use.
+     */
+    struct SimulatedDevice {
+        /** Serializes calls to this device */
+        mutable std::mutex mutex;
+
+        /** Serial reported for the device */
+        std::string serial;
+
+        /** Path the device can be opened by */
+        std::string path;
+
+        /// @cond
+        // Indexed by LED number or pattern position. Empty entries have not been set yet.
+        std::array<std::optional<blink1_lib::RGB>, 256> ledColors;
+        std::array<std::optional<uint16_t>, 256> ledFadeMillis;
+        std::array<std::optional<blink1_lib::PatternLineN>, 256> patternLines;
+        uint8_t patternLineLEDN{0};
+        blink1_lib::PlayState playState;
+        std::array<std::optional<FadeStart>, 256> ledFadeStarts;
+        std::chrono::steady_clock::time_point nextWriteTime;
+        std::atomic<bool> connected{true};
+        std::atomic<std::uint64_t> connection{0};
+        /// @endcond
+    };
+
     /// @cond
-    extern std::vector<blink1_device*> blink1_devices;
-    extern std::map<long, blink1_lib::RGB> ledColors;
-    extern std::map<long, uint16_t> ledFadeMillis;
-    extern std::map<long, blink1_lib::PatternLineN> patternLines;
-    extern int cacheIndex;
-    extern std::string serial;
-    extern bool isMk2;
-    extern uint8_t patternLineLEDN;
-    extern blink1_lib::PlayState playState;
-    extern int blink1Version;
-    extern bool successfulOperation;
-    extern bool successfulInit;
-    extern bool degammaEnabled;
-    extern int vid;
-    extern int pid;
+    extern std::unordered_set<blink1_device*> blink1_devices;
+    extern std::shared_ptr<SimulatedDevice> defaultDevice;
+    extern std::vector<std::shared_ptr<SimulatedDevice>> simulatedDevices;
+    extern std::atomic<int> enumerateCount;
+    extern std::atomic<int> cacheIndex;
+    extern std::atomic<bool> isMk2;
+    extern std::atomic<int> blink1Version;
+    extern std::atomic<bool> successfulOperation;
+    extern std::atomic<bool> successfulInit;
+    extern std::atomic<bool> degammaEnabled;
+    extern std::atomic<int> vid;
+    extern std::atomic<int> pid;
     /// @endcond
 
     /**
@@ -116,6 +245,102 @@ namespace fake_blink1_lib {
      */
     void SET_IS_MK2(bool mk2);
 
+    /**
+     * Adds a simulated device with its own state that will be reported by `blink1_enumerate()`,
+     * which is used by blink1_lib::Blink1DeviceManager. The devices are given cache indexes
+     * and IDs in the order they are added.
+     *
+     * Once any devices are added, `blink1_openBySerial()`, `blink1_openByPath()` and
+     * `blink1_openById()` only open the matching added device, and fail if there isn't one.
+     */
+    void ADD_DEVICE(std::string serial, std::string path);
+
+    /**
+     * Unplugs the added device with the given serial. It is no longer reported by
+     * `blink1_enumerate()` and can't be opened, but handles to it that are already open
+     * keep working.
+     */
+    void REMOVE_DEVICE(const std::string& serial);
+
+    /**
+     * Simulates the default device being unplugged. Every call through a handle that is
+     * already open fails from then on, and the device can't be opened until RECONNECT()
+     * is called.
+     */
+    void DISCONNECT();
+
+    /**
+     * Simulates the added device with the given serial being unplugged. See DISCONNECT().
+     */
+    void DISCONNECT(const std::string& serial);
+
+    /**
+     * Simulates the default device being plugged back in. Handles that were open when it
+     * was disconnected keep failing, so it has to be opened again.
+     */
+    void RECONNECT();
+
+    /**
+     * Simulates the added device with the given serial being plugged back in. See RECONNECT().
+     */
+    void RECONNECT(const std::string& serial);
+
+    /**
+     * Returns the added device with the given serial, or nullptr if there isn't one.
+     */
+    std::shared_ptr<SimulatedDevice> GET_SIMULATED_DEVICE(const std::string& serial);
+
+    /**
+     * Returns the number of times `blink1_enumerate()` has been called.
+     */
+    int GET_ENUMERATE_COUNT();
+
+    /**
+     * Sets the timing model used by the simulated device. Calls made after this returns use
+     * the new model. CLEAR_ALL() restores the default model, in which every call is instant.
+     */
+    void SET_TIMING_MODEL(const TimingModel& model);
+
+    /**
+     * Returns the timing model used by the simulated device
+     */
+    TimingModel GET_TIMING_MODEL();
+
+    /**
+     * Sets the fault model used by the simulated devices and resets the counts returned by
+     * GET_CALL_COUNT() and GET_INJECTED_FAULT_COUNT(). CLEAR_ALL() restores the default
+     * model, which injects no faults.
+     */
+    void SET_FAULT_MODEL(const FaultModel& model);
+
+    /**
+     * Returns the fault model used by the simulated devices
+     */
+    FaultModel GET_FAULT_MODEL();
+
+    /**
+     * Returns the number of calls checked against the fault model since it was last set
+     */
+    std::uint64_t GET_CALL_COUNT();
+
+    /**
+     * Returns the number of calls the fault model has made fail since it was last set
+     */
+    std::uint64_t GET_INJECTED_FAULT_COUNT();
+
+    /**
+     * Sets the clock the simulated devices use for latency, write rate limits and fade
+     * interpolation. With a blink1_lib::VirtualClock, calls that the timing model says take
+     * time block until the clock is advanced. nullptr selects the default steady clock,
+     * which CLEAR_ALL() also restores.
+     */
+    void SET_CLOCK(std::shared_ptr<blink1_lib::Clock> clock);
+
+    /**
+     * Returns the clock the simulated devices use
+     */
+    std::shared_ptr<blink1_lib::Clock> GET_CLOCK();
+
     /**
      * For internal use.
      */
@@ -126,11 +351,32 @@ namespace fake_blink1_lib {
      */
     blink1_lib::RGB GET_RGB(long n);
 
+    /**
+     * Returns the color of simulated LED `n` on the device with the given serial.
+     */
+    blink1_lib::RGB GET_RGB(const std::string& serial, long n);
+
     /**
      * Sets the color of simulated LED `n` to `rgb`.
      */
     void SET_RGB(blink1_lib::RGB rgb, long n);
 
+    /**
+     * Sets the color of simulated LED `n` on the device with the given serial to `rgb`.
+     */
+    void SET_RGB(const std::string& serial, blink1_lib::RGB rgb, long n);
+
+    /**
+     * Returns the color simulated LED `n` is showing right now. This is the same as GET_RGB()
+     * unless TimingModel::interpolateFades is set and the LED is in the middle of a fade.
+     */
+    blink1_lib::RGB GET_DISPLAYED_RGB(long n);
+
+    /**
+     * Returns the color simulated LED `n` on the device with the given serial is showing right now.
+     */
+    blink1_lib::RGB GET_DISPLAYED_RGB(const std::string& serial, long n);
+
     /**
      * Gets the `fadeMillis` value that was used in the last call to either
      * blink1_lib::Blink1Device::fadeToRGB or blink1_lib::Blink1Device::fadeToRGBN
@@ -138,6 +384,11 @@ namespace fake_blink1_lib {
      */
     uint16_t GET_FADE_MILLIS(long n);
 
+    /**
+     * Gets the most recent `fadeMillis` value for LED `n` on the device with the given serial.
+     */
+    uint16_t GET_FADE_MILLIS(const std::string& serial, long n);
+
     /**
      * Sets the most recent `fadeMillis` value for LED `n`.
      */
@@ -148,6 +399,11 @@ namespace fake_blink1_lib {
      */
     blink1_lib::PatternLineN GET_PATTERN_LINE(long pos);
 
+    /**
+     * Reads the pattern line at position `pos` on the device with the given serial.
+     */
+    blink1_lib::PatternLineN GET_PATTERN_LINE(const std::string& serial, long pos);
+
     /**
      * Sets the pattern line at position `pos` to `line`.
      */
@@ -158,8 +414,20 @@ namespace fake_blink1_lib {
      */
     blink1_lib::PlayState GET_PLAY_STATE();
 
+    /**
+     * Gets the play state of the device with the given serial.
+     */
+    blink1_lib::PlayState GET_PLAY_STATE(const std::string& serial);
+
     /**
      * Sets the value that will be read by blink1_lib::Blink1Device::readPlayState().
      */
     void SET_PLAY_STATE(blink1_lib::PlayState state);
 }
+
+/// @cond
+struct hid_device_ {
+    std::shared_ptr<fake_blink1_lib::SimulatedDevice> simulated;
+    std::uint64_t connection;
+};
+/// @endcond
@@ -0,0 +1,161 @@
+/**
+ * @file ChromeTraceWriter.hpp
+ * @brief Header file for blink1_lib::ChromeTraceWriter
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Clock.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Collects timed spans and writes them as Chrome trace-event JSON, which can be
+     * opened in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+     *
+     * Pass one to Blink1Device::setTraceWriter(std::shared_ptr<ChromeTraceWriter>) to
+     * record a span for every command the device sends, and for the time commands spend
+     * queued in an AsyncBlink1Device. Each device gets its own track, named after its
+     * serial. Spans are timestamped with the device's clock, so every device traced into
+     * the same writer should use the same clock.
+     *
+     * Spans are kept in memory until the trace is written. Once the writer holds its
+     * capacity, further spans are dropped and counted by getDroppedCount().
+     *
+     * All member functions are thread safe.
+     */
+    class ChromeTraceWriter {
+        public:
+            /**
+             * Number of spans kept when no capacity is given to the constructor
+             */
+            static constexpr std::size_t DEFAULT_CAPACITY = 1000000;
+
+            /**
+             * A named interval of time on a device's track
+             */
+            struct Span {
+                /**
+                 * Name shown on the span
+                 */
+                std::string name;
+
+                /**
+                 * Category of the span, such as "usb" or "queue"
+                 */
+                std::string category;
+
+                /**
+                 * Serial of the device the span belongs to, which selects its track
+                 */
+                std::string serial;
+
+                /**
+                 * When the span started
+                 */
+                Clock::time_point start;
+
+                /**
+                 * When the span ended
+                 */
+                Clock::time_point end;
+
+                /**
+                 * The LED the command applied to, if it applied to one
+                 */
+                std::optional<std::uint8_t> ledn;
+
+                /**
+                 * The fade time of the command, if it had one
+                 */
+                std::optional<std::uint16_t> fadeMillis;
+
+                /**
+                 * Whether the command succeeded
+                 */
+                bool success{true};
+
+                /**
+                 * Set for spans that can overlap other spans on the same track, such as time
+                 * spent queued. These are written as async events, which Perfetto stacks
+                 * instead of nesting.
+                 */
+                bool async{false};
+            };
+
+        private:
+            const std::size_t maxSpans;
+
+            mutable std::mutex spansMutex;
+            std::vector<Span> spans;
+            std::uint64_t droppedSpans{0};
+
+        public:
+            /**
+             * @param capacity The most spans to keep
+             */
+            explicit ChromeTraceWriter(const std::size_t capacity = DEFAULT_CAPACITY);
+
+            ChromeTraceWriter(const ChromeTraceWriter& other) = delete;
+            ChromeTraceWriter& operator=(const ChromeTraceWriter& other) = delete;
+
+            /**
+             * Adds a span to the trace
+             *
+             * @param span The span to add
+             *
+             * @return true if the span was added, false if the writer is full and it was dropped
+             */
+            bool addSpan(Span span);
+
+            /**
+             * Returns a copy of the spans added so far, in the order they were added
+             *
+             * @return The spans
+             */
+            [[nodiscard]] std::vector<Span> getSpans() const;
+
+            /**
+             * Returns the number of spans held
+             *
+             * @return The number of spans
+             */
+            [[nodiscard]] std::size_t size() const;
+
+            /**
+             * Returns the number of spans dropped because the writer was full
+             *
+             * @return The number of dropped spans
+             */
+            [[nodiscard]] std::uint64_t getDroppedCount() const;
+
+            /**
+             * Removes every span and resets the dropped count
+             */
+            void clear();
+
+            /**
+             * Writes the trace as Chrome trace-event JSON
+             *
+             * @param os The stream to write to
+             */
+            void write(std::ostream& os) const;
+
+            /**
+             * Saves the trace to a file as Chrome trace-event JSON
+             *
+             * @param path The file to write to, which normally ends in `.json`
+             *
+             * @return true if the file was written, false otherwise
+             */
+            bool save(const std::string& path) const;
+    };
+}
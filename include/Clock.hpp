@@ -0,0 +1,158 @@
+/**
+ * @file Clock.hpp
+ * @brief Header file for blink1_lib::Clock, blink1_lib::SteadyClock and blink1_lib::VirtualClock
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+
+namespace blink1_lib {
+
+    /**
+     * A source of time that can also be slept on.
+     *
+     * Everything in the library that waits for time to pass, such as blocking fades and
+     * FadeTimer, goes through a Clock so that tests can substitute a VirtualClock and
+     * control time themselves.
+     */
+    class Clock {
+        public:
+            /**
+             * The type of a point in time. Clocks share std::chrono::steady_clock's
+             * representation so deadlines can be stored the same way whichever clock is used.
+             */
+            using time_point = std::chrono::steady_clock::time_point;
+
+            /**
+             * The type of a length of time
+             */
+            using duration = std::chrono::steady_clock::duration;
+
+            virtual ~Clock() = default;
+
+            /**
+             * Returns the current time
+             *
+             * @return The current time
+             */
+            [[nodiscard]] virtual time_point now() const noexcept = 0;
+
+            /**
+             * Blocks the calling thread until the deadline has passed
+             *
+             * @param deadline When to wake up
+             */
+            virtual void sleepUntil(const time_point deadline) noexcept = 0;
+
+            /**
+             * Blocks the calling thread until the given duration has passed
+             *
+             * @param sleepDuration How long to sleep for
+             */
+            void sleepFor(const duration sleepDuration) noexcept;
+
+            /**
+             * Waits on a condition variable until it is notified or the deadline has passed.
+             * As with std::condition_variable::wait_until(), the wait may also end spuriously,
+             * so callers should check their condition again afterwards.
+             *
+             * @param lock A lock on the mutex associated with the condition variable
+             * @param condition The condition variable to wait on
+             * @param deadline The latest time to wait until
+             */
+            virtual void waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& condition, const time_point deadline) = 0;
+
+            /**
+             * Returns the clock used by default, which is a shared SteadyClock
+             *
+             * @return The default clock
+             */
+            [[nodiscard]] static const std::shared_ptr<Clock>& steady() noexcept;
+    };
+
+    /**
+     * A Clock that follows std::chrono::steady_clock
+     */
+    class SteadyClock final : public Clock {
+        public:
+            [[nodiscard]] time_point now() const noexcept override;
+            void sleepUntil(const time_point deadline) noexcept override;
+            void waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& condition, const time_point deadline) override;
+    };
+
+    /**
+     * A Clock that only moves when told to.
+     *
+     * Threads that sleep on a VirtualClock stay asleep until another thread calls
+     * advance() or advanceTo() past their deadline, so tests of time-based behavior can
+     * run without waiting in real time.
+     */
+    class VirtualClock final : public Clock {
+        // A thread blocked in waitUntil()
+        struct Waiter {
+            std::condition_variable* condition;
+            std::mutex* mutex;
+            time_point deadline;
+            std::uint64_t notifiedGeneration;
+            std::size_t notifying{0};
+        };
+
+        mutable std::mutex mutex;
+        std::condition_variable timeChanged;
+        mutable std::condition_variable sleepersChanged;
+        std::condition_variable notified;
+        time_point currentTime;
+        std::uint64_t generation{0};
+        std::size_t sleepers{0};
+        std::unordered_set<Waiter*> waiters;
+
+        void notifyWaiters() noexcept;
+
+        public:
+            /**
+             * @param startTime The time the clock starts at
+             */
+            explicit VirtualClock(const time_point startTime = time_point{}) noexcept;
+
+            [[nodiscard]] time_point now() const noexcept override;
+            void sleepUntil(const time_point deadline) noexcept override;
+            void waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& condition, const time_point deadline) override;
+
+            /**
+             * Moves the clock forward and wakes any threads whose deadlines have passed
+             *
+             * @param amount How far to move the clock
+             */
+            void advance(const duration amount) noexcept;
+
+            /**
+             * Moves the clock to a given time and wakes any threads whose deadlines have
+             * passed. Times earlier than the current time are ignored.
+             *
+             * @param newTime The time to move the clock to
+             */
+            void advanceTo(const time_point newTime) noexcept;
+
+            /**
+             * Returns the number of threads currently blocked in sleepUntil() or sleepFor()
+             *
+             * @return The number of sleeping threads
+             */
+            [[nodiscard]] std::size_t sleeperCount() const noexcept;
+
+            /**
+             * Blocks until at least the given number of threads are sleeping on this clock.
+             * Useful for making sure another thread has started waiting before advancing.
+             *
+             * @param count The number of sleeping threads to wait for
+             */
+            void waitForSleepers(const std::size_t count) const noexcept;
+    };
+}
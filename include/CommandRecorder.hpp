@@ -0,0 +1,168 @@
+/**
+ * @file CommandRecorder.hpp
+ * @brief Header file for blink1_lib::CommandRecorder
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "Blink1Device.hpp"
+#include "Clock.hpp"
+#include "CommandTrace.hpp"
+#include "PatternLine.hpp"
+#include "PatternLineN.hpp"
+#include "RGB.hpp"
+#include "RGBN.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Sends commands to a Blink1Device and records each one in a CommandTrace.
+     *
+     * Each function forwards to the Blink1Device function of the same name and returns
+     * its result. The command is recorded with the time it was sent whether or not it
+     * succeeded, so that replaying the trace with TraceReplayer reproduces the load the
+     * device was under. Functions that only read from the device are not recorded.
+     *
+     * @note The Blink1Device must outlive this object
+     */
+    class CommandRecorder {
+        Blink1Device& device;
+        std::shared_ptr<Clock> clock;
+        Clock::time_point startTime;
+
+        mutable std::mutex traceMutex;
+        CommandTrace trace;
+
+        void record(CommandTrace::Entry entry);
+
+        public:
+            /**
+             * Starts recording. Entry times are measured from when this object is constructed.
+             *
+             * @param device The device to send commands to
+             * @param clock The clock used to timestamp commands
+             */
+            explicit CommandRecorder(Blink1Device& device, std::shared_ptr<Clock> clock = Clock::steady());
+
+            CommandRecorder(const CommandRecorder& other) = delete;
+            CommandRecorder& operator=(const CommandRecorder& other) = delete;
+
+            /**
+             * Records and calls Blink1Device::fadeToRGB(const std::uint16_t, const RGB&)
+             *
+             * @param fadeMillis The amount of time in milliseconds for the fade to last
+             * @param rgb RGB color to fade to
+             *
+             * @return The result of the call
+             */
+            bool fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb);
+
+            /**
+             * Records and calls Blink1Device::fadeToRGBN(const std::uint16_t, const RGBN&)
+             *
+             * @param fadeMillis The amount of time in milliseconds for the fade to last
+             * @param rgbn RGB color to fade to along with which LED on the device to fade to
+             *
+             * @return The result of the call
+             */
+            bool fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn);
+
+            /**
+             * Records and calls Blink1Device::setRGB(const RGB&)
+             *
+             * @param rgb The color to set
+             *
+             * @return The result of the call
+             */
+            bool setRGB(const RGB& rgb);
+
+            /**
+             * Records and calls Blink1Device::setRGBN(const RGBN&)
+             *
+             * @param rgbn The color to set along with which LED to set it on
+             *
+             * @return The result of the call
+             */
+            bool setRGBN(const RGBN& rgbn);
+
+            /**
+             * Records and calls Blink1Device::play(const std::uint8_t)
+             *
+             * @param pos Position to start playing from
+             *
+             * @return The result of the call
+             */
+            bool play(const std::uint8_t pos);
+
+            /**
+             * Records and calls Blink1Device::playLoop(const std::uint8_t, const std::uint8_t, const std::uint8_t)
+             *
+             * @param startpos Start position for the loop
+             * @param endpos End position for the loop
+             * @param count Number of times to repeat (0 to repeat forever)
+             *
+             * @return The result of the call
+             */
+            bool playLoop(const std::uint8_t startpos, const std::uint8_t endpos, const std::uint8_t count);
+
+            /**
+             * Records and calls Blink1Device::stop()
+             *
+             * @return The result of the call
+             */
+            bool stop();
+
+            /**
+             * Records and calls Blink1Device::writePatternLine(const PatternLine&, const std::uint8_t)
+             *
+             * @param line The line to write
+             * @param pos The position to write the line to
+             *
+             * @return The result of the call
+             */
+            bool writePatternLine(const PatternLine& line, const std::uint8_t pos);
+
+            /**
+             * Records and calls Blink1Device::writePatternLineN(const PatternLineN&, const std::uint8_t)
+             *
+             * @param line The line to write
+             * @param pos The position to write the line to
+             *
+             * @return The result of the call
+             */
+            bool writePatternLineN(const PatternLineN& line, const std::uint8_t pos);
+
+            /**
+             * Records and calls Blink1Device::savePattern()
+             *
+             * @return The result of the call
+             */
+            bool savePattern();
+
+            /**
+             * Returns the device commands are sent to
+             *
+             * @return The device
+             */
+            [[nodiscard]] Blink1Device& getDevice() const noexcept;
+
+            /**
+             * Returns a copy of everything recorded so far
+             *
+             * @return The recorded trace
+             */
+            [[nodiscard]] CommandTrace getTrace() const;
+
+            /**
+             * Returns everything recorded so far and starts a new, empty trace. Times in the
+             * new trace carry on from the old one.
+             *
+             * @return The recorded trace
+             */
+            CommandTrace takeTrace();
+    };
+}
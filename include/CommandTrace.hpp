@@ -0,0 +1,213 @@
+/**
+ * @file CommandTrace.hpp
+ * @brief Header file for blink1_lib::CommandTrace
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "RGBN.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * A timestamped list of commands sent to a device, as recorded by CommandRecorder
+     * and played back by TraceReplayer.
+     *
+     * Traces are saved in a compact binary format. The file starts with the magic bytes
+     * `B1TR`, a format version byte and the number of entries as a little-endian 32 bit
+     * integer. Each entry is then stored as the time since the previous entry in
+     * microseconds as an unsigned LEB128 varint, a command byte, and only the arguments
+     * that command uses.
+     */
+    class CommandTrace {
+        public:
+            /**
+             * The commands that can be recorded, each matching the Blink1Device function of the same name
+             */
+            enum class COMMAND : std::uint8_t {
+                FADE_TO_RGB,
+                FADE_TO_RGBN,
+                SET_RGB,
+                SET_RGBN,
+                PLAY,
+                PLAY_LOOP,
+                STOP,
+                WRITE_PATTERN_LINE,
+                WRITE_PATTERN_LINE_N,
+                SAVE_PATTERN
+            };
+
+            /**
+             * One recorded command. Arguments the command doesn't use are left at 0.
+             */
+            struct Entry {
+                /**
+                 * When the command was sent, relative to the start of the recording
+                 */
+                std::chrono::microseconds time{0};
+
+                /**
+                 * Which command was sent
+                 */
+                COMMAND command{COMMAND::STOP};
+
+                /**
+                 * Fade time for fades and pattern lines
+                 */
+                std::uint16_t fadeMillis{0};
+
+                /**
+                 * Color and LED for color commands and pattern lines
+                 */
+                RGBN rgbn;
+
+                /**
+                 * Play position, loop start position, or pattern position
+                 */
+                std::uint8_t pos{0};
+
+                /**
+                 * Loop end position
+                 */
+                std::uint8_t endPos{0};
+
+                /**
+                 * Loop count
+                 */
+                std::uint8_t count{0};
+
+                /**
+                 * Equality operator
+                 *
+                 * @param other Object to compare to
+                 * @return true if the objects are equal, false otherwise
+                 */
+                [[nodiscard]] bool operator==(const Entry& other) const noexcept;
+
+                /**
+                 * Inequality operator
+                 *
+                 * @param other Object to compare to
+                 * @return true if the objects are not equal, false otherwise
+                 */
+                [[nodiscard]] bool operator!=(const Entry& other) const noexcept;
+            };
+
+            /**
+             * Version of the binary format written by write(std::ostream&)
+             */
+            static constexpr std::uint8_t FORMAT_VERSION = 1;
+
+        private:
+            std::vector<Entry> entries;
+
+        public:
+            /**
+             * Default constructor. Creates an empty trace.
+             */
+            CommandTrace() noexcept = default;
+
+            /**
+             * @param entries The entries in the trace, in time order
+             */
+            explicit CommandTrace(std::vector<Entry> entries) noexcept;
+
+            /**
+             * Adds an entry to the end of the trace. Entries must be added in time order.
+             *
+             * @param entry The entry to add
+             */
+            void add(const Entry& entry);
+
+            /**
+             * Returns the entries in the trace
+             *
+             * @return The entries, in time order
+             */
+            [[nodiscard]] const std::vector<Entry>& getEntries() const noexcept;
+
+            /**
+             * Returns the number of entries in the trace
+             *
+             * @return The number of entries
+             */
+            [[nodiscard]] std::size_t size() const noexcept;
+
+            /**
+             * Returns whether the trace has no entries
+             *
+             * @return true if the trace is empty, false otherwise
+             */
+            [[nodiscard]] bool empty() const noexcept;
+
+            /**
+             * Returns the time of the last entry, which is how long the trace takes to replay at 1x speed
+             *
+             * @return The length of the trace
+             */
+            [[nodiscard]] std::chrono::microseconds duration() const noexcept;
+
+            /**
+             * Writes the trace in the binary format
+             *
+             * @param os The stream to write to, which should be opened in binary mode
+             *
+             * @return true if the trace was written, false otherwise. Nothing is written if
+             *         the entries are out of time order or hold an unknown command.
+             */
+            bool write(std::ostream& os) const;
+
+            /**
+             * Reads a trace written by write(std::ostream&)
+             *
+             * @param is The stream to read from, which should be opened in binary mode
+             *
+             * @return The trace, or std::nullopt if the stream doesn't hold a valid trace
+             */
+            [[nodiscard]] static std::optional<CommandTrace> read(std::istream& is);
+
+            /**
+             * Saves the trace to a file. The trace is written to `path + ".tmp"` and renamed
+             * into place, so the file is left as it was if the trace can't be written.
+             *
+             * @param path The file to write to
+             *
+             * @return true if the file was written, false otherwise
+             */
+            bool save(const std::string& path) const;
+
+            /**
+             * Loads a trace saved by save(const std::string&)
+             *
+             * @param path The file to read from
+             *
+             * @return The trace, or std::nullopt if the file can't be read or doesn't hold a valid trace
+             */
+            [[nodiscard]] static std::optional<CommandTrace> load(const std::string& path);
+
+            /**
+             * Equality operator
+             *
+             * @param other Object to compare to
+             * @return true if the objects are equal, false otherwise
+             */
+            [[nodiscard]] bool operator==(const CommandTrace& other) const noexcept;
+
+            /**
+             * Inequality operator
+             *
+             * @param other Object to compare to
+             * @return true if the objects are not equal, false otherwise
+             */
+            [[nodiscard]] bool operator!=(const CommandTrace& other) const noexcept;
+    };
+}
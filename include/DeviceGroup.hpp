@@ -0,0 +1,159 @@
+/**
+ * @file DeviceGroup.hpp
+ * @brief Header file for blink1_lib::DeviceGroup
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "Blink1Device.hpp"
+#include "PatternLineN.hpp"
+#include "RGB.hpp"
+#include "RGBN.hpp"
+#include "WorkerPool.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * A set of devices that can be sent the same command at the same time.
+     *
+     * Each collective operation sends its command to every member device concurrently
+     * using a WorkerPool and waits for all of them, so the time taken is close to that
+     * of the slowest device rather than the sum of all of them.
+     */
+    class DeviceGroup {
+        public:
+            /**
+             * The outcome of a collective operation
+             */
+            struct Result {
+                /**
+                 * Whether the operation succeeded on each device, in the same order as getDevices()
+                 */
+                std::vector<bool> succeeded;
+
+                /**
+                 * Returns whether the operation succeeded on every device
+                 *
+                 * @return true if every device succeeded, false otherwise
+                 */
+                [[nodiscard]] bool allSucceeded() const noexcept;
+
+                /**
+                 * Returns the number of devices the operation succeeded on
+                 *
+                 * @return The number of successful devices
+                 */
+                [[nodiscard]] std::size_t successCount() const noexcept;
+            };
+
+        private:
+            std::vector<std::shared_ptr<Blink1Device>> devices;
+            std::shared_ptr<WorkerPool> pool;
+
+            Result forEach(const std::function<bool(Blink1Device&)>& command);
+
+        public:
+            /**
+             * @param devices The devices in the group. Null entries always report failure.
+             * @param pool The pool to run commands on. If nullptr, the group creates its own pool
+             *             with one thread per device.
+             */
+            explicit DeviceGroup(std::vector<std::shared_ptr<Blink1Device>> devices, std::shared_ptr<WorkerPool> pool = nullptr);
+
+            /**
+             * Returns the devices in the group
+             *
+             * @return The member devices
+             */
+            [[nodiscard]] const std::vector<std::shared_ptr<Blink1Device>>& getDevices() const noexcept;
+
+            /**
+             * Returns the number of devices in the group
+             *
+             * @return The number of member devices
+             */
+            [[nodiscard]] std::size_t size() const noexcept;
+
+            /**
+             * Calls Blink1Device::fadeToRGB(const std::uint16_t, const RGB&) on every device
+             *
+             * @param fadeMillis The amount of time in milliseconds for the fade to last
+             * @param rgb RGB color to fade to
+             *
+             * @return The result on each device
+             */
+            Result fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb);
+
+            /**
+             * Calls Blink1Device::fadeToRGBN(const std::uint16_t, const RGBN&) on every device
+             *
+             * @param fadeMillis The amount of time in milliseconds for the fade to last
+             * @param rgbn RGB color to fade to along with which LED on the device to fade to
+             *
+             * @return The result on each device
+             */
+            Result fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn);
+
+            /**
+             * Calls Blink1Device::setRGB(const RGB&) on every device
+             *
+             * @param rgb The color to set
+             *
+             * @return The result on each device
+             */
+            Result setRGB(const RGB& rgb);
+
+            /**
+             * Calls Blink1Device::setRGBN(const RGBN&) on every device
+             *
+             * @param rgbn The color to set along with which LED to set it on
+             *
+             * @return The result on each device
+             */
+            Result setRGBN(const RGBN& rgbn);
+
+            /**
+             * Calls Blink1Device::play(const std::uint8_t) on every device
+             *
+             * @param pos Position to start playing from
+             *
+             * @return The result on each device
+             */
+            Result play(const std::uint8_t pos);
+
+            /**
+             * Calls Blink1Device::playLoop(const std::uint8_t, const std::uint8_t, const std::uint8_t) on every device
+             *
+             * @param startpos Start position for the loop
+             * @param endpos End position for the loop
+             * @param count Number of times to repeat (0 to repeat forever)
+             *
+             * @return The result on each device
+             */
+            Result playLoop(const std::uint8_t startpos, const std::uint8_t endpos, const std::uint8_t count);
+
+            /**
+             * Calls Blink1Device::stop() on every device
+             *
+             * @return The result on each device
+             */
+            Result stop();
+
+            /**
+             * Calls Blink1Device::writePattern(std::span<const PatternLineN>, const std::uint8_t) on every device
+             *
+             * @param lines The lines to write
+             * @param startPos The position to write the first line to
+             *
+             * @return The result on each device. A device succeeds if every line was written.
+             */
+            Result writePattern(std::span<const PatternLineN> lines, const std::uint8_t startPos);
+    };
+}
@@ -0,0 +1,154 @@
+/**
+ * @file DeviceMetrics.hpp
+ * @brief Header file for blink1_lib::DeviceMetrics
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "LatencyHistogram.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Call counts, failure counts and latencies of the commands sent to one device,
+     * kept separately for each type of operation.
+     *
+     * Blink1Device fills one of these in when metrics are enabled with
+     * Blink1Device::setMetricsEnabled(bool), and Blink1Device::getMetrics() returns a
+     * copy of it. Only calls that communicate with the device are counted, so writes
+     * skipped by the shadow cache and saves skipped because nothing changed are not.
+     *
+     * @note This class is not thread safe
+     */
+    class DeviceMetrics {
+        public:
+            /**
+             * The operations that are measured, each matching the blink1 C library call it times
+             */
+            enum class OPERATION : std::uint8_t {
+                /** blink1_getVersion, sent by Blink1Device::getVersion() */
+                GET_VERSION,
+                /** blink1_fadeToRGB, sent by Blink1Device::fadeToRGB() */
+                FADE_TO_RGB,
+                /** blink1_fadeToRGBN, sent by Blink1Device::fadeToRGBN() and Blink1Device::setRGBN() */
+                FADE_TO_RGBN,
+                /** blink1_setRGB, sent by Blink1Device::setRGB() */
+                SET_RGB,
+                /** blink1_readRGB, sent by Blink1Device::readRGBWithFade() and Blink1Device::readRGB() */
+                READ_RGB_WITH_FADE,
+                /** blink1_play, sent by Blink1Device::play() */
+                PLAY,
+                /** blink1_playloop, sent by Blink1Device::playLoop() */
+                PLAY_LOOP,
+                /** blink1_play, sent by Blink1Device::stop() */
+                STOP,
+                /** blink1_readPlayState, sent by Blink1Device::readPlayState() */
+                READ_PLAY_STATE,
+                /** blink1_writePatternLine, sent by Blink1Device::writePatternLine() */
+                WRITE_PATTERN_LINE,
+                /** blink1_setLEDN and blink1_writePatternLine, sent by Blink1Device::writePatternLineN(), writePattern() and syncPattern() */
+                WRITE_PATTERN_LINE_N,
+                /** blink1_readPatternLine, sent by Blink1Device::readPatternLine() */
+                READ_PATTERN_LINE,
+                /** blink1_readPatternLineN, sent by Blink1Device::readPatternLineN() and Blink1Device::readPattern() */
+                READ_PATTERN_LINE_N,
+                /** blink1_savePattern, sent by Blink1Device::savePattern() and Blink1Device::savePatternIfChanged() */
+                SAVE_PATTERN
+            };
+
+            /**
+             * Number of values in DeviceMetrics::OPERATION
+             */
+            static constexpr std::size_t OPERATION_COUNT = static_cast<std::size_t>(OPERATION::SAVE_PATTERN) + 1;
+
+            /**
+             * What was measured for one operation
+             */
+            struct OperationMetrics {
+                /**
+                 * Number of times the operation was sent to the device
+                 */
+                std::uint64_t calls{0};
+
+                /**
+                 * Number of those calls that failed
+                 */
+                std::uint64_t failures{0};
+
+                /**
+                 * How long each call took, successful or not
+                 */
+                LatencyHistogram latency;
+            };
+
+        private:
+            std::array<OperationMetrics, OPERATION_COUNT> operations;
+
+        public:
+            /**
+             * Default constructor. Creates metrics with nothing recorded.
+             */
+            DeviceMetrics() noexcept = default;
+
+            /**
+             * Records one call
+             *
+             * @param operation The operation that was called
+             * @param success Whether the call succeeded
+             * @param latency How long the call took
+             */
+            void record(const OPERATION operation, const bool success, const std::chrono::nanoseconds latency) noexcept;
+
+            /**
+             * Adds everything recorded in another DeviceMetrics to this one, for example to
+             * combine the metrics of several devices
+             *
+             * @param other The metrics to add
+             */
+            void merge(const DeviceMetrics& other) noexcept;
+
+            /**
+             * Removes everything recorded
+             */
+            void reset() noexcept;
+
+            /**
+             * Returns what was recorded for one operation
+             *
+             * @param operation The operation to look up
+             *
+             * @return The operation's metrics
+             */
+            [[nodiscard]] const OperationMetrics& get(const OPERATION operation) const noexcept;
+
+            /**
+             * Returns the total number of calls recorded across every operation
+             *
+             * @return The number of calls
+             */
+            [[nodiscard]] std::uint64_t totalCalls() const noexcept;
+
+            /**
+             * Returns the total number of failed calls recorded across every operation
+             *
+             * @return The number of failures
+             */
+            [[nodiscard]] std::uint64_t totalFailures() const noexcept;
+
+            /**
+             * Returns the name of an operation in snake case, for example "fade_to_rgb",
+             * for use in logs and metric labels
+             *
+             * @param operation The operation to name
+             *
+             * @return The operation's name
+             */
+            [[nodiscard]] static std::string_view getOperationName(const OPERATION operation) noexcept;
+    };
+}
@@ -14,6 +14,8 @@
  *
  * Main class: blink1_lib::Blink1Device
  *
+ * To send commands without waiting on USB transfers, see blink1_lib::AsyncBlink1Device
+ *
  * Also of note is the testing library: fake_blink1_lib
  */
 
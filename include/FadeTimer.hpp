@@ -0,0 +1,84 @@
+/**
+ * @file FadeTimer.hpp
+ * @brief Header file for blink1_lib::FadeTimer
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "Clock.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Runs callbacks at given points in time from a single thread.
+     *
+     * This is used to notify callers when fades finish without needing a sleeping
+     * thread for each fade. Callbacks are run in deadline order on the timer's thread,
+     * so they should be short and must not throw.
+     */
+    class FadeTimer {
+        std::shared_ptr<Clock> clock;
+        mutable std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> callbacks;
+        bool stopping{false};
+        std::thread timerThread;
+
+        void run();
+
+        public:
+            /**
+             * Starts the timer thread
+             *
+             * @param clock The clock that deadlines are measured against
+             */
+            explicit FadeTimer(std::shared_ptr<Clock> clock = Clock::steady());
+
+            FadeTimer(const FadeTimer& other) = delete;
+            FadeTimer& operator=(const FadeTimer& other) = delete;
+
+            /**
+             * Destructor. Stops the timer thread. Callbacks that have not run yet are discarded.
+             */
+            ~FadeTimer();
+
+            /**
+             * Schedules a callback to be run once the deadline has passed. Callbacks with
+             * deadlines that have already passed are run as soon as possible.
+             *
+             * @param deadline When to run the callback
+             * @param callback The callback to run
+             */
+            void schedule(const std::chrono::steady_clock::time_point deadline, std::function<void()> callback);
+
+            /**
+             * Returns the number of callbacks that have not run yet
+             *
+             * @return The number of pending callbacks
+             */
+            [[nodiscard]] std::size_t pendingCount() const noexcept;
+
+            /**
+             * Returns the clock that deadlines are measured against
+             *
+             * @return The timer's clock
+             */
+            [[nodiscard]] const std::shared_ptr<Clock>& getClock() const noexcept;
+
+            /**
+             * Returns the timer shared by all Blink1Device objects that use the default clock
+             *
+             * @return The shared timer
+             */
+            [[nodiscard]] static FadeTimer& shared();
+    };
+}
@@ -0,0 +1,146 @@
+/**
+ * @file LatencyHistogram.hpp
+ * @brief Header file for blink1_lib::LatencyHistogram
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace blink1_lib {
+
+    /**
+     * A fixed size histogram of durations, in the style of an HDR histogram.
+     *
+     * Durations are recorded in nanoseconds. Values below 32ns each get their own bucket,
+     * and every power of two above that is split into 16 equal buckets, so any recorded
+     * value can be read back to within about 6% of its true value. Values of 2^36ns
+     * (about 68 seconds) or more are counted in the last bucket. Recording never
+     * allocates, and the memory used is the same no matter how many values are recorded.
+     *
+     * @note This class is not thread safe
+     */
+    class LatencyHistogram {
+        public:
+            /**
+             * Number of buckets in the histogram
+             */
+            static constexpr std::size_t BUCKET_COUNT = 528;
+
+        private:
+            std::array<std::uint64_t, BUCKET_COUNT> buckets{};
+            std::uint64_t totalCount{0};
+            std::uint64_t minValue{UINT64_MAX};
+            std::uint64_t maxValue{0};
+            std::uint64_t total{0};
+
+            [[nodiscard]] static std::size_t bucketFor(const std::uint64_t value) noexcept;
+
+        public:
+            /**
+             * Default constructor. Creates an empty histogram.
+             */
+            LatencyHistogram() noexcept = default;
+
+            /**
+             * Records one duration. Negative durations are recorded as 0.
+             *
+             * @param latency The duration to record
+             */
+            void record(const std::chrono::nanoseconds latency) noexcept;
+
+            /**
+             * Adds every value recorded in another histogram to this one
+             *
+             * @param other The histogram to add
+             */
+            void merge(const LatencyHistogram& other) noexcept;
+
+            /**
+             * Removes every recorded value
+             */
+            void reset() noexcept;
+
+            /**
+             * Returns the number of values recorded
+             *
+             * @return The number of values
+             */
+            [[nodiscard]] std::uint64_t count() const noexcept;
+
+            /**
+             * Returns the sum of every value recorded
+             *
+             * @return The sum, or 0 if the histogram is empty
+             */
+            [[nodiscard]] std::chrono::nanoseconds sum() const noexcept;
+
+            /**
+             * Returns the smallest value recorded
+             *
+             * @return The smallest value, or 0 if the histogram is empty
+             */
+            [[nodiscard]] std::chrono::nanoseconds min() const noexcept;
+
+            /**
+             * Returns the largest value recorded
+             *
+             * @return The largest value, or 0 if the histogram is empty
+             */
+            [[nodiscard]] std::chrono::nanoseconds max() const noexcept;
+
+            /**
+             * Returns the mean of the values recorded
+             *
+             * @return The mean, or 0 if the histogram is empty
+             */
+            [[nodiscard]] std::chrono::nanoseconds mean() const noexcept;
+
+            /**
+             * Returns the value that the given percentage of recorded values are less than or
+             * equal to. The result is the upper end of the bucket the value falls in, capped
+             * at max(), so it is never less than the true value.
+             *
+             * @param percentile The percentile to look up, from 0 to 100. For example, 99 gives the p99 latency.
+             *
+             * @return The value at that percentile, or 0 if the histogram is empty
+             */
+            [[nodiscard]] std::chrono::nanoseconds percentile(const double percentile) const noexcept;
+
+            /**
+             * Returns the number of values recorded in each bucket
+             *
+             * @return The bucket counts
+             * @see getBucketUpperBound(const std::size_t)
+             */
+            [[nodiscard]] const std::array<std::uint64_t, BUCKET_COUNT>& getBuckets() const noexcept;
+
+            /**
+             * Returns the largest value that is recorded in a bucket
+             *
+             * @param bucket The index of the bucket
+             *
+             * @return The largest value the bucket holds. The last bucket returns std::chrono::nanoseconds::max().
+             */
+            [[nodiscard]] static std::chrono::nanoseconds getBucketUpperBound(const std::size_t bucket) noexcept;
+
+            /**
+             * Equality operator
+             *
+             * @param other Object to compare to
+             * @return true if the objects are equal, false otherwise
+             */
+            [[nodiscard]] bool operator==(const LatencyHistogram& other) const noexcept;
+
+            /**
+             * Inequality operator
+             *
+             * @param other Object to compare to
+             * @return true if the objects are not equal, false otherwise
+             */
+            [[nodiscard]] bool operator!=(const LatencyHistogram& other) const noexcept;
+    };
+}
@@ -0,0 +1,187 @@
+/**
+ * @file PatternCompiler.hpp
+ * @brief Header file for blink1_lib::PatternCompiler
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Animation.hpp"
+#include "Blink1Device.hpp"
+#include "PatternLineN.hpp"
+#include "PatternSimplifier.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Turns an Animation into a pattern the device can play on its own, so it doesn't
+     * have to be streamed over USB by AnimationEngine.
+     *
+     * The device plays pattern lines one after another, waiting for each line's fade to
+     * finish before starting the next one. Tracks for different LEDs are merged into one
+     * sequence of lines ordered by when each keyframe starts fading, and each line's fade
+     * is cut short where needed so that the next line starts on time. That makes the LED
+     * reach the line's color early, which is counted as timing error. Keyframes on
+     * different LEDs that fade at the same time therefore can't be compiled exactly.
+     *
+     * Keyframes are then removed, one at a time and cheapest first, for as long as the
+     * colors the animation passes through stay within the color tolerance and the timing
+     * stays within the time tolerance. Color error is measured exactly as PatternSimplifier
+     * measures it, with PatternSimplifier::fadeError(), so the same tolerance and color
+     * space mean the same thing to both. The first and last keyframe of each track are
+     * always kept. If the lines that are left repeat, they are folded into a loop with
+     * PatternFolder. Compiling fails if the result still doesn't fit into the device's
+     * pattern table.
+     *
+     * @note The first keyframe of each track fades from whatever color the LED is showing
+     *       when the pattern starts, exactly as it does with AnimationEngine.
+     */
+    class PatternCompiler {
+        public:
+            /**
+             * Number of pattern lines on a blink(1) mk2 or mk3
+             */
+            static constexpr std::size_t DEFAULT_CAPACITY = 32;
+
+            /**
+             * A compiled pattern and how to play it
+             */
+            struct Program {
+                /**
+                 * The lines to write to the device
+                 */
+                std::vector<PatternLineN> lines;
+
+                /**
+                 * Position of the first line
+                 */
+                std::uint8_t startPos{0};
+
+                /**
+                 * Position of the last line
+                 */
+                std::uint8_t endPos{0};
+
+                /**
+                 * Number of times to play the lines, 0 to repeat forever
+                 */
+                std::uint8_t count{1};
+
+                /**
+                 * The largest distance between the animation and the compiled pattern at any of
+                 * the animation's keyframes, measured in the compiler's color space
+                 */
+                double colorError{0};
+
+                /**
+                 * The largest difference between when the animation reaches a keyframe and
+                 * when the compiled pattern does
+                 */
+                std::chrono::milliseconds timeError{0};
+            };
+
+        private:
+            std::size_t capacity;
+            double colorTolerance;
+            std::chrono::milliseconds timeTolerance;
+            PatternSimplifier::COLOR_SPACE colorSpace;
+
+        public:
+            /**
+             * @param capacity Number of lines in the device's pattern table
+             * @param colorTolerance Largest color distance allowed
+             * @param timeTolerance Largest timing difference allowed
+             * @param colorSpace The space colorTolerance is measured in
+             */
+            explicit PatternCompiler(const std::size_t capacity = DEFAULT_CAPACITY,
+                                     const double colorTolerance = 0,
+                                     const std::chrono::milliseconds timeTolerance = std::chrono::milliseconds(0),
+                                     const PatternSimplifier::COLOR_SPACE colorSpace = PatternSimplifier::COLOR_SPACE::RGB) noexcept;
+
+            /**
+             * Compiles an animation. Looping animations are played forever and must have
+             * tracks that all take the same time; other animations are played once.
+             *
+             * @param animation The animation to compile
+             * @param startPos The position the pattern will be written to
+             *
+             * @return The compiled pattern, or std::nullopt if the animation is empty, its
+             *         tracks loop with different lengths, or it can't be made to fit within
+             *         the tolerances
+             */
+            [[nodiscard]] std::optional<Program> compile(const Animation& animation, const std::uint8_t startPos = 0) const;
+
+            /**
+             * Writes a compiled pattern to a device and starts playing it. Lines that the
+             * device already holds are not written again.
+             *
+             * @param device The device to program
+             * @param program The compiled pattern
+             * @see Blink1Device::syncPattern(std::span<const PatternLineN>, const std::uint8_t)
+             *
+             * @return true if the pattern was written and started, false otherwise
+             */
+            static bool upload(Blink1Device& device, const Program& program) noexcept;
+
+            /**
+             * Sets the number of lines in the device's pattern table
+             *
+             * @param capacity The number of lines
+             */
+            void setCapacity(const std::size_t capacity) noexcept;
+
+            /**
+             * Returns the number of lines in the device's pattern table
+             *
+             * @return The number of lines
+             */
+            [[nodiscard]] std::size_t getCapacity() const noexcept;
+
+            /**
+             * Sets the largest color distance allowed
+             *
+             * @param colorTolerance The tolerance
+             */
+            void setColorTolerance(const double colorTolerance) noexcept;
+
+            /**
+             * Returns the largest color distance allowed
+             *
+             * @return The tolerance
+             */
+            [[nodiscard]] double getColorTolerance() const noexcept;
+
+            /**
+             * Sets the space the color tolerance is measured in
+             *
+             * @param colorSpace The color space
+             */
+            void setColorSpace(const PatternSimplifier::COLOR_SPACE colorSpace) noexcept;
+
+            /**
+             * Returns the space the color tolerance is measured in
+             *
+             * @return The color space
+             */
+            [[nodiscard]] PatternSimplifier::COLOR_SPACE getColorSpace() const noexcept;
+
+            /**
+             * Sets the largest timing difference allowed
+             *
+             * @param timeTolerance The tolerance
+             */
+            void setTimeTolerance(const std::chrono::milliseconds timeTolerance) noexcept;
+
+            /**
+             * Returns the largest timing difference allowed
+             *
+             * @return The tolerance
+             */
+            [[nodiscard]] std::chrono::milliseconds getTimeTolerance() const noexcept;
+    };
+}
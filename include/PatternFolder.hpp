@@ -0,0 +1,92 @@
+/**
+ * @file PatternFolder.hpp
+ * @brief Header file for blink1_lib::PatternFolder
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Blink1Device.hpp"
+#include "PatternLineN.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Shortens patterns that repeat by writing one repetition and letting playLoop() repeat it.
+     *
+     * A pattern is folded when it is made of the same block of lines repeated back to back.
+     * The shortest such block is written to the pattern table, and the loop count is
+     * multiplied by the number of repetitions. A pattern that doesn't repeat is left as it is.
+     *
+     * @note The device only plays one loop at a time, so a pattern that repeats only part of
+     *       the way through can't be folded.
+     */
+    class PatternFolder {
+        public:
+            /**
+             * A pattern table and how to play it
+             */
+            struct FoldedPattern {
+                /**
+                 * The lines to write to the device
+                 */
+                std::vector<PatternLineN> lines;
+
+                /**
+                 * Position of the first line
+                 */
+                std::uint8_t startPos{0};
+
+                /**
+                 * Position of the last line
+                 */
+                std::uint8_t endPos{0};
+
+                /**
+                 * Number of times to play the lines, 0 to repeat forever
+                 */
+                std::uint8_t count{1};
+            };
+
+            PatternFolder() = delete;
+
+            /**
+             * Returns the length of the shortest block of lines that the pattern is made of
+             *
+             * @param lines The pattern
+             *
+             * @return The length of the block, which is the length of the pattern if it doesn't repeat
+             */
+            [[nodiscard]] static std::size_t period(std::span<const PatternLineN> lines);
+
+            /**
+             * Folds a pattern. If the number of repetitions multiplied by count doesn't fit in a
+             * loop count, as few repetitions as needed are left in the table.
+             *
+             * @param lines The pattern
+             * @param count Number of times the pattern is played, 0 to repeat forever
+             * @param startPos The position the pattern will be written to
+             *
+             * @return The folded pattern, or std::nullopt if the pattern is empty or doesn't fit
+             *         in the pattern table
+             */
+            [[nodiscard]] static std::optional<FoldedPattern> fold(std::span<const PatternLineN> lines, const std::uint8_t count = 1, const std::uint8_t startPos = 0);
+
+            /**
+             * Writes a folded pattern to a device and starts playing it. Lines that the device
+             * already holds are not written again.
+             *
+             * @param device The device to program
+             * @param pattern The folded pattern
+             * @see Blink1Device::syncPattern(std::span<const PatternLineN>, const std::uint8_t)
+             *
+             * @return true if the pattern was written and started, false otherwise
+             */
+            static bool upload(Blink1Device& device, const FoldedPattern& pattern) noexcept;
+    };
+}
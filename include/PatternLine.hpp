@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <compare>
 #include <cstdint>
+#include <type_traits>
 
 #include "RGB.hpp"
 
@@ -31,13 +33,13 @@ namespace blink1_lib {
          *
          * Initializes all values to 0
          */
-        PatternLine() noexcept = default;
+        constexpr PatternLine() noexcept = default;
 
         /**
          * @param _rgb RGB value for this PatternLine
          * @param _fadeMillis Fade time in milliseconds
          */
-        PatternLine(const RGB& _rgb, const std::uint16_t _fadeMillis) noexcept;
+        constexpr PatternLine(const RGB& _rgb, const std::uint16_t _fadeMillis) noexcept : fadeMillis(_fadeMillis), rgb(_rgb) {}
 
         /**
          * @param _r Red value for RGB
@@ -45,7 +47,8 @@ namespace blink1_lib {
          * @param _b Blue value for RGB
          * @param _fadeMillis Fade time in milliseconds
          */
-        PatternLine(const std::uint8_t _r, const std::uint8_t _g, const std::uint8_t _b, const std::uint16_t _fadeMillis) noexcept;
+        constexpr PatternLine(const std::uint8_t _r, const std::uint8_t _g, const std::uint8_t _b, const std::uint16_t _fadeMillis) noexcept
+            : fadeMillis(_fadeMillis), rgb(_r, _g, _b) {}
 
         /**
          * Equality operator
@@ -53,15 +56,15 @@ namespace blink1_lib {
          * @param other Object to compare to
          * @return true if the objects are equal, false otherwise
          */
-        [[nodiscard]] bool operator==(const PatternLine& other) const noexcept;
+        [[nodiscard]] constexpr bool operator==(const PatternLine& other) const noexcept = default;
 
         /**
-         * Inequality operator
+         * Three-way comparison operator. Compares fadeMillis, then rgb.
          *
          * @param other Object to compare to
-         * @return true if the objects are not equal, false otherwise
+         * @return How this object is ordered relative to other
          */
-        [[nodiscard]] bool operator!=(const PatternLine& other) const noexcept;
+        [[nodiscard]] constexpr std::strong_ordering operator<=>(const PatternLine& other) const noexcept = default;
 
         /**
          * Output operator
@@ -71,4 +74,7 @@ namespace blink1_lib {
          */
         friend std::ostream& operator<<(std::ostream& os, const PatternLine& patternLine);
     };
+
+    static_assert(std::is_trivially_copyable_v<PatternLine> && std::is_standard_layout_v<PatternLine>);
+    static_assert(sizeof(PatternLine) == 6, "PatternLine should only be padded to align fadeMillis");
 }
@@ -5,7 +5,9 @@
 
 #pragma once
 
+#include <compare>
 #include <cstdint>
+#include <type_traits>
 
 #include "RGBN.hpp"
 
@@ -30,13 +32,13 @@ namespace blink1_lib {
          *
          * Initializes all values to 0
          */
-        PatternLineN() noexcept = default;
+        constexpr PatternLineN() noexcept = default;
 
         /**
          * @param _rgbn RGBN value
          * @param _fadeMillis Fade time in milliseconds
          */
-        PatternLineN(const RGBN& _rgbn, const std::uint16_t _fadeMillis) noexcept;
+        constexpr PatternLineN(const RGBN& _rgbn, const std::uint16_t _fadeMillis) noexcept : fadeMillis(_fadeMillis), rgbn(_rgbn) {}
 
         /**
          * @param _r Red value
@@ -45,7 +47,8 @@ namespace blink1_lib {
          * @param _n LED index
          * @param _fadeMillis Fade time in milliseconds
          */
-        PatternLineN(const std::uint8_t _r, const std::uint8_t _g, const std::uint8_t _b, const std::uint8_t _n, const std::uint16_t _fadeMillis) noexcept;
+        constexpr PatternLineN(const std::uint8_t _r, const std::uint8_t _g, const std::uint8_t _b, const std::uint8_t _n, const std::uint16_t _fadeMillis) noexcept
+            : fadeMillis(_fadeMillis), rgbn(_r, _g, _b, _n) {}
 
         /**
          * Equality operator
@@ -53,15 +56,15 @@ namespace blink1_lib {
          * @param other Object to compare to
          * @return true if the objects are equal, false otherwise
          */
-        [[nodiscard]] bool operator==(const PatternLineN& other) const noexcept;
+        [[nodiscard]] constexpr bool operator==(const PatternLineN& other) const noexcept = default;
 
         /**
-         * Inequality operator
+         * Three-way comparison operator. Compares fadeMillis, then rgbn.
          *
          * @param other Object to compare to
-         * @return true if the objects are not equal, false otherwise
+         * @return How this object is ordered relative to other
          */
-        [[nodiscard]] bool operator!=(const PatternLineN& other) const noexcept;
+        [[nodiscard]] constexpr std::strong_ordering operator<=>(const PatternLineN& other) const noexcept = default;
 
         /**
          * Output operator
@@ -71,4 +74,7 @@ namespace blink1_lib {
          */
         friend std::ostream& operator<<(std::ostream& os, const PatternLineN& patternLine);
     };
+
+    static_assert(std::is_trivially_copyable_v<PatternLineN> && std::is_standard_layout_v<PatternLineN>);
+    static_assert(sizeof(PatternLineN) == 6, "PatternLineN should only be padded to align fadeMillis");
 }
@@ -0,0 +1,127 @@
+/**
+ * @file PatternSimplifier.hpp
+ * @brief Header file for blink1_lib::PatternSimplifier
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "PatternLine.hpp"
+#include "PatternLineN.hpp"
+#include "RGB.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Shortens patterns by merging lines whose fades can be replaced by one longer fade.
+     *
+     * A pattern traces a path through color space over time, with a straight fade between
+     * each line and the next. Lines are removed with the Ramer-Douglas-Peucker algorithm:
+     * the first and last lines are joined by a single fade, the line furthest from that
+     * fade is kept if it is further than the tolerance, and the same is repeated on both
+     * halves. Distances are measured between colors at the same point in time, so the
+     * pattern takes exactly as long to play after simplifying as before.
+     *
+     * For PatternLineN, each run of consecutive lines on the same LED is simplified on its
+     * own, so lines on other LEDs keep their place in the pattern. The first line of each
+     * run is always kept, since it fades from whatever color the LED was showing before.
+     */
+    class PatternSimplifier {
+        public:
+            /**
+             * The space distances between colors are measured in
+             */
+            enum class COLOR_SPACE {
+                RGB,   ///< Straight-line distance between RGB values
+                CIELAB ///< CIE76 color difference, which follows how different colors look
+            };
+
+        private:
+            double tolerance;
+            COLOR_SPACE colorSpace;
+
+            [[nodiscard]] std::vector<bool> keptLines(std::span<const RGB> colors, std::span<const std::uint16_t> fades) const;
+
+        public:
+            /**
+             * @param tolerance How far from the original a merged fade is allowed to stray
+             * @param colorSpace The space tolerance is measured in
+             */
+            explicit PatternSimplifier(const double tolerance = 0, const COLOR_SPACE colorSpace = COLOR_SPACE::RGB) noexcept;
+
+            /**
+             * Simplifies a pattern
+             *
+             * @param lines The pattern to simplify
+             *
+             * @return The simplified pattern
+             */
+            [[nodiscard]] std::vector<PatternLine> simplify(std::span<const PatternLine> lines) const;
+
+            /**
+             * Simplifies a pattern that sets individual LEDs
+             *
+             * @param lines The pattern to simplify
+             *
+             * @return The simplified pattern
+             */
+            [[nodiscard]] std::vector<PatternLineN> simplify(std::span<const PatternLineN> lines) const;
+
+            /**
+             * Returns the distance between two colors
+             *
+             * @param a The first color
+             * @param b The second color
+             * @param colorSpace The space to measure the distance in
+             *
+             * @return The distance
+             */
+            [[nodiscard]] static double distance(const RGB& a, const RGB& b, const COLOR_SPACE colorSpace) noexcept;
+
+            /**
+             * Returns how far a color is from a fade between two other colors, at some point
+             * during the fade. This is what the tolerance is compared against, and
+             * PatternCompiler measures its color tolerance the same way.
+             *
+             * @param color The color
+             * @param from The color the fade starts at
+             * @param to The color the fade ends at
+             * @param fraction How far through the fade to measure, from 0 to 1
+             * @param colorSpace The space to measure the distance in
+             *
+             * @return The distance between the color and the fade
+             */
+            [[nodiscard]] static double fadeError(const RGB& color, const RGB& from, const RGB& to, const double fraction, const COLOR_SPACE colorSpace) noexcept;
+
+            /**
+             * Sets how far from the original a merged fade is allowed to stray
+             *
+             * @param tolerance The tolerance
+             */
+            void setTolerance(const double tolerance) noexcept;
+
+            /**
+             * Returns how far from the original a merged fade is allowed to stray
+             *
+             * @return The tolerance
+             */
+            [[nodiscard]] double getTolerance() const noexcept;
+
+            /**
+             * Sets the space the tolerance is measured in
+             *
+             * @param colorSpace The color space
+             */
+            void setColorSpace(const COLOR_SPACE colorSpace) noexcept;
+
+            /**
+             * Returns the space the tolerance is measured in
+             *
+             * @return The color space
+             */
+            [[nodiscard]] COLOR_SPACE getColorSpace() const noexcept;
+    };
+}
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <compare>
 #include <cstdint>
 #include <ostream>
+#include <type_traits>
 
 namespace blink1_lib {
 
@@ -44,7 +46,7 @@ namespace blink1_lib {
          *
          * Initializes all values to 0
          */
-        PlayState() noexcept = default;
+        constexpr PlayState() noexcept = default;
 
         /**
          * @param _playing Whether a pattern is currently playing
@@ -53,7 +55,8 @@ namespace blink1_lib {
          * @param _playCount The number of repetitions left in the loop
          * @param _playPos The current index in the pattern
          */
-        PlayState(const bool _playing, const std::uint8_t _playStart, const std::uint8_t _playEnd, const std::uint8_t _playCount, const std::uint8_t _playPos) noexcept;
+        constexpr PlayState(const bool _playing, const std::uint8_t _playStart, const std::uint8_t _playEnd, const std::uint8_t _playCount, const std::uint8_t _playPos) noexcept
+            : playing(_playing), playStart(_playStart), playEnd(_playEnd), playCount(_playCount), playPos(_playPos) {}
 
         /**
          * Equality operator
@@ -61,15 +64,15 @@ namespace blink1_lib {
          * @param other Object to compare to
          * @return true if the objects are equal, false otherwise
          */
-        [[nodiscard]] bool operator==(const PlayState& other) const noexcept;
+        [[nodiscard]] constexpr bool operator==(const PlayState& other) const noexcept = default;
 
         /**
-         * Inequality operator
+         * Three-way comparison operator. Compares playing, then playStart, playEnd, playCount and playPos.
          *
          * @param other Object to compare to
-         * @return true if the objects are not equal, false otherwise
+         * @return How this object is ordered relative to other
          */
-        [[nodiscard]] bool operator!=(const PlayState& other) const noexcept;
+        [[nodiscard]] constexpr std::strong_ordering operator<=>(const PlayState& other) const noexcept = default;
 
         /**
          * Output operator
@@ -79,4 +82,7 @@ namespace blink1_lib {
          */
         friend std::ostream& operator<<(std::ostream& os, const PlayState& playState);
     };
+
+    static_assert(std::is_trivially_copyable_v<PlayState> && std::is_standard_layout_v<PlayState>);
+    static_assert(sizeof(PlayState) == 5, "PlayState should be packed into one byte per field");
 }
@@ -0,0 +1,165 @@
+/**
+ * @file PrometheusExporter.hpp
+ * @brief Header file for blink1_lib::PrometheusExporter
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncBlink1Device.hpp"
+#include "Blink1Device.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Exports device metrics in the Prometheus text exposition format.
+     *
+     * Every sample is labelled with the serial of its device, as returned by
+     * Blink1Device::getSerial() when the device was added, so no two devices may share a
+     * serial. The following metrics are exported:
+     *
+     * - `blink1_up`: 1 if the device is open and the last command sent to it succeeded, 0
+     *   otherwise, as returned by Blink1Device::isResponding(). Scraping never sends anything
+     *   to the devices, so an unplugged device is only reported down once a command to it fails.
+     * - `blink1_commands_total`: commands sent to the device, labelled by operation
+     * - `blink1_command_failures_total`: commands that failed, labelled by operation
+     * - `blink1_command_latency_seconds`: a summary of how long commands took, labelled by operation,
+     *   with the quantiles in PrometheusExporter::QUANTILES
+     * - `blink1_shadow_cache_hits_total`: color writes skipped by the shadow cache
+     * - `blink1_queue_depth`: commands waiting to be sent, for devices added through an AsyncBlink1Device
+     * - `blink1_queue_capacity`: the size of the queue, for devices added through an AsyncBlink1Device
+     * - `blink1_coalesced_writes_total`: color writes that were coalesced, for devices added through an AsyncBlink1Device
+     *
+     * The metrics can be written to a file for node_exporter's textfile collector with
+     * writeTextfile(const std::string&), or served over a unix socket with
+     * serve(const std::string&).
+     */
+    class PrometheusExporter {
+        public:
+            /**
+             * The latency quantiles that are exported
+             */
+            static constexpr std::array<double, 3> QUANTILES{0.5, 0.9, 0.99};
+
+        private:
+            struct Source {
+                std::shared_ptr<Blink1Device> device;
+                std::shared_ptr<AsyncBlink1Device> asyncDevice;
+
+                // Read once, so the label stays the same if the device is disconnected
+                std::string serial;
+            };
+
+            mutable std::mutex sourcesMutex;
+            std::vector<Source> sources;
+
+            std::mutex serveMutex;
+            std::atomic<bool> serving{false};
+            int listenSocket{-1};
+            std::string socketPath;
+            std::thread serveThread;
+
+            bool addSource(Source source);
+            void serveLoop();
+            void respond(const int connection) const;
+
+        public:
+            /**
+             * Default constructor. Creates an exporter with no devices.
+             */
+            PrometheusExporter() = default;
+
+            PrometheusExporter(const PrometheusExporter& other) = delete;
+            PrometheusExporter& operator=(const PrometheusExporter& other) = delete;
+
+            /**
+             * Destructor. Stops serving if serve(const std::string&) was called.
+             */
+            ~PrometheusExporter();
+
+            /**
+             * Adds a device to export. Metrics are enabled on the device with
+             * Blink1Device::setMetricsEnabled(bool) if they aren't already.
+             *
+             * @param device The device to export
+             *
+             * @return true if the device was added, false if it is already exported, directly or
+             *         through an AsyncBlink1Device, or another exported device has the same serial
+             */
+            bool addDevice(std::shared_ptr<Blink1Device> device);
+
+            /**
+             * Adds a device to export along with the state of its queue. Metrics are
+             * enabled on the underlying device if they aren't already.
+             *
+             * @param device The device to export
+             *
+             * @return true if the device was added, false if it is already exported, directly or
+             *         through an AsyncBlink1Device, or another exported device has the same serial
+             */
+            bool addDevice(std::shared_ptr<AsyncBlink1Device> device);
+
+            /**
+             * Stops exporting every device
+             */
+            void clearDevices();
+
+            /**
+             * Writes the current metrics of every device
+             *
+             * @param os The stream to write to
+             */
+            void write(std::ostream& os) const;
+
+            /**
+             * Returns the current metrics of every device
+             *
+             * @return The metrics in the text exposition format
+             */
+            [[nodiscard]] std::string render() const;
+
+            /**
+             * Writes the current metrics to a file, for node_exporter's textfile collector. The
+             * metrics are written to a temporary file in the same directory which then replaces
+             * the file, so the collector never reads a partly written file.
+             *
+             * @param path The file to write, which should end in `.prom`
+             *
+             * @return true if the file was written, false otherwise
+             */
+            bool writeTextfile(const std::string& path) const;
+
+            /**
+             * Starts serving the metrics over a unix socket from a background thread. Each
+             * connection is answered with an HTTP response holding the current metrics and then
+             * closed, so the socket can be scraped with, for example, `curl --unix-socket`.
+             *
+             * A socket file left behind at the path is replaced. Any other file is not.
+             *
+             * @param path Where to create the socket
+             *
+             * @return true if the socket was created, false if it couldn't be or this object is already serving
+             */
+            bool serve(const std::string& path);
+
+            /**
+             * Stops serving and removes the socket. Does nothing if this object isn't serving.
+             */
+            void stopServing();
+
+            /**
+             * Returns whether this object is serving metrics over a socket
+             *
+             * @return true if serve(const std::string&) was called and stopServing() hasn't been since
+             */
+            [[nodiscard]] bool isServing() const noexcept;
+    };
+}
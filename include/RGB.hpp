@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <compare>
 #include <cstdint>
 #include <ostream>
+#include <type_traits>
 
 namespace blink1_lib {
 
@@ -31,18 +33,18 @@ namespace blink1_lib {
         std::uint8_t b{0};
 
         /**
-         * @param r Red value
-         * @param g Green value
-         * @param b Blue value
+         * @param _r Red value
+         * @param _g Green value
+         * @param _b Blue value
          */
-        RGB(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b) noexcept;
+        constexpr RGB(const std::uint8_t _r, const std::uint8_t _g, const std::uint8_t _b) noexcept : r(_r), g(_g), b(_b) {}
 
         /**
          * Default constructor
          *
          * Intializes all values to 0
          */
-        RGB() noexcept = default;
+        constexpr RGB() noexcept = default;
 
         /**
          * Equality operator
@@ -50,15 +52,15 @@ namespace blink1_lib {
          * @param other Object to compare to
          * @return true if the objects are equal, false otherwise
          */
-        [[nodiscard]] bool operator==(const RGB& other) const noexcept;
+        [[nodiscard]] constexpr bool operator==(const RGB& other) const noexcept = default;
 
         /**
-         * Inequality operator
+         * Three-way comparison operator. Compares r, then g, then b.
          *
          * @param other Object to compare to
-         * @return true if the objects are not equal, false otherwise
+         * @return How this object is ordered relative to other
          */
-        [[nodiscard]] bool operator!=(const RGB& other) const noexcept;
+        [[nodiscard]] constexpr std::strong_ordering operator<=>(const RGB& other) const noexcept = default;
 
         /**
          * Output operator
@@ -68,4 +70,7 @@ namespace blink1_lib {
          */
         friend std::ostream& operator<<(std::ostream& os, const RGB& rgb);
     };
+
+    static_assert(std::is_trivially_copyable_v<RGB> && std::is_standard_layout_v<RGB>);
+    static_assert(sizeof(RGB) == 3, "RGB should be packed into one byte per channel");
 }
@@ -5,8 +5,10 @@
 
 #pragma once
 
+#include <compare>
 #include <cstdint>
 #include <ostream>
+#include <type_traits>
 
 namespace blink1_lib {
 
@@ -35,19 +37,20 @@ namespace blink1_lib {
         std::uint8_t n{0};
 
         /**
-         * @param r Red value
-         * @param g Green value
-         * @param b Blue value
-         * @param n LED index
+         * @param _r Red value
+         * @param _g Green value
+         * @param _b Blue value
+         * @param _n LED index
          */
-        RGBN(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b, const std::uint8_t n) noexcept;
+        constexpr RGBN(const std::uint8_t _r, const std::uint8_t _g, const std::uint8_t _b, const std::uint8_t _n) noexcept
+            : r(_r), g(_g), b(_b), n(_n) {}
 
         /**
          * Default constructor
          *
          * Initializes all values to 0
          */
-        RGBN() noexcept = default;
+        constexpr RGBN() noexcept = default;
 
         /**
          * Equality operator
@@ -55,15 +58,15 @@ namespace blink1_lib {
          * @param other Object to compare to
          * @return true if the objects are equal, false otherwise
          */
-        [[nodiscard]] bool operator==(const RGBN& other) const noexcept;
+        [[nodiscard]] constexpr bool operator==(const RGBN& other) const noexcept = default;
 
         /**
-         * Inequality operator
+         * Three-way comparison operator. Compares r, then g, then b, then n.
          *
          * @param other Object to compare to
-         * @return true if the objects are not equal, false otherwise
+         * @return How this object is ordered relative to other
          */
-        [[nodiscard]] bool operator!=(const RGBN& other) const noexcept;
+        [[nodiscard]] constexpr std::strong_ordering operator<=>(const RGBN& other) const noexcept = default;
 
         /**
          * Output operator
@@ -73,4 +76,7 @@ namespace blink1_lib {
          */
         friend std::ostream& operator<<(std::ostream& os, const RGBN& rgb);
     };
+
+    static_assert(std::is_trivially_copyable_v<RGBN> && std::is_standard_layout_v<RGBN>);
+    static_assert(sizeof(RGBN) == 4, "RGBN should be packed into one byte per field");
 }
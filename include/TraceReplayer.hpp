@@ -0,0 +1,90 @@
+/**
+ * @file TraceReplayer.hpp
+ * @brief Header file for blink1_lib::TraceReplayer
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "Blink1Device.hpp"
+#include "Clock.hpp"
+#include "CommandTrace.hpp"
+
+namespace blink1_lib {
+
+    /**
+     * Sends the commands in a CommandTrace to a Blink1Device with the same timing they
+     * were recorded with, or faster.
+     *
+     * Each command is sent at its recorded time divided by the replay speed, measured
+     * from the start of the replay. Deadlines are absolute, so time spent sending one
+     * command is not added to the wait before the next. If the device falls behind,
+     * commands are sent back to back until it catches up.
+     *
+     * @note The Blink1Device must outlive this object
+     */
+    class TraceReplayer {
+        public:
+            /**
+             * Speed that sends every command as soon as the previous one finishes
+             */
+            static constexpr double MAX_SPEED = 0;
+
+            /**
+             * The outcome of a replay
+             */
+            struct Result {
+                /**
+                 * Number of commands sent
+                 */
+                std::size_t commandsSent{0};
+
+                /**
+                 * Number of commands the device reported as failed
+                 */
+                std::size_t failures{0};
+
+                /**
+                 * How long the replay took, measured by the replayer's clock
+                 */
+                Clock::duration elapsed{0};
+
+                /**
+                 * Returns the number of commands sent per second
+                 *
+                 * @return The throughput of the replay, or 0 if it took no time
+                 */
+                [[nodiscard]] double commandsPerSecond() const noexcept;
+            };
+
+        private:
+            Blink1Device& device;
+            std::shared_ptr<Clock> clock;
+
+            bool send(const CommandTrace::Entry& entry) noexcept;
+
+        public:
+            /**
+             * @param device The device to send commands to
+             * @param clock The clock used to time the commands
+             */
+            explicit TraceReplayer(Blink1Device& device, std::shared_ptr<Clock> clock = Clock::steady());
+
+            /**
+             * Sends every command in a trace and waits for the last one to be sent
+             *
+             * @param trace The trace to replay
+             * @param speed How many times faster than recorded to replay, for example 1 for
+             *              the recorded speed or 10 for ten times faster. MAX_SPEED, or any
+             *              other value that isn't greater than 0, as well as infinity and NaN,
+             *              ignores the recorded times. Speeds so small that a scaled time
+             *              would pass the latest time the clock can hold wait until that time.
+             *
+             * @return The number of commands sent and how long it took
+             */
+            Result replay(const CommandTrace& trace, const double speed = 1.0);
+    };
+}
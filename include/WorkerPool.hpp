@@ -0,0 +1,70 @@
+/**
+ * @file WorkerPool.hpp
+ * @brief Header file for blink1_lib::WorkerPool
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace blink1_lib {
+
+    /**
+     * A fixed-size pool of threads that runs submitted tasks
+     */
+    class WorkerPool {
+        std::mutex mutex;
+        std::condition_variable taskAvailable;
+        std::deque<std::function<void()>> tasks;
+        bool stopping{false};
+        std::vector<std::thread> workers;
+
+        void run();
+
+        public:
+            /**
+             * @param threadCount Number of threads in the pool. If 0, one thread per hardware thread is used.
+             */
+            explicit WorkerPool(std::size_t threadCount = 0);
+
+            WorkerPool(const WorkerPool& other) = delete;
+            WorkerPool& operator=(const WorkerPool& other) = delete;
+
+            /**
+             * Destructor. Runs any tasks that are still queued, then stops the threads.
+             */
+            ~WorkerPool();
+
+            /**
+             * Queues a task to be run on one of the pool's threads
+             *
+             * @param task The task to run
+             */
+            void submit(std::function<void()> task);
+
+            /**
+             * Runs `task(i)` for every `i` in `[0, count)` on the pool's threads and waits
+             * for all of them to finish. If any of them throw, the first exception is rethrown
+             * once all of them have finished.
+             *
+             * @note Must not be called from one of the pool's own threads
+             *
+             * @param count Number of times to run the task
+             * @param task The task to run
+             */
+            void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+            /**
+             * Returns the number of threads in the pool
+             *
+             * @return The number of threads
+             */
+            [[nodiscard]] std::size_t size() const noexcept;
+    };
+}
@@ -6,9 +6,27 @@
  */
 #pragma once
 
+#include "Animation.hpp"
+#include "AnimationEngine.hpp"
+#include "AsyncBlink1Device.hpp"
 #include "Blink1Device.hpp"
+#include "Blink1DeviceManager.hpp"
+#include "ChromeTraceWriter.hpp"
+#include "Clock.hpp"
+#include "CommandRecorder.hpp"
+#include "CommandTrace.hpp"
+#include "DeviceGroup.hpp"
+#include "DeviceMetrics.hpp"
+#include "FadeTimer.hpp"
+#include "LatencyHistogram.hpp"
+#include "PatternCompiler.hpp"
+#include "PatternFolder.hpp"
 #include "PatternLine.hpp"
 #include "PatternLineN.hpp"
+#include "PatternSimplifier.hpp"
+#include "PrometheusExporter.hpp"
 #include "RGB.hpp"
 #include "RGBN.hpp"
+#include "TraceReplayer.hpp"
+#include "WorkerPool.hpp"
 
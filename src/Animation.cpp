@@ -0,0 +1,101 @@
+#include "Animation.hpp"
+
+#include <algorithm>
+
+namespace blink1_lib {
+    static std::chrono::milliseconds trackDuration(const std::vector<PatternLineN>& track) noexcept {
+        std::chrono::milliseconds duration(0);
+        for (const PatternLineN& keyframe : track) {
+            duration += std::chrono::milliseconds(keyframe.fadeMillis);
+        }
+        return duration;
+    }
+
+    Animation::Animation(std::span<const PatternLineN> keyframes, const bool _looping) : looping(_looping) {
+        for (const PatternLineN& keyframe : keyframes) {
+            addKeyframe(keyframe);
+        }
+    }
+
+    void Animation::addKeyframe(const PatternLineN& keyframe) {
+        tracks[keyframe.rgbn.n].push_back(keyframe);
+    }
+
+    void Animation::setLooping(const bool _looping) noexcept {
+        looping = _looping;
+    }
+
+    bool Animation::isLooping() const noexcept {
+        return looping;
+    }
+
+    std::vector<std::uint8_t> Animation::getLeds() const {
+        std::vector<std::uint8_t> leds;
+        leds.reserve(tracks.size());
+        for (const auto& [ledn, track] : tracks) {
+            leds.push_back(ledn);
+        }
+        return leds;
+    }
+
+    const std::vector<PatternLineN>& Animation::getTrack(const std::uint8_t ledn) const noexcept {
+        static const std::vector<PatternLineN> noTrack;
+        const auto it = tracks.find(ledn);
+        return it == tracks.end() ? noTrack : it->second;
+    }
+
+    bool Animation::empty() const noexcept {
+        return tracks.empty();
+    }
+
+    std::chrono::milliseconds Animation::getDuration() const noexcept {
+        std::chrono::milliseconds duration(0);
+        for (const auto& [ledn, track] : tracks) {
+            duration = std::max(duration, trackDuration(track));
+        }
+        return duration;
+    }
+
+    bool Animation::isFinished(const Clock::duration elapsed) const noexcept {
+        const auto duration = getDuration();
+        return (!looping || duration.count() == 0) && elapsed >= duration;
+    }
+
+    std::optional<Animation::Segment> Animation::segmentAt(const std::uint8_t ledn, const Clock::duration elapsed) const noexcept {
+        const auto& track = getTrack(ledn);
+        if (track.empty()) {
+            return std::nullopt;
+        }
+
+        const auto duration = trackDuration(track);
+        Clock::duration within = std::max(elapsed, Clock::duration::zero());
+        std::uint64_t pass = 0;
+        if (looping && duration.count() > 0) {
+            pass = static_cast<std::uint64_t>(within / duration);
+            within %= duration;
+        }
+
+        const std::size_t count = track.size();
+        auto makeSegment = [&track, count, pass](const std::size_t position, const Clock::duration remaining) {
+            Segment segment;
+            segment.index = pass * count + position;
+            segment.keyframe = track[position];
+            if (position > 0) {
+                segment.previous = track[position - 1];
+            } else if (pass > 0) {
+                segment.previous = track.back();
+            }
+            segment.remaining = std::chrono::ceil<std::chrono::milliseconds>(remaining);
+            return segment;
+        };
+
+        Clock::duration end(0);
+        for (std::size_t position = 0; position < count; ++position) {
+            end += std::chrono::milliseconds(track[position].fadeMillis);
+            if (within < end) {
+                return makeSegment(position, end - within);
+            }
+        }
+        return makeSegment(count - 1, Clock::duration::zero());
+    }
+}
@@ -0,0 +1,184 @@
+#include "AnimationEngine.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace blink1_lib {
+    static double validFrameRate(const double framesPerSecond) noexcept {
+        // Written so that NaN fails too
+        if (!(framesPerSecond > 0)) {
+            return AnimationEngine::DEFAULT_FRAME_RATE;
+        }
+        return std::min(framesPerSecond, AnimationEngine::MAX_FRAME_RATE);
+    }
+
+    AnimationEngine::AnimationEngine(const double framesPerSecond, std::shared_ptr<Clock> _clock)
+        : clock(_clock ? std::move(_clock) : Clock::steady()),
+          frameRate(validFrameRate(framesPerSecond)),
+          // At least one tick, since the catch-up after a late frame divides by it
+          framePeriod(std::max(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRate)), Clock::duration(1))),
+          schedulerThread(&AnimationEngine::run, this)
+    {}
+
+    AnimationEngine::~AnimationEngine() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        schedulerThread.join();
+    }
+
+    void AnimationEngine::waitForFrame(std::unique_lock<std::mutex>& lock) {
+        frameSent.wait(lock, [this] { return !sendingFrame; });
+    }
+
+    void AnimationEngine::play(std::shared_ptr<Blink1Device> device, Animation animation) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            waitForFrame(lock);
+            const Blink1Device* key = device.get();
+            playing[key] = Playing{std::move(device), std::move(animation), clock->now(), {}};
+        }
+        wakeUp.notify_all();
+    }
+
+    bool AnimationEngine::stop(const Blink1Device& device) {
+        std::unique_lock<std::mutex> lock(mutex);
+        waitForFrame(lock);
+        return playing.erase(&device) > 0;
+    }
+
+    void AnimationEngine::stopAll() {
+        std::unique_lock<std::mutex> lock(mutex);
+        waitForFrame(lock);
+        playing.clear();
+    }
+
+    bool AnimationEngine::isPlaying(const Blink1Device& device) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return playing.contains(&device);
+    }
+
+    std::size_t AnimationEngine::playingCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return playing.size();
+    }
+
+    double AnimationEngine::getFrameRate() const noexcept {
+        return frameRate;
+    }
+
+    std::uint64_t AnimationEngine::getFrameCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return frames;
+    }
+
+    std::uint64_t AnimationEngine::getSkippedFrameCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return skippedFrames;
+    }
+
+    std::uint64_t AnimationEngine::getCommandCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return commandsSent;
+    }
+
+    std::uint64_t AnimationEngine::getFailedCommandCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return failedCommands;
+    }
+
+    void AnimationEngine::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        Clock::time_point nextFrame;
+        bool idle = true;
+        while (!stopping) {
+            if (playing.empty()) {
+                wakeUp.wait(lock);
+                idle = true;
+                continue;
+            }
+
+            if (idle) {
+                // Start ticking as soon as there is something to play
+                nextFrame = clock->now();
+                idle = false;
+            }
+
+            if (clock->now() < nextFrame) {
+                // Woken early if the engine is stopped
+                clock->waitUntil(lock, wakeUp, nextFrame);
+                continue;
+            }
+
+            auto work = planFrame(clock->now());
+            sendingFrame = true;
+            lock.unlock();
+            std::uint64_t sent = 0;
+            std::uint64_t failed = 0;
+            for (const auto& [device, commands] : work) {
+                for (const FadeCommand& command : commands) {
+                    ++sent;
+                    if (!device->fadeToRGBN(command.fadeMillis, command.rgbn)) {
+                        ++failed;
+                    }
+                }
+            }
+            lock.lock();
+            sendingFrame = false;
+            frameSent.notify_all();
+
+            ++frames;
+            commandsSent += sent;
+            failedCommands += failed;
+
+            // Skip any frames whose time already passed while this one was being sent
+            nextFrame += framePeriod;
+            const auto now = clock->now();
+            if (now > nextFrame) {
+                const auto missed = (now - nextFrame + framePeriod - Clock::duration(1)) / framePeriod;
+                skippedFrames += static_cast<std::uint64_t>(missed);
+                nextFrame += missed * framePeriod;
+            }
+        }
+    }
+
+    std::vector<std::pair<std::shared_ptr<Blink1Device>, std::vector<AnimationEngine::FadeCommand>>> AnimationEngine::planFrame(const Clock::time_point now) {
+        std::vector<std::pair<std::shared_ptr<Blink1Device>, std::vector<FadeCommand>>> work;
+        for (auto it = playing.begin(); it != playing.end();) {
+            Playing& state = it->second;
+            const auto elapsed = now - state.start;
+
+            std::vector<FadeCommand> commands;
+            for (const std::uint8_t ledn : state.animation.getLeds()) {
+                const auto segment = state.animation.segmentAt(ledn, elapsed);
+                const auto lastSent = state.sent.find(ledn);
+                if (!segment || (lastSent != state.sent.end() && lastSent->second == segment->index)) {
+                    continue;
+                }
+
+                // The keyframe this fade starts from was skipped, so jump straight to it
+                const bool previousSkipped = lastSent == state.sent.end() ? segment->index > 0 : lastSent->second + 1 < segment->index;
+                if (segment->previous && previousSkipped) {
+                    commands.push_back(FadeCommand{0, segment->previous->rgbn});
+                }
+
+                const auto remaining = std::min<std::chrono::milliseconds::rep>(segment->remaining.count(), UINT16_MAX);
+                commands.push_back(FadeCommand{static_cast<std::uint16_t>(remaining), segment->keyframe.rgbn});
+                state.sent[ledn] = segment->index;
+            }
+
+            if (!commands.empty()) {
+                work.emplace_back(state.device, std::move(commands));
+            }
+
+            if (state.animation.isFinished(elapsed)) {
+                it = playing.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return work;
+    }
+}
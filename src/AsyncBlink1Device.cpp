@@ -0,0 +1,270 @@
+#include "AsyncBlink1Device.hpp"
+
+#include <memory>
+
+namespace blink1_lib {
+    AsyncBlink1Device::AsyncBlink1Device(Blink1Device& _device, const std::size_t capacity, const OVERFLOW_POLICY overflowPolicy)
+        : device(_device), maxQueued(capacity == 0 ? 1 : capacity), policy(overflowPolicy), ioThread(&AsyncBlink1Device::run, this) {}
+
+    AsyncBlink1Device::~AsyncBlink1Device() {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        commandAvailable.notify_all();
+        ioThread.join();
+    }
+
+    bool AsyncBlink1Device::waitForSpace(std::unique_lock<std::mutex>& lock) {
+        if (commands.size() >= maxQueued) {
+            if (policy == OVERFLOW_POLICY::REJECT) {
+                return false;
+            }
+            spaceAvailable.wait(lock, [this] { return commands.size() < maxQueued; });
+        }
+        return true;
+    }
+
+    template <typename T>
+    std::future<T> AsyncBlink1Device::enqueue(std::function<T(Blink1Device&)> command, T rejectedValue) {
+        auto promise = std::make_shared<std::promise<T>>();
+        auto future = promise->get_future();
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (!waitForSpace(lock)) {
+                lock.unlock();
+                promise->set_value(std::move(rejectedValue));
+                return future;
+            }
+
+            Command queued;
+            markEnqueued(queued);
+            queued.run = [promise, command = std::move(command)](Blink1Device& dev) {
+                try {
+                    promise->set_value(command(dev));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            };
+            commands.push_back(std::move(queued));
+        }
+        commandAvailable.notify_one();
+
+        return future;
+    }
+
+    std::future<bool> AsyncBlink1Device::enqueueColorWrite(const std::uint8_t ledn, std::function<bool(Blink1Device&)> write) {
+        auto promise = std::make_shared<std::promise<bool>>();
+        auto future = promise->get_future();
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            if (coalescing && coalesceColorWrite(ledn, write, promise)) {
+                return future;
+            }
+
+            std::vector<std::shared_ptr<std::promise<bool>>> supersededPromises;
+            if (coalescing && ledn == 0) {
+                // A whole-device write replaces every color write queued after the last other command
+                while (!commands.empty() && commands.back().colorWrite) {
+                    auto& promises = commands.back().colorWritePromises;
+                    supersededPromises.insert(supersededPromises.end(), promises.begin(), promises.end());
+                    commands.pop_back();
+                    ++coalescedWrites;
+                }
+            }
+
+            if (!waitForSpace(lock)) {
+                lock.unlock();
+                promise->set_value(false);
+                return future;
+            }
+
+            Command queued;
+            markEnqueued(queued);
+            queued.colorWrite = std::move(write);
+            queued.colorWritePromises = std::move(supersededPromises);
+            queued.colorWritePromises.push_back(std::move(promise));
+            queued.ledn = ledn;
+            commands.push_back(std::move(queued));
+        }
+        commandAvailable.notify_one();
+
+        return future;
+    }
+
+    bool AsyncBlink1Device::coalesceColorWrite(const std::uint8_t ledn, std::function<bool(Blink1Device&)>& write, std::shared_ptr<std::promise<bool>>& promise) {
+        if (ledn == 0) {
+            return false;
+        }
+
+        for (auto it = commands.rbegin(); it != commands.rend() && it->colorWrite; ++it) {
+            if (it->ledn == 0) {
+                // Can't move past a whole-device write without changing the final color
+                return false;
+            }
+            if (it->ledn == ledn) {
+                it->colorWrite = std::move(write);
+                it->colorWritePromises.push_back(std::move(promise));
+                ++coalescedWrites;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void AsyncBlink1Device::markEnqueued(Command& command) const {
+        if (device.isTracing()) {
+            command.traced = true;
+            command.enqueueTime = device.getClock()->now();
+        }
+    }
+
+    void AsyncBlink1Device::traceQueued(const Command& command) const noexcept {
+        if (!command.traced) {
+            return;
+        }
+
+        // Coalesced writes keep the time the first of them was queued
+        ChromeTraceWriter::Span span;
+        span.name = "queued";
+        span.category = "queue";
+        span.start = command.enqueueTime;
+        span.end = device.getClock()->now();
+        if (command.colorWrite) {
+            span.ledn = command.ledn;
+        }
+        span.async = true;
+        device.traceSpan(std::move(span));
+    }
+
+    void AsyncBlink1Device::run() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (true) {
+            commandAvailable.wait(lock, [this] { return stopping || !commands.empty(); });
+            if (commands.empty()) {
+                return;
+            }
+
+            auto command = std::move(commands.front());
+            commands.pop_front();
+            commandRunning = true;
+            lock.unlock();
+            spaceAvailable.notify_one();
+
+            traceQueued(command);
+            if (command.colorWrite) {
+                const bool result = command.colorWrite(device);
+                for (auto& promise : command.colorWritePromises) {
+                    promise->set_value(result);
+                }
+            } else {
+                command.run(device);
+            }
+
+            lock.lock();
+            commandRunning = false;
+            if (commands.empty()) {
+                queueIdle.notify_all();
+            }
+        }
+    }
+
+    std::future<bool> AsyncBlink1Device::fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb) {
+        return enqueueColorWrite(0, [fadeMillis, rgb](Blink1Device& dev) { return dev.fadeToRGB(fadeMillis, rgb); });
+    }
+
+    std::future<bool> AsyncBlink1Device::fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn) {
+        return enqueueColorWrite(rgbn.n, [fadeMillis, rgbn](Blink1Device& dev) { return dev.fadeToRGBN(fadeMillis, rgbn); });
+    }
+
+    std::future<bool> AsyncBlink1Device::setRGB(const RGB& rgb) {
+        return enqueueColorWrite(0, [rgb](Blink1Device& dev) { return dev.setRGB(rgb); });
+    }
+
+    std::future<bool> AsyncBlink1Device::setRGBN(const RGBN& rgbn) {
+        return enqueueColorWrite(rgbn.n, [rgbn](Blink1Device& dev) { return dev.setRGBN(rgbn); });
+    }
+
+    std::future<std::optional<PatternLine>> AsyncBlink1Device::readRGBWithFade(const std::uint8_t ledn) {
+        return enqueue<std::optional<PatternLine>>([ledn](Blink1Device& dev) { return dev.readRGBWithFade(ledn); }, std::nullopt);
+    }
+
+    std::future<std::optional<RGB>> AsyncBlink1Device::readRGB(const std::uint8_t ledn) {
+        return enqueue<std::optional<RGB>>([ledn](Blink1Device& dev) { return dev.readRGB(ledn); }, std::nullopt);
+    }
+
+    std::future<bool> AsyncBlink1Device::play(const std::uint8_t pos) {
+        return submit([pos](Blink1Device& dev) { return dev.play(pos); });
+    }
+
+    std::future<bool> AsyncBlink1Device::playLoop(const std::uint8_t startpos, const std::uint8_t endpos, const std::uint8_t count) {
+        return submit([startpos, endpos, count](Blink1Device& dev) { return dev.playLoop(startpos, endpos, count); });
+    }
+
+    std::future<bool> AsyncBlink1Device::stop() {
+        return submit([](Blink1Device& dev) { return dev.stop(); });
+    }
+
+    std::future<std::optional<PlayState>> AsyncBlink1Device::readPlayState() {
+        return enqueue<std::optional<PlayState>>([](Blink1Device& dev) { return dev.readPlayState(); }, std::nullopt);
+    }
+
+    std::future<bool> AsyncBlink1Device::writePatternLine(const PatternLine& line, const std::uint8_t pos) {
+        return submit([line, pos](Blink1Device& dev) { return dev.writePatternLine(line, pos); });
+    }
+
+    std::future<bool> AsyncBlink1Device::writePatternLineN(const PatternLineN& line, const std::uint8_t pos) {
+        return submit([line, pos](Blink1Device& dev) { return dev.writePatternLineN(line, pos); });
+    }
+
+    std::future<std::optional<PatternLine>> AsyncBlink1Device::readPatternLine(const std::uint8_t pos) {
+        return enqueue<std::optional<PatternLine>>([pos](Blink1Device& dev) { return dev.readPatternLine(pos); }, std::nullopt);
+    }
+
+    std::future<std::optional<PatternLineN>> AsyncBlink1Device::readPatternLineN(const std::uint8_t pos) {
+        return enqueue<std::optional<PatternLineN>>([pos](Blink1Device& dev) { return dev.readPatternLineN(pos); }, std::nullopt);
+    }
+
+    std::future<bool> AsyncBlink1Device::savePattern() {
+        return submit([](Blink1Device& dev) { return dev.savePattern(); });
+    }
+
+    std::future<bool> AsyncBlink1Device::submit(std::function<bool(Blink1Device&)> command) {
+        return enqueue<bool>(std::move(command), false);
+    }
+
+    void AsyncBlink1Device::setCoalescing(bool coalesce) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        coalescing = coalesce;
+    }
+
+    bool AsyncBlink1Device::isCoalescing() const {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return coalescing;
+    }
+
+    std::uint64_t AsyncBlink1Device::coalescedCount() const {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return coalescedWrites;
+    }
+
+    void AsyncBlink1Device::flush() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueIdle.wait(lock, [this] { return commands.empty() && !commandRunning; });
+    }
+
+    std::size_t AsyncBlink1Device::queueDepth() const {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        return commands.size();
+    }
+
+    std::size_t AsyncBlink1Device::capacity() const noexcept {
+        return maxQueued;
+    }
+
+    Blink1Device& AsyncBlink1Device::getDevice() const noexcept {
+        return device;
+    }
+}
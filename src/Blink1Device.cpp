@@ -1,6 +1,8 @@
 #include "Blink1Device.hpp"
 
-#include <thread>
+#include <algorithm>
+
+#include "FadeTimer.hpp"
 
 namespace blink1_lib {
     Blink1Device::Blink1Device() noexcept : device(blink1_open(), Blink1Device::destroyBlinkDevice) {}
@@ -41,38 +43,89 @@ namespace blink1_lib {
         return good();
     }
 
+    bool Blink1Device::isResponding() const noexcept {
+        return lastCommandSucceeded.load(std::memory_order_relaxed);
+    }
+
     std::optional<int> Blink1Device::getVersion() const noexcept {
         if (good()) {
-            return blink1_getVersion(device.get());
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
+            const auto version = blink1_getVersion(device.get());
+            finishOperation(DeviceMetrics::OPERATION::GET_VERSION, start, version >= 0);
+            return version;
         }
         return std::nullopt;
     }
 
     bool Blink1Device::fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb) noexcept {
         if (good()) {
-            auto retVal = blink1_fadeToRGB(device.get(), fadeMillis, rgb.r, rgb.g, rgb.b);
-            if (blocking && 0 <= retVal) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(fadeMillis));
+            const PatternLine line(rgb, fadeMillis);
+            {
+                std::lock_guard<std::mutex> lock(deviceMutex);
+                if (shadowCacheHit(0, line)) {
+                    return true;
+                }
+
+                const auto start = startOperation();
+                const auto retVal = blink1_fadeToRGB(device.get(), fadeMillis, rgb.r, rgb.g, rgb.b);
+                finishOperation(DeviceMetrics::OPERATION::FADE_TO_RGB, start, 0 <= retVal, 0, fadeMillis);
+                updateShadowCache(0, 0 <= retVal ? std::optional(line) : std::nullopt);
+                if (0 > retVal) {
+                    return false;
+                }
+                updateFadeDeadline(0, fadeMillis);
             }
-            return 0 <= retVal;
+
+            // Wait outside of the lock so that other threads can still talk to the device
+            waitIfBlocking(0);
+            return true;
         }
         return false;
     }
 
     bool Blink1Device::fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn) noexcept {
         if (good()) {
-            auto retVal = blink1_fadeToRGBN(device.get(), fadeMillis, rgbn.r, rgbn.g, rgbn.b, rgbn.n);
-            if (blocking && 0 <= retVal) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(fadeMillis));
+            const PatternLine line(rgbn.r, rgbn.g, rgbn.b, fadeMillis);
+            {
+                std::lock_guard<std::mutex> lock(deviceMutex);
+                if (shadowCacheHit(rgbn.n, line)) {
+                    return true;
+                }
+
+                const auto start = startOperation();
+                const auto retVal = blink1_fadeToRGBN(device.get(), fadeMillis, rgbn.r, rgbn.g, rgbn.b, rgbn.n);
+                finishOperation(DeviceMetrics::OPERATION::FADE_TO_RGBN, start, 0 <= retVal, rgbn.n, fadeMillis);
+                updateShadowCache(rgbn.n, 0 <= retVal ? std::optional(line) : std::nullopt);
+                if (0 > retVal) {
+                    return false;
+                }
+                updateFadeDeadline(rgbn.n, fadeMillis);
             }
-            return 0 <= retVal;
+
+            // Wait outside of the lock so that other threads can still talk to the device
+            waitIfBlocking(rgbn.n);
+            return true;
         }
         return false;
     }
 
     bool Blink1Device::setRGB(const RGB& rgb) noexcept {
         if (good()) {
-            return 0 <= blink1_setRGB(device.get(), rgb.r, rgb.g, rgb.b);
+            const PatternLine line(rgb, 0);
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            if (shadowCacheHit(0, line)) {
+                return true;
+            }
+
+            const auto start = startOperation();
+            auto retVal = blink1_setRGB(device.get(), rgb.r, rgb.g, rgb.b);
+            finishOperation(DeviceMetrics::OPERATION::SET_RGB, start, 0 <= retVal, 0, 0);
+            updateShadowCache(0, 0 <= retVal ? std::optional(line) : std::nullopt);
+            if (0 <= retVal) {
+                updateFadeDeadline(0, 0);
+            }
+            return 0 <= retVal;
         }
         return false;
     }
@@ -84,7 +137,10 @@ namespace blink1_lib {
     std::optional<PatternLine> Blink1Device::readRGBWithFade(const std::uint8_t ledn) const noexcept {
         if (good()) {
             PatternLine line;
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
             const auto retVal = blink1_readRGB(device.get(), &line.fadeMillis, &line.rgb.r, &line.rgb.g, &line.rgb.b, ledn);
+            finishOperation(DeviceMetrics::OPERATION::READ_RGB_WITH_FADE, start, retVal >= 0, ledn);
             if (retVal >= 0) {
                 return line;
             }
@@ -102,21 +158,35 @@ namespace blink1_lib {
 
     bool Blink1Device::play(const std::uint8_t pos) noexcept {
         if (good()) {
-            return 0 <= blink1_play(device.get(), 1, pos);
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            shadowState.fill(std::nullopt);
+            const auto start = startOperation();
+            const bool success = 0 <= blink1_play(device.get(), 1, pos);
+            finishOperation(DeviceMetrics::OPERATION::PLAY, start, success);
+            return success;
         }
         return false;
     }
 
     bool Blink1Device::playLoop(std::uint8_t startpos, std::uint8_t endpos, std::uint8_t count) noexcept {
         if (good()) {
-            return 0 <= blink1_playloop(device.get(), 1, startpos, endpos, count);
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            shadowState.fill(std::nullopt);
+            const auto start = startOperation();
+            const bool success = 0 <= blink1_playloop(device.get(), 1, startpos, endpos, count);
+            finishOperation(DeviceMetrics::OPERATION::PLAY_LOOP, start, success);
+            return success;
         }
         return false;
     }
 
     bool Blink1Device::stop() noexcept {
         if (good()) {
-            return 0 <= blink1_play(device.get(), 0, 0);
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
+            const bool success = 0 <= blink1_play(device.get(), 0, 0);
+            finishOperation(DeviceMetrics::OPERATION::STOP, start, success);
+            return success;
         }
         return false;
     }
@@ -125,7 +195,10 @@ namespace blink1_lib {
         if (good()) {
             PlayState state;
             std::uint8_t playing = 0;
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
             const auto retVal = blink1_readPlayState(device.get(), &playing, &state.playStart, &state.playEnd, &state.playCount, &state.playPos);
+            finishOperation(DeviceMetrics::OPERATION::READ_PLAY_STATE, start, retVal >= 0);
             state.playing = (playing == 1);
             if (retVal >= 0) {
                 return state;
@@ -136,16 +209,27 @@ namespace blink1_lib {
 
     bool Blink1Device::writePatternLine(const PatternLine& line, const std::uint8_t pos) noexcept {
         if (good()) {
-            return 0 <= blink1_writePatternLine(device.get(), line.fadeMillis, line.rgb.r, line.rgb.g, line.rgb.b, pos);
+            // The LED this line applies to depends on the device's current LEDN, so it can't be mirrored
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            updatePatternMirror(pos, std::nullopt);
+            const auto start = startOperation();
+            const bool success = 0 <= blink1_writePatternLine(device.get(), line.fadeMillis, line.rgb.r, line.rgb.g, line.rgb.b, pos);
+            finishOperation(DeviceMetrics::OPERATION::WRITE_PATTERN_LINE, start, success, std::nullopt, line.fadeMillis);
+            return success;
         }
         return false;
     }
 
     bool Blink1Device::writePatternLineN(const PatternLineN& line, const std::uint8_t pos) noexcept {
         if (good()) {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
             const auto retVal1 = blink1_setLEDN(device.get(), line.rgbn.n);
             const auto retVal2 = blink1_writePatternLine(device.get(), line.fadeMillis, line.rgbn.r, line.rgbn.g, line.rgbn.b, pos);
-            return retVal1 >= 0 && retVal2 >= 0;
+            const bool success = retVal1 >= 0 && retVal2 >= 0;
+            finishOperation(DeviceMetrics::OPERATION::WRITE_PATTERN_LINE_N, start, success, line.rgbn.n, line.fadeMillis);
+            updatePatternMirror(pos, success ? std::optional(line) : std::nullopt);
+            return success;
         }
         return false;
     }
@@ -153,7 +237,10 @@ namespace blink1_lib {
     std::optional<PatternLine> Blink1Device::readPatternLine(const std::uint8_t pos) const noexcept {
         if (good()) {
             PatternLine line;
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
             int retVal = blink1_readPatternLine(device.get(), &line.fadeMillis, &line.rgb.r, &line.rgb.g, &line.rgb.b, pos);
+            finishOperation(DeviceMetrics::OPERATION::READ_PATTERN_LINE, start, retVal >= 0);
             if (retVal >= 0) {
                 return line;
             }
@@ -164,21 +251,138 @@ namespace blink1_lib {
     std::optional<PatternLineN> Blink1Device::readPatternLineN(const std::uint8_t pos) const noexcept {
         if (good()) {
             PatternLineN line;
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            const auto start = startOperation();
             int retVal = blink1_readPatternLineN(device.get(), &line.fadeMillis, &line.rgbn.r, &line.rgbn.g, &line.rgbn.b, &line.rgbn.n, pos);
+            finishOperation(DeviceMetrics::OPERATION::READ_PATTERN_LINE_N, start, retVal >= 0);
             if (retVal >= 0) {
+                patternMirror[pos] = line;
                 return line;
             }
         }
         return std::nullopt;
     }
 
+    std::optional<std::size_t> Blink1Device::writePattern(std::span<const PatternLineN> lines, const std::uint8_t startPos) noexcept {
+        // Held for the whole batch, since another thread changing the LEDN would redirect the remaining lines
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        std::optional<std::uint8_t> currentLedn;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            const std::size_t pos = startPos + i;
+            if (!good() || pos > UINT8_MAX) {
+                return pos;
+            }
+
+            if (!writeMirroredPatternLine(lines[i], static_cast<std::uint8_t>(pos), currentLedn)) {
+                return pos;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::size_t> Blink1Device::syncPattern(std::span<const PatternLineN> lines, const std::uint8_t startPos) noexcept {
+        // Held for the whole batch, see writePattern()
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        std::optional<std::uint8_t> currentLedn;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            const std::size_t pos = startPos + i;
+            if (!good() || pos > UINT8_MAX) {
+                return pos;
+            }
+
+            if (patternMirror[pos] == lines[i]) {
+                continue;
+            }
+            if (!writeMirroredPatternLine(lines[i], static_cast<std::uint8_t>(pos), currentLedn)) {
+                return pos;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<PatternLineN> Blink1Device::getMirroredPatternLine(const std::uint8_t pos) const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        return patternMirror[pos];
+    }
+
+    void Blink1Device::clearPatternMirror() noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        patternMirror.fill(std::nullopt);
+        patternChangedSinceSave = true;
+    }
+
+    bool Blink1Device::writeMirroredPatternLine(const PatternLineN& line, const std::uint8_t pos, std::optional<std::uint8_t>& currentLedn) noexcept {
+        const auto start = startOperation();
+        if (currentLedn != line.rgbn.n) {
+            if (0 > blink1_setLEDN(device.get(), line.rgbn.n)) {
+                finishOperation(DeviceMetrics::OPERATION::WRITE_PATTERN_LINE_N, start, false, line.rgbn.n, line.fadeMillis);
+                currentLedn = std::nullopt;
+                updatePatternMirror(pos, std::nullopt);
+                return false;
+            }
+            currentLedn = line.rgbn.n;
+        }
+
+        const bool success = 0 <= blink1_writePatternLine(device.get(), line.fadeMillis, line.rgbn.r, line.rgbn.g, line.rgbn.b, pos);
+        finishOperation(DeviceMetrics::OPERATION::WRITE_PATTERN_LINE_N, start, success, line.rgbn.n, line.fadeMillis);
+        updatePatternMirror(pos, success ? std::optional(line) : std::nullopt);
+        return success;
+    }
+
+    void Blink1Device::updatePatternMirror(const std::uint8_t pos, const std::optional<PatternLineN>& line) noexcept {
+        if (!line || patternMirror[pos] != line) {
+            patternChangedSinceSave = true;
+        }
+        patternMirror[pos] = line;
+    }
+
+    std::optional<std::vector<PatternLineN>> Blink1Device::readPattern(const std::uint8_t startPos, const std::size_t count) const {
+        // Written so that a huge count can't wrap around
+        if (count > std::size_t{UINT8_MAX} + 1 - startPos) {
+            return std::nullopt;
+        }
+
+        std::vector<PatternLineN> lines;
+        lines.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto line = readPatternLineN(static_cast<std::uint8_t>(startPos + i));
+            if (!line) {
+                return std::nullopt;
+            }
+            lines.push_back(*line);
+        }
+        return lines;
+    }
+
     bool Blink1Device::savePattern() noexcept {
         if (good()) {
-            return 0 <= blink1_savePattern(device.get());
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            return sendSavePattern();
         }
         return false;
     }
 
+    bool Blink1Device::savePatternIfChanged() noexcept {
+        if (good()) {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            if (!patternChangedSinceSave) {
+                return true;
+            }
+            return sendSavePattern();
+        }
+        return false;
+    }
+
+    bool Blink1Device::sendSavePattern() noexcept {
+        const auto start = startOperation();
+        const bool success = 0 <= blink1_savePattern(device.get());
+        finishOperation(DeviceMetrics::OPERATION::SAVE_PATTERN, start, success);
+        if (success) {
+            patternChangedSinceSave = false;
+        }
+        return success;
+    }
+
     void Blink1Device::enableDegamma() noexcept {
         blink1_enableDegamma();
     }
@@ -197,6 +401,7 @@ namespace blink1_lib {
 
     std::optional<int> Blink1Device::getCacheIndex() const noexcept {
         if (good()) {
+            std::lock_guard<std::mutex> lock(deviceMutex);
             int cacheIndex = blink1_getCacheIndexByDev(device.get());
             if (cacheIndex != -1) {
                 return cacheIndex;
@@ -207,6 +412,7 @@ namespace blink1_lib {
 
     std::optional<int> Blink1Device::clearCache() noexcept {
         if (good()) {
+            std::lock_guard<std::mutex> lock(deviceMutex);
             int cacheIndex = blink1_clearCacheDev(device.get());
             if (cacheIndex != -1) {
                 return cacheIndex;
@@ -217,6 +423,7 @@ namespace blink1_lib {
 
     std::optional<std::string_view> Blink1Device::getSerial() const noexcept {
         if (good()) {
+            std::lock_guard<std::mutex> lock(deviceMutex);
             const char* serial = blink1_getSerialForDev(device.get());
             if (serial != nullptr) {
                 return serial;
@@ -227,6 +434,7 @@ namespace blink1_lib {
 
     std::optional<bool> Blink1Device::isMk2() const noexcept {
         if (good()) {
+            std::lock_guard<std::mutex> lock(deviceMutex);
             return 1 == blink1_isMk2(device.get());
         }
         return std::nullopt;
@@ -247,4 +455,234 @@ namespace blink1_lib {
     bool Blink1Device::isBlocking() const noexcept {
         return blocking;
     }
+
+    void Blink1Device::setShadowCache(bool enabled) noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        shadowCacheEnabled = enabled;
+        shadowState.fill(std::nullopt);
+    }
+
+    bool Blink1Device::isShadowCacheEnabled() const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        return shadowCacheEnabled;
+    }
+
+    void Blink1Device::invalidateShadowCache() noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        shadowState.fill(std::nullopt);
+    }
+
+    std::uint64_t Blink1Device::getShadowCacheHits() const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        return shadowCacheHits;
+    }
+
+    std::uint64_t Blink1Device::getShadowCacheMisses() const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        return shadowCacheMisses;
+    }
+
+    void Blink1Device::setMetricsEnabled(bool enabled) {
+        auto newMetrics = enabled ? std::make_unique<DeviceMetrics>() : nullptr;
+
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        if (enabled == (metrics != nullptr)) {
+            return;
+        }
+        metrics = std::move(newMetrics);
+    }
+
+    bool Blink1Device::isMetricsEnabled() const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        return metrics != nullptr;
+    }
+
+    std::optional<DeviceMetrics> Blink1Device::getMetrics() const {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        if (!metrics) {
+            return std::nullopt;
+        }
+        return *metrics;
+    }
+
+    void Blink1Device::resetMetrics() noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        if (metrics) {
+            metrics->reset();
+        }
+    }
+
+    void Blink1Device::setTraceWriter(std::shared_ptr<ChromeTraceWriter> writer) {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        traceSerial.clear();
+        if (writer && good()) {
+            const char* serial = blink1_getSerialForDev(device.get());
+            if (serial != nullptr) {
+                traceSerial = serial;
+            }
+        }
+        tracing = writer != nullptr;
+        traceWriter = std::move(writer);
+    }
+
+    std::shared_ptr<ChromeTraceWriter> Blink1Device::getTraceWriter() const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        return traceWriter;
+    }
+
+    bool Blink1Device::isTracing() const noexcept {
+        return tracing;
+    }
+
+    void Blink1Device::traceSpan(ChromeTraceWriter::Span span) const noexcept {
+        try {
+            std::shared_ptr<ChromeTraceWriter> writer;
+            {
+                std::lock_guard<std::mutex> lock(deviceMutex);
+                if (!traceWriter) {
+                    return;
+                }
+                writer = traceWriter;
+                span.serial = traceSerial;
+            }
+            writer->addSpan(std::move(span));
+        } catch (...) {
+            // Tracing is best effort, see finishOperation()
+        }
+    }
+
+    void Blink1Device::setClock(std::shared_ptr<Clock> _clock) {
+        if (!_clock) {
+            _clock = Clock::steady();
+        }
+
+        std::shared_ptr<FadeTimer> timer;
+        if (_clock != Clock::steady()) {
+            timer = std::make_shared<FadeTimer>(_clock);
+        }
+
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        clock.store(std::move(_clock));
+        fadeTimer.swap(timer);
+    }
+
+    std::shared_ptr<Clock> Blink1Device::getClock() const noexcept {
+        return clock.load();
+    }
+
+    std::chrono::steady_clock::time_point Blink1Device::getFadeDeadline(const std::uint8_t ledn) const noexcept {
+        std::lock_guard<std::mutex> lock(deviceMutex);
+        if (ledn == 0) {
+            return *std::max_element(fadeDeadlines.begin(), fadeDeadlines.end());
+        }
+        return fadeDeadlines[ledn];
+    }
+
+    void Blink1Device::waitForFade(const std::uint8_t ledn) const noexcept {
+        const auto deadline = getFadeDeadline(ledn);
+        getClock()->sleepUntil(deadline);
+    }
+
+    bool Blink1Device::waitForFade(const std::uint8_t ledn, const std::chrono::milliseconds timeout) const noexcept {
+        const auto deadline = getFadeDeadline(ledn);
+        const auto deviceClock = getClock();
+        if (deadline - deviceClock->now() > timeout) {
+            deviceClock->sleepFor(timeout);
+            return false;
+        }
+        deviceClock->sleepUntil(deadline);
+        return true;
+    }
+
+    std::future<void> Blink1Device::whenFadeComplete(const std::uint8_t ledn) const {
+        auto promise = std::make_shared<std::promise<void>>();
+        auto future = promise->get_future();
+        onFadeComplete(ledn, [promise] { promise->set_value(); });
+        return future;
+    }
+
+    void Blink1Device::onFadeComplete(const std::uint8_t ledn, std::function<void()> callback) const {
+        const auto deadline = getFadeDeadline(ledn);
+
+        std::shared_ptr<FadeTimer> timer;
+        {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            timer = fadeTimer;
+        }
+        FadeTimer& target = timer ? *timer : FadeTimer::shared();
+        target.schedule(deadline, std::move(callback));
+    }
+
+    void Blink1Device::updateFadeDeadline(const std::uint8_t ledn, const std::uint16_t fadeMillis) noexcept {
+        const auto deadline = clock.load()->now() + std::chrono::milliseconds(fadeMillis);
+        if (ledn == 0) {
+            fadeDeadlines.fill(deadline);
+        } else {
+            fadeDeadlines[ledn] = deadline;
+        }
+    }
+
+    void Blink1Device::waitIfBlocking(const std::uint8_t ledn) const noexcept {
+        if (blocking) {
+            waitForFade(ledn);
+        }
+    }
+
+    bool Blink1Device::shadowCacheHit(const std::uint8_t ledn, const PatternLine& line) noexcept {
+        if (!shadowCacheEnabled) {
+            return false;
+        }
+
+        if (shadowState[ledn] == line) {
+            ++shadowCacheHits;
+            return true;
+        }
+        ++shadowCacheMisses;
+        return false;
+    }
+
+    void Blink1Device::updateShadowCache(const std::uint8_t ledn, const std::optional<PatternLine>& line) noexcept {
+        if (!shadowCacheEnabled) {
+            return;
+        }
+
+        if (ledn == 0) {
+            shadowState.fill(line);
+        } else {
+            shadowState[ledn] = line;
+            shadowState[0] = std::nullopt;
+        }
+    }
+
+    Clock::time_point Blink1Device::startOperation() const noexcept {
+        return (metrics || traceWriter) ? clock.load()->now() : Clock::time_point();
+    }
+
+    void Blink1Device::finishOperation(const DeviceMetrics::OPERATION operation, const Clock::time_point start, const bool success,
+                                       const std::optional<std::uint8_t> ledn, const std::optional<std::uint16_t> fadeMillis) const noexcept {
+        lastCommandSucceeded.store(success, std::memory_order_relaxed);
+        if (!metrics && !traceWriter) {
+            return;
+        }
+
+        const auto end = clock.load()->now();
+        if (metrics) {
+            metrics->record(operation, success, end - start);
+        }
+        if (traceWriter) {
+            try {
+                // Operation names are short enough to stay in the string's inline buffer
+                std::string name(DeviceMetrics::getOperationName(operation));
+                traceWriter->addSpan({std::move(name), "usb", traceSerial, start, end, ledn, fadeMillis, success, false});
+
+                // The fade itself, which later commands to the device can overlap
+                const bool isFade = operation == DeviceMetrics::OPERATION::FADE_TO_RGB || operation == DeviceMetrics::OPERATION::FADE_TO_RGBN;
+                if (isFade && success && fadeMillis.value_or(0) > 0) {
+                    traceWriter->addSpan({"fade", "fade", traceSerial, end, end + std::chrono::milliseconds(*fadeMillis), ledn, fadeMillis, true, true});
+                }
+            } catch (...) {
+                // Tracing is best effort, so a span that can't be stored is dropped
+            }
+        }
+    }
 }
@@ -0,0 +1,154 @@
+#include "Blink1DeviceManager.hpp"
+
+#include <algorithm>
+#include <future>
+
+namespace blink1_lib {
+    Blink1DeviceManager::Blink1DeviceManager() {
+        enumerate();
+    }
+
+    void Blink1DeviceManager::enumerate() {
+        const int count = blink1_enumerate();
+
+        std::unordered_map<std::string, DeviceInfo> found;
+        for (int i = 0; i < count; ++i) {
+            const char* serial = blink1_getCachedSerial(i);
+            const char* path = blink1_getCachedPath(i);
+            if (serial != nullptr && path != nullptr) {
+                found[serial] = DeviceInfo{serial, path, static_cast<std::uint32_t>(i)};
+            }
+        }
+
+        for (auto it = openDevices.begin(); it != openDevices.end();) {
+            auto device = found.find(it->first);
+            if (device == found.end() || device->second.path != devicesBySerial.at(it->first).path) {
+                it = openDevices.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        devicesBySerial = std::move(found);
+    }
+
+    std::shared_ptr<Blink1Device> Blink1DeviceManager::getOpen(const std::string& serial) const {
+        auto it = openDevices.find(serial);
+        if (it != openDevices.end() && !isStale(*it->second)) {
+            return it->second;
+        }
+        return nullptr;
+    }
+
+    bool Blink1DeviceManager::isStale(const Blink1Device& device) noexcept {
+        // good() stays true once the device is opened, so a failed command is the only sign it was unplugged
+        return !device.good() || !device.isResponding();
+    }
+
+    std::size_t Blink1DeviceManager::refresh() {
+        std::lock_guard<std::mutex> lock(mutex);
+        enumerate();
+        return devicesBySerial.size();
+    }
+
+    std::size_t Blink1DeviceManager::deviceCount() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return devicesBySerial.size();
+    }
+
+    std::vector<std::string> Blink1DeviceManager::getSerials() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::pair<std::uint32_t, std::string>> serials;
+        serials.reserve(devicesBySerial.size());
+        for (const auto& [serial, info] : devicesBySerial) {
+            serials.emplace_back(info.id, serial);
+        }
+        std::sort(serials.begin(), serials.end());
+
+        std::vector<std::string> result;
+        result.reserve(serials.size());
+        for (auto& entry : serials) {
+            result.push_back(std::move(entry.second));
+        }
+        return result;
+    }
+
+    std::optional<Blink1DeviceManager::DeviceInfo> Blink1DeviceManager::find(const std::string& serial) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = devicesBySerial.find(serial);
+        if (it != devicesBySerial.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    std::shared_ptr<Blink1Device> Blink1DeviceManager::get(const std::string& serial) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool enumerated = false;
+        auto cached = openDevices.find(serial);
+        if (cached != openDevices.end()) {
+            if (!isStale(*cached->second)) {
+                return cached->second;
+            }
+
+            // The device may have been unplugged, or plugged back in at another path
+            openDevices.erase(cached);
+            enumerate();
+            enumerated = true;
+        }
+
+        auto info = devicesBySerial.find(serial);
+        if (info == devicesBySerial.end() && !enumerated) {
+            enumerate();
+            info = devicesBySerial.find(serial);
+        }
+        if (info == devicesBySerial.end()) {
+            return nullptr;
+        }
+
+        auto device = std::make_shared<Blink1Device>(info->second.path, Blink1Device::STRING_INIT_TYPE::PATH);
+        if (!device->good()) {
+            return nullptr;
+        }
+        openDevices[serial] = device;
+        return device;
+    }
+
+    std::vector<std::shared_ptr<Blink1Device>> Blink1DeviceManager::openAll() {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::vector<std::pair<std::string, std::future<std::shared_ptr<Blink1Device>>>> opening;
+        for (const auto& [serial, info] : devicesBySerial) {
+            if (!getOpen(serial)) {
+                opening.emplace_back(serial, std::async(std::launch::async, [path = info.path] {
+                    return std::make_shared<Blink1Device>(path, Blink1Device::STRING_INIT_TYPE::PATH);
+                }));
+            }
+        }
+        for (auto& [serial, device] : opening) {
+            auto opened = device.get();
+            if (opened->good()) {
+                openDevices[serial] = std::move(opened);
+            } else {
+                openDevices.erase(serial);
+            }
+        }
+
+        std::vector<std::pair<std::uint32_t, std::shared_ptr<Blink1Device>>> devices;
+        for (const auto& [serial, device] : openDevices) {
+            devices.emplace_back(devicesBySerial.at(serial).id, device);
+        }
+        std::sort(devices.begin(), devices.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<std::shared_ptr<Blink1Device>> result;
+        result.reserve(devices.size());
+        for (auto& entry : devices) {
+            result.push_back(std::move(entry.second));
+        }
+        return result;
+    }
+
+    void Blink1DeviceManager::close(const std::string& serial) {
+        std::lock_guard<std::mutex> lock(mutex);
+        openDevices.erase(serial);
+    }
+}
@@ -1,6 +1,10 @@
 #include <vector>
 #include <algorithm>
-#include <map>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <unordered_map>
 
 #if __has_include("gtest/gtest.h")
     #include "gtest/gtest.h"
@@ -30,41 +34,234 @@
 
 using namespace blink1_lib;
 
-std::vector<blink1_device*> fake_blink1_lib::blink1_devices;
-std::map<long, RGB> fake_blink1_lib::ledColors;
-std::map<long, uint16_t> fake_blink1_lib::ledFadeMillis;
-std::map<long, PatternLineN> fake_blink1_lib::patternLines;
-int fake_blink1_lib::cacheIndex = 0;
-std::string fake_blink1_lib::serial;
-bool fake_blink1_lib::isMk2;
-uint8_t fake_blink1_lib::patternLineLEDN = 0;
-PlayState fake_blink1_lib::playState;
-int fake_blink1_lib::blink1Version = 0;
-bool fake_blink1_lib::successfulOperation = false;
-bool fake_blink1_lib::successfulInit = false;
-bool fake_blink1_lib::degammaEnabled = false;
-int fake_blink1_lib::vid = 0;
-int fake_blink1_lib::pid = 0;
+std::unordered_set<blink1_device*> fake_blink1_lib::blink1_devices;
+std::shared_ptr<fake_blink1_lib::SimulatedDevice> fake_blink1_lib::defaultDevice = std::make_shared<SimulatedDevice>();
+std::vector<std::shared_ptr<fake_blink1_lib::SimulatedDevice>> fake_blink1_lib::simulatedDevices;
+std::atomic<int> fake_blink1_lib::enumerateCount = 0;
+std::atomic<int> fake_blink1_lib::cacheIndex = 0;
+std::atomic<bool> fake_blink1_lib::isMk2 = false;
+std::atomic<int> fake_blink1_lib::blink1Version = 0;
+std::atomic<bool> fake_blink1_lib::successfulOperation = false;
+std::atomic<bool> fake_blink1_lib::successfulInit = false;
+std::atomic<bool> fake_blink1_lib::degammaEnabled = false;
+std::atomic<int> fake_blink1_lib::vid = 0;
+std::atomic<int> fake_blink1_lib::pid = 0;
+
+// Devices may be opened and closed from several threads at once, e.g. by Blink1DeviceManager::openAll()
+static std::mutex devicesMutex;
+
+// Guards defaultDevice, simulatedDevices and the indexes into it
+static std::mutex simulatedDevicesMutex;
+
+// Indexes into simulatedDevices so that devices can be opened in constant time
+static std::unordered_map<std::string, std::shared_ptr<fake_blink1_lib::SimulatedDevice>> simulatedDevicesBySerial;
+static std::unordered_map<std::string, std::shared_ptr<fake_blink1_lib::SimulatedDevice>> simulatedDevicesByPath;
+
+static bool validIndex(const long n) {
+    return 0 <= n && n <= UINT8_MAX;
+}
+
+static std::size_t toIndex(const long n) {
+    return static_cast<std::size_t>(n);
+}
+
+static fake_blink1_lib::SimulatedDevice& simulated(blink1_device* dev) {
+    return *dev->simulated;
+}
+
+static std::shared_ptr<fake_blink1_lib::SimulatedDevice> getDefaultDevice() {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    return fake_blink1_lib::defaultDevice;
+}
+
+// Looks up an added device for the functions that take a serial, reporting a failure if there isn't one
+static std::shared_ptr<fake_blink1_lib::SimulatedDevice> simulatedBySerial(const std::string& serial) {
+    auto device = fake_blink1_lib::GET_SIMULATED_DEVICE(serial);
+    if (!device) {
+        ADD_FAILURE() << "No simulated device with serial " << serial << " has been added.";
+        return getDefaultDevice();
+    }
+    return device;
+}
+
+/****************
+ * TIMING MODEL *
+ ****************/
+
+enum class TRANSFER_TYPE {
+    READ,
+    WRITE
+};
+
+static std::mutex timingMutex;
+static fake_blink1_lib::TimingModel timingModel;
+static std::mt19937 latencyGenerator;
+static std::shared_ptr<blink1_lib::Clock> simulationClock = blink1_lib::Clock::steady();
+
+static std::shared_ptr<blink1_lib::Clock> currentClock() {
+    std::lock_guard<std::mutex> lock(timingMutex);
+    return simulationClock;
+}
+
+static bool interpolatingFades() {
+    std::lock_guard<std::mutex> lock(timingMutex);
+    return timingModel.interpolateFades;
+}
+
+// Must be called with timingMutex held
+static std::chrono::microseconds sampleLatency() {
+    const auto latency = timingModel.latency.count();
+    const auto jitter = timingModel.jitter.count();
+    if (jitter <= 0) {
+        // Neither distribution is defined without a positive spread
+        return timingModel.latency;
+    }
+
+    switch (timingModel.distribution) {
+        case fake_blink1_lib::LATENCY_DISTRIBUTION::UNIFORM: {
+            std::uniform_int_distribution<long long> distribution(latency - jitter, latency + jitter);
+            return std::chrono::microseconds(std::max(0LL, distribution(latencyGenerator)));
+        }
+        case fake_blink1_lib::LATENCY_DISTRIBUTION::NORMAL: {
+            std::normal_distribution<double> distribution(static_cast<double>(latency), static_cast<double>(jitter));
+            return std::chrono::microseconds(std::llround(std::max(0.0, distribution(latencyGenerator))));
+        }
+        case fake_blink1_lib::LATENCY_DISTRIBUTION::CONSTANT:
+        default:
+            return timingModel.latency;
+    }
+}
+
+// Blocks for as long as the timing model says a call to the device takes
+static void simulateTransfer(blink1_device* dev, const TRANSFER_TYPE type) {
+    std::chrono::steady_clock::time_point doneTime;
+    std::shared_ptr<blink1_lib::Clock> transferClock;
+    {
+        std::lock_guard<std::mutex> lock(timingMutex);
+        if (timingModel.latency.count() == 0 && timingModel.jitter.count() == 0 && timingModel.maxWritesPerSecond <= 0) {
+            return;
+        }
+
+        transferClock = simulationClock;
+        auto sendTime = simulationClock->now();
+        if (type == TRANSFER_TYPE::WRITE && timingModel.maxWritesPerSecond > 0 && dev != nullptr) {
+            auto& nextWriteTime = simulated(dev).nextWriteTime;
+            sendTime = std::max(sendTime, nextWriteTime);
+            nextWriteTime = sendTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(1.0 / timingModel.maxWritesPerSecond));
+        }
+        doneTime = sendTime + sampleLatency();
+    }
+    transferClock->sleepUntil(doneTime);
+}
+
+static RGB interpolate(const RGB& from, const RGB& to, const double fraction) {
+    auto channel = [fraction](std::uint8_t a, std::uint8_t b) {
+        return static_cast<std::uint8_t>(std::lround(a + (b - a) * fraction));
+    };
+    return RGB(channel(from.r, to.r), channel(from.g, to.g), channel(from.b, to.b));
+}
+
+static RGB displayedColor(const fake_blink1_lib::SimulatedDevice& device, const long n, const RGB& target, const std::chrono::steady_clock::time_point now) {
+    const auto& fadeStart = device.ledFadeStarts[toIndex(n)];
+    const auto& fadeMillis = device.ledFadeMillis[toIndex(n)];
+    if (!fadeStart || !fadeMillis || *fadeMillis == 0) {
+        return target;
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = now - fadeStart->time;
+    const double fraction = elapsed.count() / *fadeMillis;
+    if (fraction >= 1.0) {
+        return target;
+    }
+    return interpolate(fadeStart->from, target, std::max(0.0, fraction));
+}
+
+// Records the color LED n is showing as the start of a new fade. Must be called with the device's mutex held.
+static void startFade(fake_blink1_lib::SimulatedDevice& device, const long n, const std::chrono::steady_clock::time_point now) {
+    const auto& color = device.ledColors[toIndex(n)];
+    if (color) {
+        device.ledFadeStarts[toIndex(n)] = fake_blink1_lib::FadeStart{displayedColor(device, n, *color, now), now};
+    } else {
+        device.ledFadeStarts[toIndex(n)] = std::nullopt;
+    }
+}
+
+static std::mutex faultMutex;
+static fake_blink1_lib::FaultModel faultModel;
+static std::mt19937 faultGenerator;
+static std::uint64_t callCount = 0;
+static std::uint64_t injectedFaultCount = 0;
+
+// Counts a call against the fault model and returns whether the model makes it fail
+static bool injectFault(const fake_blink1_lib::BLINK1_FUNCTION function) {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    ++callCount;
+
+    bool fail = faultModel.failingFunctions.contains(function) || (faultModel.failAfterCalls != 0 && callCount > faultModel.failAfterCalls);
+    if (!fail && faultModel.failureProbability > 0) {
+        std::bernoulli_distribution distribution(std::min(1.0, faultModel.failureProbability));
+        fail = distribution(faultGenerator);
+    }
+
+    if (fail) {
+        ++injectedFaultCount;
+    }
+    return fail;
+}
+
+static bool callSucceeds(blink1_device* dev, const fake_blink1_lib::BLINK1_FUNCTION function) {
+    return fake_blink1_lib::SUCCESS(dev) && !injectFault(function);
+}
+
+static void setConnected(fake_blink1_lib::SimulatedDevice& device, const bool connected) {
+    if (!connected && device.connected) {
+        // Invalidates every handle opened before now
+        ++device.connection;
+    }
+    device.connected = connected;
+}
+
 /*********************
  * METHODS FOR TESTS *
  *********************/
 
 void fake_blink1_lib::CLEAR_ALL() {
-    for (auto it = blink1_devices.begin(); it != blink1_devices.end(); ++it) {
-        blink1_device* device = *it;
-        it = blink1_devices.erase(it);
-        delete device;
+    {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        for (blink1_device* device : blink1_devices) {
+            delete device;
+        }
+        blink1_devices.clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+        defaultDevice = std::make_shared<SimulatedDevice>();
+        simulatedDevices.clear();
+        simulatedDevicesBySerial.clear();
+        simulatedDevicesByPath.clear();
     }
 
-    ledColors.clear();
-    ledFadeMillis.clear();
-    patternLines.clear();
+    enumerateCount = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(timingMutex);
+        timingModel = TimingModel();
+        latencyGenerator.seed(timingModel.seed);
+        simulationClock = blink1_lib::Clock::steady();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(faultMutex);
+        faultModel = FaultModel();
+        faultGenerator.seed(faultModel.seed);
+        callCount = 0;
+        injectedFaultCount = 0;
+    }
 
     cacheIndex = 0;
-    serial = "";
     isMk2 = false;
-    patternLineLEDN = 0;
-    playState = PlayState();
     blink1Version = 0;
     successfulOperation = false;
     successfulInit = false;
@@ -74,6 +271,7 @@ void fake_blink1_lib::CLEAR_ALL() {
 }
 
 bool fake_blink1_lib::ALL_DEVICES_FREED() {
+    std::lock_guard<std::mutex> lock(devicesMutex);
     return blink1_devices.size() == 0;
 }
 
@@ -102,92 +300,335 @@ void fake_blink1_lib::SET_CACHE_INDEX(int index) {
 }
 
 void fake_blink1_lib::SET_SERIAL(std::string _serial) {
-    serial = _serial;
+    getDefaultDevice()->serial = std::move(_serial);
 }
 
 void fake_blink1_lib::SET_IS_MK2(bool mk2) {
     isMk2 = mk2;
 }
 
+void fake_blink1_lib::ADD_DEVICE(std::string _serial, std::string path) {
+    auto device = std::make_shared<SimulatedDevice>();
+    device->serial = std::move(_serial);
+    device->path = std::move(path);
+
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    simulatedDevicesBySerial[device->serial] = device;
+    simulatedDevicesByPath[device->path] = device;
+    simulatedDevices.push_back(std::move(device));
+}
+
+void fake_blink1_lib::REMOVE_DEVICE(const std::string& _serial) {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    const auto device = simulatedDevicesBySerial.find(_serial);
+    if (device == simulatedDevicesBySerial.end()) {
+        return;
+    }
+
+    simulatedDevicesByPath.erase(device->second->path);
+    std::erase(simulatedDevices, device->second);
+    simulatedDevicesBySerial.erase(device);
+}
+
+void fake_blink1_lib::DISCONNECT() {
+    setConnected(*getDefaultDevice(), false);
+}
+
+void fake_blink1_lib::DISCONNECT(const std::string& _serial) {
+    setConnected(*simulatedBySerial(_serial), false);
+}
+
+void fake_blink1_lib::RECONNECT() {
+    setConnected(*getDefaultDevice(), true);
+}
+
+void fake_blink1_lib::RECONNECT(const std::string& _serial) {
+    setConnected(*simulatedBySerial(_serial), true);
+}
+
+std::shared_ptr<fake_blink1_lib::SimulatedDevice> fake_blink1_lib::GET_SIMULATED_DEVICE(const std::string& _serial) {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    const auto device = simulatedDevicesBySerial.find(_serial);
+    if (device == simulatedDevicesBySerial.end()) {
+        return nullptr;
+    }
+    return device->second;
+}
+
+int fake_blink1_lib::GET_ENUMERATE_COUNT() {
+    return enumerateCount;
+}
+
+void fake_blink1_lib::SET_TIMING_MODEL(const TimingModel& model) {
+    std::lock_guard<std::mutex> lock(timingMutex);
+    timingModel = model;
+    latencyGenerator.seed(model.seed);
+}
+
+fake_blink1_lib::TimingModel fake_blink1_lib::GET_TIMING_MODEL() {
+    std::lock_guard<std::mutex> lock(timingMutex);
+    return timingModel;
+}
+
+void fake_blink1_lib::SET_CLOCK(std::shared_ptr<blink1_lib::Clock> _clock) {
+    std::lock_guard<std::mutex> lock(timingMutex);
+    simulationClock = _clock ? std::move(_clock) : blink1_lib::Clock::steady();
+}
+
+std::shared_ptr<blink1_lib::Clock> fake_blink1_lib::GET_CLOCK() {
+    return currentClock();
+}
+
+void fake_blink1_lib::SET_FAULT_MODEL(const FaultModel& model) {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    faultModel = model;
+    faultGenerator.seed(model.seed);
+    callCount = 0;
+    injectedFaultCount = 0;
+}
+
+fake_blink1_lib::FaultModel fake_blink1_lib::GET_FAULT_MODEL() {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    return faultModel;
+}
+
+std::uint64_t fake_blink1_lib::GET_CALL_COUNT() {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    return callCount;
+}
+
+std::uint64_t fake_blink1_lib::GET_INJECTED_FAULT_COUNT() {
+    std::lock_guard<std::mutex> lock(faultMutex);
+    return injectedFaultCount;
+}
+
 bool fake_blink1_lib::SUCCESS(blink1_device* dev) {
-    return successfulOperation && dev != nullptr;
+    return successfulOperation && dev != nullptr && dev->simulated->connected && dev->connection == dev->simulated->connection;
 }
 
-RGB fake_blink1_lib::GET_RGB(long n) {
-    if (ledColors.find(n) == ledColors.end()) {
+static RGB getRGB(const fake_blink1_lib::SimulatedDevice& device, long n) {
+    if (!validIndex(n) || !device.ledColors[toIndex(n)]) {
         ADD_FAILURE() << "LED color " << n << " has not yet been initialized.";
         return RGB();
     }
-    return ledColors.at(n);
+    return *device.ledColors[toIndex(n)];
 }
 
-void fake_blink1_lib::SET_RGB(RGB rgb, long n) {
-    ledColors[n] = rgb;
+static RGB getDisplayedRGB(const fake_blink1_lib::SimulatedDevice& device, long n) {
+    const RGB target = getRGB(device, n);
+    if (!validIndex(n) || !interpolatingFades()) {
+        return target;
+    }
+    return displayedColor(device, n, target, currentClock()->now());
 }
 
-uint16_t fake_blink1_lib::GET_FADE_MILLIS(long n) {
-    if (ledFadeMillis.find(n) == ledFadeMillis.end()) {
+static void setRGB(fake_blink1_lib::SimulatedDevice& device, RGB rgb, long n) {
+    if (!validIndex(n)) {
+        ADD_FAILURE() << "LED " << n << " does not exist.";
+        return;
+    }
+    device.ledColors[toIndex(n)] = rgb;
+    device.ledFadeStarts[toIndex(n)] = std::nullopt;
+}
+
+static uint16_t getFadeMillis(const fake_blink1_lib::SimulatedDevice& device, long n) {
+    if (!validIndex(n) || !device.ledFadeMillis[toIndex(n)]) {
         ADD_FAILURE() << "LED fade millis " << n << " has not yet been initialized.";
         return 0;
     }
-    return ledFadeMillis.at(n);
+    return *device.ledFadeMillis[toIndex(n)];
+}
+
+static PatternLineN getPatternLine(const fake_blink1_lib::SimulatedDevice& device, long pos) {
+    if (!validIndex(pos) || !device.patternLines[toIndex(pos)]) {
+        EXPECT_TRUE(false) << "Pattern Line " << pos << " has not yet been initialized.";
+        return PatternLineN();
+    }
+    return *device.patternLines[toIndex(pos)];
+}
+
+RGB fake_blink1_lib::GET_RGB(long n) {
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getRGB(*device, n);
+}
+
+RGB fake_blink1_lib::GET_RGB(const std::string& _serial, long n) {
+    const auto device = simulatedBySerial(_serial);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getRGB(*device, n);
+}
+
+void fake_blink1_lib::SET_RGB(RGB rgb, long n) {
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    setRGB(*device, rgb, n);
+}
+
+void fake_blink1_lib::SET_RGB(const std::string& _serial, RGB rgb, long n) {
+    const auto device = simulatedBySerial(_serial);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    setRGB(*device, rgb, n);
+}
+
+RGB fake_blink1_lib::GET_DISPLAYED_RGB(long n) {
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getDisplayedRGB(*device, n);
+}
+
+RGB fake_blink1_lib::GET_DISPLAYED_RGB(const std::string& _serial, long n) {
+    const auto device = simulatedBySerial(_serial);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getDisplayedRGB(*device, n);
+}
+
+uint16_t fake_blink1_lib::GET_FADE_MILLIS(long n) {
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getFadeMillis(*device, n);
+}
+
+uint16_t fake_blink1_lib::GET_FADE_MILLIS(const std::string& _serial, long n) {
+    const auto device = simulatedBySerial(_serial);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getFadeMillis(*device, n);
 }
 
 void fake_blink1_lib::SET_FADE_MILLIS(uint16_t fadeMillis, long n) {
-    ledFadeMillis[n] = fadeMillis;
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    if (!validIndex(n)) {
+        ADD_FAILURE() << "LED " << n << " does not exist.";
+        return;
+    }
+    device->ledFadeMillis[toIndex(n)] = fadeMillis;
 }
 
 PatternLineN fake_blink1_lib::GET_PATTERN_LINE(long pos) {
-    if (patternLines.find(pos) == patternLines.end()) {
-        EXPECT_TRUE(false) << "Pattern Line " << pos << " has not yet been initialized.";
-        return PatternLineN();
-    }
-    return patternLines.at(pos);
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getPatternLine(*device, pos);
+}
+
+PatternLineN fake_blink1_lib::GET_PATTERN_LINE(const std::string& _serial, long pos) {
+    const auto device = simulatedBySerial(_serial);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return getPatternLine(*device, pos);
 }
 
 void fake_blink1_lib::SET_PATTERN_LINE(PatternLineN line, long pos) {
-    patternLines[pos] = line;
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    if (!validIndex(pos)) {
+        ADD_FAILURE() << "Pattern line " << pos << " does not exist.";
+        return;
+    }
+    device->patternLines[toIndex(pos)] = line;
 }
 
 PlayState fake_blink1_lib::GET_PLAY_STATE() {
-    return playState;
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return device->playState;
+}
+
+PlayState fake_blink1_lib::GET_PLAY_STATE(const std::string& _serial) {
+    const auto device = simulatedBySerial(_serial);
+    std::lock_guard<std::mutex> lock(device->mutex);
+    return device->playState;
 }
 
 void fake_blink1_lib::SET_PLAY_STATE(PlayState state) {
-    playState = state;
+    const auto device = getDefaultDevice();
+    std::lock_guard<std::mutex> lock(device->mutex);
+    device->playState = state;
 }
 
 /******************
  * MOCKED METHODS *
  ******************/
-
-blink1_device* blink1_open() {
-    if (fake_blink1_lib::successfulInit) {
-        blink1_device* newDevice = new blink1_device();
-        fake_blink1_lib::blink1_devices.push_back(newDevice);
+static blink1_device* openSimulated(std::shared_ptr<fake_blink1_lib::SimulatedDevice> device) {
+    if (fake_blink1_lib::successfulInit && device && device->connected) {
+        const std::uint64_t connection = device->connection;
+        blink1_device* newDevice = new blink1_device{std::move(device), connection};
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        fake_blink1_lib::blink1_devices.insert(newDevice);
         return newDevice;
     } else {
         return nullptr;
     }
 }
 
-blink1_device* blink1_openByPath([[maybe_unused]] const char* path) {
-    return blink1_open();
+// Until any devices are added, every way of opening a device opens the default one
+static std::shared_ptr<fake_blink1_lib::SimulatedDevice> findSimulated(const std::unordered_map<std::string, std::shared_ptr<fake_blink1_lib::SimulatedDevice>>& index, const char* key) {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    if (fake_blink1_lib::simulatedDevices.empty()) {
+        return fake_blink1_lib::defaultDevice;
+    }
+
+    const auto device = index.find(key);
+    if (device == index.end()) {
+        return nullptr;
+    }
+    return device->second;
+}
+
+blink1_device* blink1_open() {
+    return openSimulated(getDefaultDevice());
+}
+
+blink1_device* blink1_openByPath(const char* path) {
+    return openSimulated(findSimulated(simulatedDevicesByPath, path));
+}
+
+blink1_device* blink1_openBySerial(const char* serial) {
+    return openSimulated(findSimulated(simulatedDevicesBySerial, serial));
+}
+
+blink1_device* blink1_openById(uint32_t id) {
+    std::shared_ptr<fake_blink1_lib::SimulatedDevice> device;
+    {
+        std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+        if (fake_blink1_lib::simulatedDevices.empty()) {
+            device = fake_blink1_lib::defaultDevice;
+        } else if (id < fake_blink1_lib::simulatedDevices.size()) {
+            device = fake_blink1_lib::simulatedDevices[id];
+        }
+    }
+    return openSimulated(std::move(device));
+}
+
+int blink1_enumerate() {
+    ++fake_blink1_lib::enumerateCount;
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    return static_cast<int>(fake_blink1_lib::simulatedDevices.size());
 }
 
-blink1_device* blink1_openBySerial([[maybe_unused]] const char* serial) {
-    return blink1_open();
+int blink1_getCachedCount() {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    return static_cast<int>(fake_blink1_lib::simulatedDevices.size());
 }
 
-blink1_device* blink1_openById([[maybe_unused]] uint32_t id) {
-    return blink1_open();
+const char* blink1_getCachedPath(int i) {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    if (i < 0 || static_cast<std::size_t>(i) >= fake_blink1_lib::simulatedDevices.size()) {
+        return nullptr;
+    }
+    return fake_blink1_lib::simulatedDevices[static_cast<std::size_t>(i)]->path.c_str();
+}
+
+const char* blink1_getCachedSerial(int i) {
+    std::lock_guard<std::mutex> lock(simulatedDevicesMutex);
+    if (i < 0 || static_cast<std::size_t>(i) >= fake_blink1_lib::simulatedDevices.size()) {
+        return nullptr;
+    }
+    return fake_blink1_lib::simulatedDevices[static_cast<std::size_t>(i)]->serial.c_str();
 }
 
 void blink1_close_internal(blink1_device* dev) {
-    auto loc = std::find(fake_blink1_lib::blink1_devices.begin(), fake_blink1_lib::blink1_devices.end(), dev);
-    if (loc != fake_blink1_lib::blink1_devices.end()) {
-        fake_blink1_lib::blink1_devices.erase(loc);
-    } else {
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    if (fake_blink1_lib::blink1_devices.erase(dev) == 0) {
         ADD_FAILURE() << "Tried to delete device that was never allocated: " << dev;
     }
 
@@ -195,8 +636,9 @@ void blink1_close_internal(blink1_device* dev) {
 }
 
 int blink1_getVersion(blink1_device* dev) {
-    auto loc = std::find(fake_blink1_lib::blink1_devices.begin(), fake_blink1_lib::blink1_devices.end(), dev);
-    if (loc != fake_blink1_lib::blink1_devices.end()) {
+    simulateTransfer(dev, TRANSFER_TYPE::READ);
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    if (fake_blink1_lib::blink1_devices.contains(dev)) {
         return fake_blink1_lib::blink1Version;
     } else {
         //TODO docs don't specify failure case, just that device must be initialized
@@ -206,17 +648,31 @@ int blink1_getVersion(blink1_device* dev) {
 }
 
 // This does LED 0 which actually sets all LEDs
-// Does LED 0 first to make sure that it gets created in the map
+// Does LED 0 first to make sure that it is initialized
 int blink1_fadeToRGB(blink1_device* dev, uint16_t fadeMillis, uint8_t r, uint8_t g, uint8_t b) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::ledFadeMillis[0] = fadeMillis;
-        fake_blink1_lib::ledColors[0] = RGB(r, g, b);
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::FADE_TO_RGB)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        auto& device = simulated(dev);
+        if (interpolatingFades()) {
+            const auto now = currentClock()->now();
+            for (long n = 0; n <= UINT8_MAX; ++n) {
+                startFade(device, n, now);
+            }
+        }
 
-        for (auto i = fake_blink1_lib::ledFadeMillis.begin(); i != fake_blink1_lib::ledFadeMillis.end(); ++i) {
-            i->second = fadeMillis;
+        device.ledFadeMillis[0] = fadeMillis;
+        device.ledColors[0] = RGB(r, g, b);
+
+        for (auto& ledFadeMillis : device.ledFadeMillis) {
+            if (ledFadeMillis) {
+                ledFadeMillis = fadeMillis;
+            }
         }
-        for (auto i = fake_blink1_lib::ledColors.begin(); i != fake_blink1_lib::ledColors.end(); ++i) {
-            i->second = RGB(r, g, b);
+        for (auto& ledColor : device.ledColors) {
+            if (ledColor) {
+                ledColor = RGB(r, g, b);
+            }
         }
         return 0;
     } else {
@@ -225,9 +681,16 @@ int blink1_fadeToRGB(blink1_device* dev, uint16_t fadeMillis, uint8_t r, uint8_t
 }
 
 int blink1_fadeToRGBN(blink1_device* dev, uint16_t fadeMillis, uint8_t r, uint8_t g, uint8_t b, uint8_t n) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::ledFadeMillis[n] = fadeMillis;
-        fake_blink1_lib::ledColors[n] = RGB(r, g, b);
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::FADE_TO_RGBN)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        auto& device = simulated(dev);
+        if (interpolatingFades()) {
+            startFade(device, n, currentClock()->now());
+        }
+
+        device.ledFadeMillis[n] = fadeMillis;
+        device.ledColors[n] = RGB(r, g, b);
         return 0;
     } else {
         return -1;
@@ -235,10 +698,16 @@ int blink1_fadeToRGBN(blink1_device* dev, uint16_t fadeMillis, uint8_t r, uint8_
 }
 
 int blink1_setRGB(blink1_device* dev, uint8_t r, uint8_t g, uint8_t b) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::ledColors[0] = RGB(r, g, b);
-        for (auto i = fake_blink1_lib::ledColors.begin(); i != fake_blink1_lib::ledColors.end(); ++i) {
-            i->second = RGB(r, g, b);
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::SET_RGB)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        auto& device = simulated(dev);
+        device.ledFadeStarts.fill(std::nullopt);
+        device.ledColors[0] = RGB(r, g, b);
+        for (auto& ledColor : device.ledColors) {
+            if (ledColor) {
+                ledColor = RGB(r, g, b);
+            }
         }
         return 0;
     } else {
@@ -247,9 +716,12 @@ int blink1_setRGB(blink1_device* dev, uint8_t r, uint8_t g, uint8_t b) {
 }
 
 int blink1_readRGB(blink1_device* dev, uint16_t* fadeMillis, uint8_t* r, uint8_t* g, uint8_t* b, uint8_t ledn) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        RGB ledRgb = fake_blink1_lib::GET_RGB(ledn);
-        *fadeMillis = fake_blink1_lib::GET_FADE_MILLIS(ledn);
+    simulateTransfer(dev, TRANSFER_TYPE::READ);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::READ_RGB)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        const auto& device = simulated(dev);
+        RGB ledRgb = getDisplayedRGB(device, ledn);
+        *fadeMillis = getFadeMillis(device, ledn);
         *r = ledRgb.r;
         *g = ledRgb.g;
         *b = ledRgb.b;
@@ -260,10 +732,13 @@ int blink1_readRGB(blink1_device* dev, uint16_t* fadeMillis, uint8_t* r, uint8_t
 }
 
 int blink1_play(blink1_device* dev, uint8_t play, uint8_t pos) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::playState.playing = (play == 1);
-        fake_blink1_lib::playState.playPos = pos;
-        fake_blink1_lib::playState.playEnd = pos;
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::PLAY)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        auto& playState = simulated(dev).playState;
+        playState.playing = (play == 1);
+        playState.playPos = pos;
+        playState.playEnd = pos;
         return 0;
     } else {
         return -1;
@@ -271,11 +746,14 @@ int blink1_play(blink1_device* dev, uint8_t play, uint8_t pos) {
 }
 
 int blink1_playloop(blink1_device* dev, uint8_t play, uint8_t startpos, uint8_t endpos, uint8_t count) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::playState.playing = (play == 1);
-        fake_blink1_lib::playState.playStart = startpos;
-        fake_blink1_lib::playState.playEnd = endpos;
-        fake_blink1_lib::playState.playCount = count;
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::PLAYLOOP)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        auto& playState = simulated(dev).playState;
+        playState.playing = (play == 1);
+        playState.playStart = startpos;
+        playState.playEnd = endpos;
+        playState.playCount = count;
         return 0;
     } else {
         return -1;
@@ -283,12 +761,15 @@ int blink1_playloop(blink1_device* dev, uint8_t play, uint8_t startpos, uint8_t
 }
 
 int blink1_readPlayState(blink1_device* dev, uint8_t* playing, uint8_t* playstart, uint8_t* playend, uint8_t* playcount, uint8_t* playpos) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        *playing = fake_blink1_lib::playState.playing ? 1 : 0;
-        *playstart = fake_blink1_lib::playState.playStart;
-        *playend = fake_blink1_lib::playState.playEnd;
-        *playcount = fake_blink1_lib::playState.playCount;
-        *playpos = fake_blink1_lib::playState.playPos;
+    simulateTransfer(dev, TRANSFER_TYPE::READ);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::READ_PLAY_STATE)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        const auto& playState = simulated(dev).playState;
+        *playing = playState.playing ? 1 : 0;
+        *playstart = playState.playStart;
+        *playend = playState.playEnd;
+        *playcount = playState.playCount;
+        *playpos = playState.playPos;
         return 0;
     } else {
         return -1;
@@ -296,8 +777,11 @@ int blink1_readPlayState(blink1_device* dev, uint8_t* playing, uint8_t* playstar
 }
 
 int blink1_writePatternLine(blink1_device* dev, uint16_t fadeMillis, uint8_t r, uint8_t g, uint8_t b, uint8_t pos) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::patternLines[pos] = PatternLineN(r, g, b, fake_blink1_lib::patternLineLEDN, fadeMillis);
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::WRITE_PATTERN_LINE)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        auto& device = simulated(dev);
+        device.patternLines[pos] = PatternLineN(r, g, b, device.patternLineLEDN, fadeMillis);
         return 0;
     } else {
         return -1;
@@ -305,8 +789,10 @@ int blink1_writePatternLine(blink1_device* dev, uint16_t fadeMillis, uint8_t r,
 }
 
 int blink1_readPatternLine(blink1_device* dev, uint16_t* fadeMillis, uint8_t* r, uint8_t* g, uint8_t* b, uint8_t pos) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        PatternLineN line = fake_blink1_lib::GET_PATTERN_LINE(pos);
+    simulateTransfer(dev, TRANSFER_TYPE::READ);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::READ_PATTERN_LINE)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        PatternLineN line = getPatternLine(simulated(dev), pos);
         *r = line.rgbn.r;
         *g = line.rgbn.g;
         *b = line.rgbn.b;
@@ -318,8 +804,10 @@ int blink1_readPatternLine(blink1_device* dev, uint16_t* fadeMillis, uint8_t* r,
 }
 
 int blink1_readPatternLineN(blink1_device* dev, uint16_t* fadeMillis, uint8_t* r, uint8_t* g, uint8_t* b, uint8_t* ledn, uint8_t pos) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        PatternLineN line = fake_blink1_lib::GET_PATTERN_LINE(pos);
+    simulateTransfer(dev, TRANSFER_TYPE::READ);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::READ_PATTERN_LINE_N)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        PatternLineN line = getPatternLine(simulated(dev), pos);
         *r = line.rgbn.r;
         *g = line.rgbn.g;
         *b = line.rgbn.b;
@@ -332,7 +820,8 @@ int blink1_readPatternLineN(blink1_device* dev, uint16_t* fadeMillis, uint8_t* r
 }
 
 int blink1_savePattern(blink1_device* dev) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::SAVE_PATTERN)) {
         return 0;
     } else {
         return -1;
@@ -340,8 +829,10 @@ int blink1_savePattern(blink1_device* dev) {
 }
 
 int blink1_setLEDN(blink1_device* dev, uint8_t ledn) {
-    if (fake_blink1_lib::SUCCESS(dev)) {
-        fake_blink1_lib::patternLineLEDN = ledn;
+    simulateTransfer(dev, TRANSFER_TYPE::WRITE);
+    if (callSucceeds(dev, fake_blink1_lib::BLINK1_FUNCTION::SET_LEDN)) {
+        std::lock_guard<std::mutex> lock(simulated(dev).mutex);
+        simulated(dev).patternLineLEDN = ledn;
         return 0;
     } else {
         return -1;
@@ -382,7 +873,7 @@ int blink1_clearCacheDev(blink1_device* dev) {
 
 const char* blink1_getSerialForDev(blink1_device* dev) {
     if (fake_blink1_lib::SUCCESS(dev)) {
-        return fake_blink1_lib::serial.c_str();
+        return simulated(dev).serial.c_str();
     } else {
         // TODO ????? - Docs don't specify what happens if it's invalid
         return "";
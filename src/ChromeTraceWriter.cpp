@@ -0,0 +1,160 @@
+#include "ChromeTraceWriter.hpp"
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string_view>
+
+namespace blink1_lib {
+    // Every track lives in one process in the trace
+    static constexpr int TRACE_PID = 1;
+
+    static void writeJsonString(std::ostream& os, const std::string_view value) {
+        os << '"';
+        for (const char c : value) {
+            switch (c) {
+                case '"':  os << "\\\""; break;
+                case '\\': os << "\\\\"; break;
+                case '\n': os << "\\n";  break;
+                case '\r': os << "\\r";  break;
+                case '\t': os << "\\t";  break;
+                default:
+                    if (const auto byte = static_cast<unsigned char>(c); byte < 0x20) {
+                        constexpr std::string_view hex = "0123456789abcdef";
+                        os << "\\u00" << hex[byte >> 4] << hex[byte & 0xF];
+                    } else {
+                        os << c;
+                    }
+                    break;
+            }
+        }
+        os << '"';
+    }
+
+    // Trace-event times are in microseconds
+    static void writeMicros(std::ostream& os, const Clock::duration duration) {
+        std::array<char, 32> buffer{};
+        const double micros = std::chrono::duration<double, std::micro>(duration).count();
+        const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), micros, std::chars_format::fixed, 3);
+        os.write(buffer.data(), result.ptr - buffer.data());
+    }
+
+    static void writeArgs(std::ostream& os, const ChromeTraceWriter::Span& span) {
+        os << "\"args\":{\"serial\":";
+        writeJsonString(os, span.serial);
+        if (span.ledn) {
+            os << ",\"ledn\":" << static_cast<unsigned>(*span.ledn);
+        }
+        if (span.fadeMillis) {
+            os << ",\"fadeMillis\":" << *span.fadeMillis;
+        }
+        os << ",\"success\":" << (span.success ? "true" : "false") << '}';
+    }
+
+    ChromeTraceWriter::ChromeTraceWriter(const std::size_t capacity) : maxSpans(capacity) {}
+
+    bool ChromeTraceWriter::addSpan(Span span) {
+        std::lock_guard<std::mutex> lock(spansMutex);
+        if (spans.size() >= maxSpans) {
+            ++droppedSpans;
+            return false;
+        }
+        spans.push_back(std::move(span));
+        return true;
+    }
+
+    std::vector<ChromeTraceWriter::Span> ChromeTraceWriter::getSpans() const {
+        std::lock_guard<std::mutex> lock(spansMutex);
+        return spans;
+    }
+
+    std::size_t ChromeTraceWriter::size() const {
+        std::lock_guard<std::mutex> lock(spansMutex);
+        return spans.size();
+    }
+
+    std::uint64_t ChromeTraceWriter::getDroppedCount() const {
+        std::lock_guard<std::mutex> lock(spansMutex);
+        return droppedSpans;
+    }
+
+    void ChromeTraceWriter::clear() {
+        std::lock_guard<std::mutex> lock(spansMutex);
+        spans.clear();
+        droppedSpans = 0;
+    }
+
+    void ChromeTraceWriter::write(std::ostream& os) const {
+        const auto currentSpans = getSpans();
+
+        // One track per device, numbered in the order the devices first appear
+        std::map<std::string, int> tracks;
+        for (const Span& span : currentSpans) {
+            tracks.try_emplace(span.serial, static_cast<int>(tracks.size()) + 1);
+        }
+
+        os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        auto beginEvent = [&os, &first]() {
+            os << (first ? "\n" : ",\n");
+            first = false;
+        };
+
+        for (const auto& [serial, track] : tracks) {
+            beginEvent();
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << TRACE_PID << ",\"tid\":" << track << ",\"args\":{\"name\":";
+            writeJsonString(os, "blink1 " + (serial.empty() ? std::string("(no serial)") : serial));
+            os << "}}";
+        }
+
+        std::uint64_t asyncId = 0;
+        for (const Span& span : currentSpans) {
+            const int track = tracks.at(span.serial);
+            if (span.async) {
+                // A begin and end pair sharing an ID, so overlapping spans are shown side by side
+                ++asyncId;
+                for (const bool begin : {true, false}) {
+                    beginEvent();
+                    os << "{\"name\":";
+                    writeJsonString(os, span.name);
+                    os << ",\"cat\":";
+                    writeJsonString(os, span.category);
+                    os << ",\"ph\":\"" << (begin ? 'b' : 'e') << "\",\"id\":" << asyncId
+                       << ",\"pid\":" << TRACE_PID << ",\"tid\":" << track << ",\"ts\":";
+                    writeMicros(os, (begin ? span.start : span.end).time_since_epoch());
+                    if (begin) {
+                        os << ',';
+                        writeArgs(os, span);
+                    }
+                    os << '}';
+                }
+            } else {
+                beginEvent();
+                os << "{\"name\":";
+                writeJsonString(os, span.name);
+                os << ",\"cat\":";
+                writeJsonString(os, span.category);
+                os << ",\"ph\":\"X\",\"pid\":" << TRACE_PID << ",\"tid\":" << track << ",\"ts\":";
+                writeMicros(os, span.start.time_since_epoch());
+                os << ",\"dur\":";
+                writeMicros(os, span.end - span.start);
+                os << ',';
+                writeArgs(os, span);
+                os << '}';
+            }
+        }
+        os << "\n]}\n";
+    }
+
+    bool ChromeTraceWriter::save(const std::string& path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        write(file);
+        file.close();
+        return static_cast<bool>(file);
+    }
+}
@@ -0,0 +1,134 @@
+#include "Clock.hpp"
+
+#include <thread>
+
+namespace blink1_lib {
+    void Clock::sleepFor(const duration sleepDuration) noexcept {
+        sleepUntil(now() + sleepDuration);
+    }
+
+    const std::shared_ptr<Clock>& Clock::steady() noexcept {
+        static const std::shared_ptr<Clock> clock = std::make_shared<SteadyClock>();
+        return clock;
+    }
+
+    Clock::time_point SteadyClock::now() const noexcept {
+        return std::chrono::steady_clock::now();
+    }
+
+    void SteadyClock::sleepUntil(const time_point deadline) noexcept {
+        std::this_thread::sleep_until(deadline);
+    }
+
+    void SteadyClock::waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& condition, const time_point deadline) {
+        condition.wait_until(lock, deadline);
+    }
+
+    VirtualClock::VirtualClock(const time_point startTime) noexcept : currentTime(startTime) {}
+
+    Clock::time_point VirtualClock::now() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        return currentTime;
+    }
+
+    void VirtualClock::sleepUntil(const time_point deadline) noexcept {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (currentTime >= deadline) {
+            return;
+        }
+
+        ++sleepers;
+        sleepersChanged.notify_all();
+        timeChanged.wait(lock, [this, deadline] { return currentTime >= deadline; });
+        --sleepers;
+        sleepersChanged.notify_all();
+    }
+
+    void VirtualClock::waitUntil(std::unique_lock<std::mutex>& lock, std::condition_variable& condition, const time_point deadline) {
+        Waiter waiter{&condition, lock.mutex(), deadline, 0};
+        {
+            std::lock_guard<std::mutex> clockLock(mutex);
+            if (currentTime >= deadline) {
+                return;
+            }
+            waiter.notifiedGeneration = generation;
+            waiters.insert(&waiter);
+        }
+
+        // advance() locks the caller's mutex before notifying, and the caller's lock is held
+        // from the check above until the wait starts, so the notification can't be missed
+        condition.wait(lock);
+
+        // advance() may be about to lock the caller's mutex, so it has to be released while
+        // waiting for advance() to stop using the waiter
+        lock.unlock();
+        {
+            std::unique_lock<std::mutex> clockLock(mutex);
+            notified.wait(clockLock, [&waiter] { return waiter.notifying == 0; });
+            waiters.erase(&waiter);
+        }
+        lock.lock();
+    }
+
+    void VirtualClock::advance(const duration amount) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            currentTime += amount;
+            ++generation;
+            timeChanged.notify_all();
+        }
+        notifyWaiters();
+    }
+
+    void VirtualClock::advanceTo(const time_point newTime) noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (newTime <= currentTime) {
+                return;
+            }
+            currentTime = newTime;
+            ++generation;
+            timeChanged.notify_all();
+        }
+        notifyWaiters();
+    }
+
+    void VirtualClock::notifyWaiters() noexcept {
+        // Waiters lock their own mutex before the clock's, so the clock's mutex can't be held
+        // while locking theirs. Each waiter is notified once per change of time.
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            Waiter* next = nullptr;
+            for (Waiter* waiter : waiters) {
+                if (waiter->notifiedGeneration < generation && currentTime >= waiter->deadline) {
+                    next = waiter;
+                    break;
+                }
+            }
+            if (next == nullptr) {
+                return;
+            }
+
+            next->notifiedGeneration = generation;
+            ++next->notifying;
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> waiterLock(*next->mutex);
+                next->condition->notify_all();
+            }
+            lock.lock();
+            --next->notifying;
+            notified.notify_all();
+        }
+    }
+
+    std::size_t VirtualClock::sleeperCount() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        return sleepers;
+    }
+
+    void VirtualClock::waitForSleepers(const std::size_t count) const noexcept {
+        std::unique_lock<std::mutex> lock(mutex);
+        sleepersChanged.wait(lock, [this, count] { return sleepers >= count; });
+    }
+}
@@ -0,0 +1,116 @@
+#include "CommandRecorder.hpp"
+
+#include <utility>
+
+namespace blink1_lib {
+    CommandRecorder::CommandRecorder(Blink1Device& _device, std::shared_ptr<Clock> _clock)
+        : device(_device), clock(std::move(_clock)), startTime(clock->now())
+    {}
+
+    void CommandRecorder::record(CommandTrace::Entry entry) {
+        // The time is read under the lock so that entries from separate threads stay in time order
+        std::lock_guard<std::mutex> lock(traceMutex);
+        entry.time = std::chrono::duration_cast<std::chrono::microseconds>(clock->now() - startTime);
+        trace.add(entry);
+    }
+
+    bool CommandRecorder::fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::FADE_TO_RGB;
+        entry.fadeMillis = fadeMillis;
+        entry.rgbn = RGBN(rgb.r, rgb.g, rgb.b, 0);
+        record(entry);
+        return device.fadeToRGB(fadeMillis, rgb);
+    }
+
+    bool CommandRecorder::fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::FADE_TO_RGBN;
+        entry.fadeMillis = fadeMillis;
+        entry.rgbn = rgbn;
+        record(entry);
+        return device.fadeToRGBN(fadeMillis, rgbn);
+    }
+
+    bool CommandRecorder::setRGB(const RGB& rgb) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::SET_RGB;
+        entry.rgbn = RGBN(rgb.r, rgb.g, rgb.b, 0);
+        record(entry);
+        return device.setRGB(rgb);
+    }
+
+    bool CommandRecorder::setRGBN(const RGBN& rgbn) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::SET_RGBN;
+        entry.rgbn = rgbn;
+        record(entry);
+        return device.setRGBN(rgbn);
+    }
+
+    bool CommandRecorder::play(const std::uint8_t pos) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::PLAY;
+        entry.pos = pos;
+        record(entry);
+        return device.play(pos);
+    }
+
+    bool CommandRecorder::playLoop(const std::uint8_t startpos, const std::uint8_t endpos, const std::uint8_t count) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::PLAY_LOOP;
+        entry.pos = startpos;
+        entry.endPos = endpos;
+        entry.count = count;
+        record(entry);
+        return device.playLoop(startpos, endpos, count);
+    }
+
+    bool CommandRecorder::stop() {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::STOP;
+        record(entry);
+        return device.stop();
+    }
+
+    bool CommandRecorder::writePatternLine(const PatternLine& line, const std::uint8_t pos) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::WRITE_PATTERN_LINE;
+        entry.fadeMillis = line.fadeMillis;
+        entry.rgbn = RGBN(line.rgb.r, line.rgb.g, line.rgb.b, 0);
+        entry.pos = pos;
+        record(entry);
+        return device.writePatternLine(line, pos);
+    }
+
+    bool CommandRecorder::writePatternLineN(const PatternLineN& line, const std::uint8_t pos) {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::WRITE_PATTERN_LINE_N;
+        entry.fadeMillis = line.fadeMillis;
+        entry.rgbn = line.rgbn;
+        entry.pos = pos;
+        record(entry);
+        return device.writePatternLineN(line, pos);
+    }
+
+    bool CommandRecorder::savePattern() {
+        CommandTrace::Entry entry;
+        entry.command = CommandTrace::COMMAND::SAVE_PATTERN;
+        record(entry);
+        return device.savePattern();
+    }
+
+    Blink1Device& CommandRecorder::getDevice() const noexcept {
+        return device;
+    }
+
+    CommandTrace CommandRecorder::getTrace() const {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        return trace;
+    }
+
+    CommandTrace CommandRecorder::takeTrace() {
+        std::lock_guard<std::mutex> lock(traceMutex);
+        return std::exchange(trace, CommandTrace());
+    }
+}
@@ -0,0 +1,272 @@
+#include "CommandTrace.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace blink1_lib {
+    static constexpr std::array<char, 4> MAGIC{'B', '1', 'T', 'R'};
+
+    // Which arguments each command stores in the binary format
+    struct CommandArguments {
+        bool fade;
+        bool rgb;
+        bool n;
+        bool pos;
+        bool loop;
+    };
+
+    static std::optional<CommandArguments> argumentsFor(const CommandTrace::COMMAND command) noexcept {
+        switch (command) {
+            case CommandTrace::COMMAND::FADE_TO_RGB:          return CommandArguments{true,  true,  false, false, false};
+            case CommandTrace::COMMAND::FADE_TO_RGBN:         return CommandArguments{true,  true,  true,  false, false};
+            case CommandTrace::COMMAND::SET_RGB:              return CommandArguments{false, true,  false, false, false};
+            case CommandTrace::COMMAND::SET_RGBN:             return CommandArguments{false, true,  true,  false, false};
+            case CommandTrace::COMMAND::PLAY:                 return CommandArguments{false, false, false, true,  false};
+            case CommandTrace::COMMAND::PLAY_LOOP:            return CommandArguments{false, false, false, true,  true};
+            case CommandTrace::COMMAND::STOP:                 return CommandArguments{false, false, false, false, false};
+            case CommandTrace::COMMAND::WRITE_PATTERN_LINE:   return CommandArguments{true,  true,  false, true,  false};
+            case CommandTrace::COMMAND::WRITE_PATTERN_LINE_N: return CommandArguments{true,  true,  true,  true,  false};
+            case CommandTrace::COMMAND::SAVE_PATTERN:         return CommandArguments{false, false, false, false, false};
+        }
+        return std::nullopt;
+    }
+
+    static void writeByte(std::ostream& os, const std::uint8_t byte) {
+        os.put(static_cast<char>(byte));
+    }
+
+    static std::optional<std::uint8_t> readByte(std::istream& is) {
+        const auto byte = is.get();
+        if (byte == std::istream::traits_type::eof()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(byte);
+    }
+
+    static void writeVarint(std::ostream& os, std::uint64_t value) {
+        while (value >= 0x80) {
+            writeByte(os, static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        writeByte(os, static_cast<std::uint8_t>(value));
+    }
+
+    static std::optional<std::uint64_t> readVarint(std::istream& is) {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const auto byte = readByte(is);
+            if (!byte) {
+                return std::nullopt;
+            }
+            value |= static_cast<std::uint64_t>(*byte & 0x7F) << shift;
+            if ((*byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    bool CommandTrace::Entry::operator==(const Entry& other) const noexcept {
+        return time == other.time
+            && command == other.command
+            && fadeMillis == other.fadeMillis
+            && rgbn == other.rgbn
+            && pos == other.pos
+            && endPos == other.endPos
+            && count == other.count;
+    }
+
+    bool CommandTrace::Entry::operator!=(const Entry& other) const noexcept {
+        return !(*this == other);
+    }
+
+    CommandTrace::CommandTrace(std::vector<Entry> _entries) noexcept : entries(std::move(_entries)) {}
+
+    void CommandTrace::add(const Entry& entry) {
+        entries.push_back(entry);
+    }
+
+    const std::vector<CommandTrace::Entry>& CommandTrace::getEntries() const noexcept {
+        return entries;
+    }
+
+    std::size_t CommandTrace::size() const noexcept {
+        return entries.size();
+    }
+
+    bool CommandTrace::empty() const noexcept {
+        return entries.empty();
+    }
+
+    std::chrono::microseconds CommandTrace::duration() const noexcept {
+        return entries.empty() ? std::chrono::microseconds(0) : entries.back().time;
+    }
+
+    bool CommandTrace::write(std::ostream& os) const {
+        if (entries.size() > UINT32_MAX) {
+            return false;
+        }
+
+        // Checked up front so that nothing reaches the stream for a trace that can't be written
+        std::chrono::microseconds previousTime(0);
+        for (const Entry& entry : entries) {
+            if (!argumentsFor(entry.command) || entry.time < previousTime) {
+                return false;
+            }
+            previousTime = entry.time;
+        }
+
+        os.write(MAGIC.data(), MAGIC.size());
+        writeByte(os, FORMAT_VERSION);
+        const auto entryCount = static_cast<std::uint32_t>(entries.size());
+        for (unsigned shift = 0; shift < 32; shift += 8) {
+            writeByte(os, static_cast<std::uint8_t>(entryCount >> shift));
+        }
+
+        previousTime = std::chrono::microseconds(0);
+        for (const Entry& entry : entries) {
+            const auto arguments = argumentsFor(entry.command);
+            writeVarint(os, static_cast<std::uint64_t>((entry.time - previousTime).count()));
+            previousTime = entry.time;
+            writeByte(os, static_cast<std::uint8_t>(entry.command));
+            if (arguments->fade) {
+                writeByte(os, static_cast<std::uint8_t>(entry.fadeMillis));
+                writeByte(os, static_cast<std::uint8_t>(entry.fadeMillis >> 8));
+            }
+            if (arguments->rgb) {
+                writeByte(os, entry.rgbn.r);
+                writeByte(os, entry.rgbn.g);
+                writeByte(os, entry.rgbn.b);
+            }
+            if (arguments->n) {
+                writeByte(os, entry.rgbn.n);
+            }
+            if (arguments->pos) {
+                writeByte(os, entry.pos);
+            }
+            if (arguments->loop) {
+                writeByte(os, entry.endPos);
+                writeByte(os, entry.count);
+            }
+        }
+        return static_cast<bool>(os);
+    }
+
+    std::optional<CommandTrace> CommandTrace::read(std::istream& is) {
+        std::array<char, 4> magic{};
+        if (!is.read(magic.data(), magic.size()) || magic != MAGIC || readByte(is) != FORMAT_VERSION) {
+            return std::nullopt;
+        }
+
+        std::uint32_t entryCount = 0;
+        for (unsigned shift = 0; shift < 32; shift += 8) {
+            const auto byte = readByte(is);
+            if (!byte) {
+                return std::nullopt;
+            }
+            entryCount |= static_cast<std::uint32_t>(*byte) << shift;
+        }
+
+        CommandTrace trace;
+        std::chrono::microseconds time(0);
+        for (std::uint32_t i = 0; i < entryCount; ++i) {
+            const auto delta = readVarint(is);
+            const auto command = readByte(is);
+            if (!delta || !command) {
+                return std::nullopt;
+            }
+
+            // A delta that would take the time past what microseconds can hold can't have been written by write()
+            const auto remaining = static_cast<std::uint64_t>(std::chrono::microseconds::max().count() - time.count());
+            if (*delta > remaining) {
+                return std::nullopt;
+            }
+
+            Entry entry;
+            time += std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(*delta));
+            entry.time = time;
+            entry.command = static_cast<COMMAND>(*command);
+            const auto arguments = argumentsFor(entry.command);
+            if (!arguments) {
+                return std::nullopt;
+            }
+
+            // Reads the arguments in the order write() stores them, noting whether any were missing
+            bool complete = true;
+            auto next = [&is, &complete]() -> std::uint8_t {
+                const auto byte = readByte(is);
+                complete = complete && byte.has_value();
+                return byte.value_or(0);
+            };
+            if (arguments->fade) {
+                const std::uint8_t low = next();
+                const std::uint8_t high = next();
+                entry.fadeMillis = static_cast<std::uint16_t>(low | (high << 8));
+            }
+            if (arguments->rgb) {
+                entry.rgbn.r = next();
+                entry.rgbn.g = next();
+                entry.rgbn.b = next();
+            }
+            if (arguments->n) {
+                entry.rgbn.n = next();
+            }
+            if (arguments->pos) {
+                entry.pos = next();
+            }
+            if (arguments->loop) {
+                entry.endPos = next();
+                entry.count = next();
+            }
+            if (!complete) {
+                return std::nullopt;
+            }
+            trace.add(entry);
+        }
+        return trace;
+    }
+
+    bool CommandTrace::save(const std::string& path) const {
+        // Written next to the file and renamed over it, so a trace that can't be written leaves the file as it was
+        const std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            const bool written = write(file);
+            file.close();
+            if (!written || !file) {
+                std::error_code error;
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<CommandTrace> CommandTrace::load(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return std::nullopt;
+        }
+        return read(file);
+    }
+
+    bool CommandTrace::operator==(const CommandTrace& other) const noexcept {
+        return entries == other.entries;
+    }
+
+    bool CommandTrace::operator!=(const CommandTrace& other) const noexcept {
+        return !(*this == other);
+    }
+}
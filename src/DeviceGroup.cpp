@@ -0,0 +1,72 @@
+#include "DeviceGroup.hpp"
+
+#include <algorithm>
+
+namespace blink1_lib {
+    bool DeviceGroup::Result::allSucceeded() const noexcept {
+        return std::all_of(succeeded.begin(), succeeded.end(), [](bool success) { return success; });
+    }
+
+    std::size_t DeviceGroup::Result::successCount() const noexcept {
+        return static_cast<std::size_t>(std::count(succeeded.begin(), succeeded.end(), true));
+    }
+
+    DeviceGroup::DeviceGroup(std::vector<std::shared_ptr<Blink1Device>> _devices, std::shared_ptr<WorkerPool> _pool)
+        : devices(std::move(_devices)), pool(std::move(_pool))
+    {
+        if (!pool) {
+            pool = std::make_shared<WorkerPool>(std::max<std::size_t>(1, devices.size()));
+        }
+    }
+
+    const std::vector<std::shared_ptr<Blink1Device>>& DeviceGroup::getDevices() const noexcept {
+        return devices;
+    }
+
+    std::size_t DeviceGroup::size() const noexcept {
+        return devices.size();
+    }
+
+    DeviceGroup::Result DeviceGroup::forEach(const std::function<bool(Blink1Device&)>& command) {
+        // std::vector<bool> packs its elements, so each task writes to its own byte instead
+        std::vector<char> succeeded(devices.size(), 0);
+        pool->parallelFor(devices.size(), [this, &command, &succeeded](std::size_t i) {
+            if (devices[i]) {
+                succeeded[i] = command(*devices[i]) ? 1 : 0;
+            }
+        });
+        return Result{std::vector<bool>(succeeded.begin(), succeeded.end())};
+    }
+
+    DeviceGroup::Result DeviceGroup::fadeToRGB(const std::uint16_t fadeMillis, const RGB& rgb) {
+        return forEach([fadeMillis, &rgb](Blink1Device& device) { return device.fadeToRGB(fadeMillis, rgb); });
+    }
+
+    DeviceGroup::Result DeviceGroup::fadeToRGBN(const std::uint16_t fadeMillis, const RGBN& rgbn) {
+        return forEach([fadeMillis, &rgbn](Blink1Device& device) { return device.fadeToRGBN(fadeMillis, rgbn); });
+    }
+
+    DeviceGroup::Result DeviceGroup::setRGB(const RGB& rgb) {
+        return forEach([&rgb](Blink1Device& device) { return device.setRGB(rgb); });
+    }
+
+    DeviceGroup::Result DeviceGroup::setRGBN(const RGBN& rgbn) {
+        return forEach([&rgbn](Blink1Device& device) { return device.setRGBN(rgbn); });
+    }
+
+    DeviceGroup::Result DeviceGroup::play(const std::uint8_t pos) {
+        return forEach([pos](Blink1Device& device) { return device.play(pos); });
+    }
+
+    DeviceGroup::Result DeviceGroup::playLoop(const std::uint8_t startpos, const std::uint8_t endpos, const std::uint8_t count) {
+        return forEach([startpos, endpos, count](Blink1Device& device) { return device.playLoop(startpos, endpos, count); });
+    }
+
+    DeviceGroup::Result DeviceGroup::stop() {
+        return forEach([](Blink1Device& device) { return device.stop(); });
+    }
+
+    DeviceGroup::Result DeviceGroup::writePattern(std::span<const PatternLineN> lines, const std::uint8_t startPos) {
+        return forEach([lines, startPos](Blink1Device& device) { return !device.writePattern(lines, startPos); });
+    }
+}
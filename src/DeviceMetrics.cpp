@@ -0,0 +1,64 @@
+#include "DeviceMetrics.hpp"
+
+namespace blink1_lib {
+    void DeviceMetrics::record(const OPERATION operation, const bool success, const std::chrono::nanoseconds latency) noexcept {
+        OperationMetrics& metrics = operations[static_cast<std::size_t>(operation)];
+        ++metrics.calls;
+        if (!success) {
+            ++metrics.failures;
+        }
+        metrics.latency.record(latency);
+    }
+
+    void DeviceMetrics::merge(const DeviceMetrics& other) noexcept {
+        for (std::size_t i = 0; i < OPERATION_COUNT; ++i) {
+            operations[i].calls += other.operations[i].calls;
+            operations[i].failures += other.operations[i].failures;
+            operations[i].latency.merge(other.operations[i].latency);
+        }
+    }
+
+    void DeviceMetrics::reset() noexcept {
+        operations.fill(OperationMetrics());
+    }
+
+    const DeviceMetrics::OperationMetrics& DeviceMetrics::get(const OPERATION operation) const noexcept {
+        return operations[static_cast<std::size_t>(operation)];
+    }
+
+    std::uint64_t DeviceMetrics::totalCalls() const noexcept {
+        std::uint64_t total = 0;
+        for (const OperationMetrics& metrics : operations) {
+            total += metrics.calls;
+        }
+        return total;
+    }
+
+    std::uint64_t DeviceMetrics::totalFailures() const noexcept {
+        std::uint64_t total = 0;
+        for (const OperationMetrics& metrics : operations) {
+            total += metrics.failures;
+        }
+        return total;
+    }
+
+    std::string_view DeviceMetrics::getOperationName(const OPERATION operation) noexcept {
+        switch (operation) {
+            case OPERATION::GET_VERSION:          return "get_version";
+            case OPERATION::FADE_TO_RGB:          return "fade_to_rgb";
+            case OPERATION::FADE_TO_RGBN:         return "fade_to_rgbn";
+            case OPERATION::SET_RGB:              return "set_rgb";
+            case OPERATION::READ_RGB_WITH_FADE:   return "read_rgb_with_fade";
+            case OPERATION::PLAY:                 return "play";
+            case OPERATION::PLAY_LOOP:            return "play_loop";
+            case OPERATION::STOP:                 return "stop";
+            case OPERATION::READ_PLAY_STATE:      return "read_play_state";
+            case OPERATION::WRITE_PATTERN_LINE:   return "write_pattern_line";
+            case OPERATION::WRITE_PATTERN_LINE_N: return "write_pattern_line_n";
+            case OPERATION::READ_PATTERN_LINE:    return "read_pattern_line";
+            case OPERATION::READ_PATTERN_LINE_N:  return "read_pattern_line_n";
+            case OPERATION::SAVE_PATTERN:         return "save_pattern";
+        }
+        return "unknown";
+    }
+}
@@ -0,0 +1,67 @@
+#include "FadeTimer.hpp"
+
+namespace blink1_lib {
+    FadeTimer::FadeTimer(std::shared_ptr<Clock> _clock) : clock(std::move(_clock)), timerThread(&FadeTimer::run, this) {}
+
+    FadeTimer::~FadeTimer() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+        timerThread.join();
+    }
+
+    void FadeTimer::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (callbacks.empty()) {
+                wakeUp.wait(lock);
+                continue;
+            }
+
+            const auto next = callbacks.begin();
+            if (next->first > clock->now()) {
+                // Woken early if an earlier callback is scheduled or the timer is stopped
+                clock->waitUntil(lock, wakeUp, next->first);
+                continue;
+            }
+
+            auto callback = std::move(next->second);
+            callbacks.erase(next);
+            lock.unlock();
+            try {
+                callback();
+            } catch (...) {
+                // Callbacks must not throw, but an exception must not take down the timer
+            }
+            lock.lock();
+        }
+    }
+
+    void FadeTimer::schedule(const std::chrono::steady_clock::time_point deadline, std::function<void()> callback) {
+        bool first = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto inserted = callbacks.emplace(deadline, std::move(callback));
+            first = (inserted == callbacks.begin());
+        }
+        if (first) {
+            wakeUp.notify_one();
+        }
+    }
+
+    std::size_t FadeTimer::pendingCount() const noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        return callbacks.size();
+    }
+
+    const std::shared_ptr<Clock>& FadeTimer::getClock() const noexcept {
+        return clock;
+    }
+
+    FadeTimer& FadeTimer::shared() {
+        static FadeTimer timer;
+        return timer;
+    }
+}
@@ -0,0 +1,125 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace blink1_lib {
+    // Values below 2^SUB_BUCKET_BITS get a bucket each, and every power of two above that
+    // is split into 2^(SUB_BUCKET_BITS - 1) buckets
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr std::uint64_t LINEAR_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr std::uint64_t BUCKETS_PER_POWER = LINEAR_BUCKETS / 2;
+    static constexpr unsigned MAX_VALUE_BITS = 36;
+
+    static_assert(LatencyHistogram::BUCKET_COUNT == LINEAR_BUCKETS + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * BUCKETS_PER_POWER);
+
+    std::size_t LatencyHistogram::bucketFor(const std::uint64_t value) noexcept {
+        if (value < LINEAR_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+
+        const auto width = static_cast<unsigned>(std::bit_width(value));
+        if (width > MAX_VALUE_BITS) {
+            return BUCKET_COUNT - 1;
+        }
+
+        const unsigned shift = width - SUB_BUCKET_BITS;
+        const std::uint64_t subBucket = (value >> shift) - BUCKETS_PER_POWER;
+        return static_cast<std::size_t>(LINEAR_BUCKETS + (shift - 1) * BUCKETS_PER_POWER + subBucket);
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::getBucketUpperBound(const std::size_t bucket) noexcept {
+        if (bucket < LINEAR_BUCKETS) {
+            return std::chrono::nanoseconds(bucket);
+        }
+        if (bucket >= BUCKET_COUNT - 1) {
+            return std::chrono::nanoseconds::max();
+        }
+
+        const auto shift = static_cast<unsigned>((bucket - LINEAR_BUCKETS) / BUCKETS_PER_POWER + 1);
+        const std::uint64_t subBucket = (bucket - LINEAR_BUCKETS) % BUCKETS_PER_POWER + BUCKETS_PER_POWER;
+        return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(((subBucket + 1) << shift) - 1));
+    }
+
+    void LatencyHistogram::record(const std::chrono::nanoseconds latency) noexcept {
+        const auto value = static_cast<std::uint64_t>(std::max<std::chrono::nanoseconds::rep>(latency.count(), 0));
+        ++buckets[bucketFor(value)];
+        ++totalCount;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+        total += value;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other) noexcept {
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        totalCount += other.totalCount;
+        minValue = std::min(minValue, other.minValue);
+        maxValue = std::max(maxValue, other.maxValue);
+        total += other.total;
+    }
+
+    void LatencyHistogram::reset() noexcept {
+        *this = LatencyHistogram();
+    }
+
+    std::uint64_t LatencyHistogram::count() const noexcept {
+        return totalCount;
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::sum() const noexcept {
+        return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(total));
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::min() const noexcept {
+        return std::chrono::nanoseconds(totalCount == 0 ? 0 : static_cast<std::chrono::nanoseconds::rep>(minValue));
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::max() const noexcept {
+        return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(maxValue));
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::mean() const noexcept {
+        if (totalCount == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(total / totalCount));
+    }
+
+    std::chrono::nanoseconds LatencyHistogram::percentile(const double percentile) const noexcept {
+        if (totalCount == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+
+        // The rank of the value we're looking for, counting from 1
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(totalCount))));
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::min(getBucketUpperBound(i), max());
+            }
+        }
+        return max();
+    }
+
+    const std::array<std::uint64_t, LatencyHistogram::BUCKET_COUNT>& LatencyHistogram::getBuckets() const noexcept {
+        return buckets;
+    }
+
+    bool LatencyHistogram::operator==(const LatencyHistogram& other) const noexcept {
+        return totalCount == other.totalCount
+            && minValue == other.minValue
+            && maxValue == other.maxValue
+            && total == other.total
+            && buckets == other.buckets;
+    }
+
+    bool LatencyHistogram::operator!=(const LatencyHistogram& other) const noexcept {
+        return !(*this == other);
+    }
+}
@@ -0,0 +1,243 @@
+#include "PatternCompiler.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "PatternFolder.hpp"
+
+namespace blink1_lib {
+    static constexpr std::chrono::milliseconds MAX_FADE(std::numeric_limits<std::uint16_t>::max());
+
+    struct CompilerKeyframe {
+        RGB rgb;
+        std::chrono::milliseconds end; // When the animation reaches this keyframe
+        bool kept{true};
+        bool pinned{false};
+    };
+
+    struct CompilerTrack {
+        std::uint8_t ledn;
+        std::vector<CompilerKeyframe> keyframes;
+    };
+
+    struct CompilerSchedule {
+        std::vector<PatternLineN> lines;
+        std::chrono::milliseconds timeError{0};
+    };
+
+    // Largest error at the keyframes between two kept keyframes when they are joined by one fade
+    static double segmentError(const std::vector<CompilerKeyframe>& keyframes, const std::size_t from, const std::size_t to,
+                               const PatternSimplifier::COLOR_SPACE colorSpace) noexcept {
+        const CompilerKeyframe& start = keyframes[from];
+        const CompilerKeyframe& end = keyframes[to];
+        const auto length = (end.end - start.end).count();
+
+        double error = 0;
+        for (std::size_t i = from + 1; i < to; ++i) {
+            const CompilerKeyframe& keyframe = keyframes[i];
+            const double fraction = length > 0 ? static_cast<double>((keyframe.end - start.end).count()) / static_cast<double>(length) : 1.0;
+            error = std::max(error, PatternSimplifier::fadeError(keyframe.rgb, start.rgb, end.rgb, fraction, colorSpace));
+        }
+        return error;
+    }
+
+    static std::size_t previousKept(const std::vector<CompilerKeyframe>& keyframes, std::size_t i) noexcept {
+        do {
+            --i;
+        } while (!keyframes[i].kept);
+        return i;
+    }
+
+    static std::size_t nextKept(const std::vector<CompilerKeyframe>& keyframes, std::size_t i) noexcept {
+        do {
+            ++i;
+        } while (!keyframes[i].kept);
+        return i;
+    }
+
+    // Merges the kept keyframes of every track into the order the device will play them in
+    static std::optional<CompilerSchedule> schedule(const std::vector<CompilerTrack>& tracks, const std::optional<std::chrono::milliseconds> loopLength) {
+        struct Event {
+            std::chrono::milliseconds start;
+            std::chrono::milliseconds end;
+            std::uint8_t ledn;
+            RGB rgb;
+        };
+
+        std::vector<Event> events;
+        for (const CompilerTrack& track : tracks) {
+            std::chrono::milliseconds start(0);
+            for (const CompilerKeyframe& keyframe : track.keyframes) {
+                if (keyframe.kept) {
+                    events.push_back(Event{start, keyframe.end, track.ledn, keyframe.rgb});
+                    start = keyframe.end;
+                }
+            }
+        }
+
+        // Of the keyframes that start together, the shortest fades are cut short first
+        std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+            return a.start != b.start ? a.start < b.start : a.end < b.end;
+        });
+
+        CompilerSchedule result;
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const Event& event = events[i];
+            const auto nextStart = i + 1 < events.size() ? events[i + 1].start : loopLength.value_or(event.end);
+            const auto fade = std::min(nextStart, event.end) - event.start;
+            if (fade > MAX_FADE) {
+                return std::nullopt;
+            }
+            result.lines.emplace_back(RGBN(event.rgb.r, event.rgb.g, event.rgb.b, event.ledn), static_cast<std::uint16_t>(fade.count()));
+            result.timeError = std::max(result.timeError, event.end - (event.start + fade));
+
+            // Nothing else starts before the next keyframe, so hold this color until it does
+            if (nextStart > event.end) {
+                const auto hold = nextStart - event.end;
+                if (hold > MAX_FADE) {
+                    return std::nullopt;
+                }
+                result.lines.emplace_back(RGBN(event.rgb.r, event.rgb.g, event.rgb.b, event.ledn), static_cast<std::uint16_t>(hold.count()));
+            }
+        }
+        return result;
+    }
+
+    PatternCompiler::PatternCompiler(const std::size_t _capacity, const double _colorTolerance, const std::chrono::milliseconds _timeTolerance,
+                                     const PatternSimplifier::COLOR_SPACE _colorSpace) noexcept
+        : capacity(_capacity), colorTolerance(_colorTolerance), timeTolerance(_timeTolerance), colorSpace(_colorSpace)
+    {}
+
+    std::optional<PatternCompiler::Program> PatternCompiler::compile(const Animation& animation, const std::uint8_t startPos) const {
+        if (animation.empty()) {
+            return std::nullopt;
+        }
+
+        std::vector<CompilerTrack> tracks;
+        for (const std::uint8_t ledn : animation.getLeds()) {
+            CompilerTrack& track = tracks.emplace_back(CompilerTrack{ledn, {}});
+            std::chrono::milliseconds end(0);
+            for (const PatternLineN& keyframe : animation.getTrack(ledn)) {
+                end += std::chrono::milliseconds(keyframe.fadeMillis);
+                track.keyframes.push_back(CompilerKeyframe{RGB(keyframe.rgbn.r, keyframe.rgbn.g, keyframe.rgbn.b), end});
+            }
+        }
+
+        // A looping pattern can only wrap around if every track ends at the same time
+        std::optional<std::chrono::milliseconds> loopLength;
+        const auto duration = animation.getDuration();
+        if (animation.isLooping() && duration.count() > 0) {
+            for (const CompilerTrack& track : tracks) {
+                if (track.keyframes.back().end != duration) {
+                    return std::nullopt;
+                }
+            }
+            loopLength = duration;
+        }
+
+        auto current = schedule(tracks, loopLength);
+        if (!current || current->timeError > timeTolerance) {
+            return std::nullopt;
+        }
+
+        // Remove the keyframe that costs the least color accuracy until none can be removed
+        while (true) {
+            CompilerKeyframe* best = nullptr;
+            double bestError = 0;
+            for (CompilerTrack& track : tracks) {
+                for (std::size_t i = 1; i + 1 < track.keyframes.size(); ++i) {
+                    if (!track.keyframes[i].kept || track.keyframes[i].pinned) {
+                        continue;
+                    }
+
+                    const std::size_t from = previousKept(track.keyframes, i);
+                    const std::size_t to = nextKept(track.keyframes, i);
+                    if (track.keyframes[to].end - track.keyframes[from].end > MAX_FADE) {
+                        continue;
+                    }
+
+                    const double error = segmentError(track.keyframes, from, to, colorSpace);
+                    if (error <= colorTolerance && (best == nullptr || error < bestError)) {
+                        best = &track.keyframes[i];
+                        bestError = error;
+                    }
+                }
+            }
+
+            if (best == nullptr) {
+                break;
+            }
+
+            best->kept = false;
+            auto candidate = schedule(tracks, loopLength);
+            if (!candidate || candidate->timeError > timeTolerance) {
+                best->kept = true;
+                best->pinned = true;
+            } else {
+                current = std::move(candidate);
+            }
+        }
+
+        // Patterns that repeat only need one repetition in the table
+        auto folded = PatternFolder::fold(current->lines, loopLength ? 0 : 1, startPos);
+        if (!folded || startPos >= capacity || folded->lines.size() > capacity - startPos) {
+            return std::nullopt;
+        }
+
+        Program program;
+        program.lines = std::move(folded->lines);
+        program.startPos = folded->startPos;
+        program.endPos = folded->endPos;
+        program.count = folded->count;
+        program.timeError = current->timeError;
+        for (const CompilerTrack& track : tracks) {
+            std::size_t from = 0;
+            for (std::size_t i = 1; i < track.keyframes.size(); ++i) {
+                if (track.keyframes[i].kept) {
+                    program.colorError = std::max(program.colorError, segmentError(track.keyframes, from, i, colorSpace));
+                    from = i;
+                }
+            }
+        }
+        return program;
+    }
+
+    bool PatternCompiler::upload(Blink1Device& device, const Program& program) noexcept {
+        if (program.lines.empty() || device.syncPattern(program.lines, program.startPos)) {
+            return false;
+        }
+        return device.playLoop(program.startPos, program.endPos, program.count);
+    }
+
+    void PatternCompiler::setCapacity(const std::size_t _capacity) noexcept {
+        capacity = _capacity;
+    }
+
+    std::size_t PatternCompiler::getCapacity() const noexcept {
+        return capacity;
+    }
+
+    void PatternCompiler::setColorTolerance(const double _colorTolerance) noexcept {
+        colorTolerance = _colorTolerance;
+    }
+
+    double PatternCompiler::getColorTolerance() const noexcept {
+        return colorTolerance;
+    }
+
+    void PatternCompiler::setColorSpace(const PatternSimplifier::COLOR_SPACE _colorSpace) noexcept {
+        colorSpace = _colorSpace;
+    }
+
+    PatternSimplifier::COLOR_SPACE PatternCompiler::getColorSpace() const noexcept {
+        return colorSpace;
+    }
+
+    void PatternCompiler::setTimeTolerance(const std::chrono::milliseconds _timeTolerance) noexcept {
+        timeTolerance = _timeTolerance;
+    }
+
+    std::chrono::milliseconds PatternCompiler::getTimeTolerance() const noexcept {
+        return timeTolerance;
+    }
+}
@@ -0,0 +1,69 @@
+#include "PatternFolder.hpp"
+
+#include <limits>
+
+namespace blink1_lib {
+    // Number of positions in the pattern table that a std::uint8_t can address
+    static constexpr std::size_t TABLE_SIZE = 256;
+
+    std::size_t PatternFolder::period(std::span<const PatternLineN> lines) {
+        if (lines.empty()) {
+            return 0;
+        }
+
+        // Knuth-Morris-Pratt failure function: the longest proper prefix that is also a suffix
+        std::vector<std::size_t> border(lines.size(), 0);
+        for (std::size_t i = 1; i < lines.size(); ++i) {
+            std::size_t length = border[i - 1];
+            while (length > 0 && lines[i] != lines[length]) {
+                length = border[length - 1];
+            }
+            if (lines[i] == lines[length]) {
+                ++length;
+            }
+            border[i] = length;
+        }
+
+        const std::size_t shortest = lines.size() - border.back();
+        return lines.size() % shortest == 0 ? shortest : lines.size();
+    }
+
+    std::optional<PatternFolder::FoldedPattern> PatternFolder::fold(std::span<const PatternLineN> lines, const std::uint8_t count, const std::uint8_t startPos) {
+        if (lines.empty()) {
+            return std::nullopt;
+        }
+
+        const std::size_t block = period(lines);
+        const std::size_t repetitions = lines.size() / block;
+
+        // Keep as many repetitions in the table as it takes for the loop count to fit
+        std::size_t tableRepetitions = 1;
+        std::size_t loopCount = 0;
+        if (count != 0) {
+            constexpr std::size_t maxCount = std::numeric_limits<std::uint8_t>::max();
+            while (tableRepetitions < repetitions && (repetitions % tableRepetitions != 0 || (repetitions / tableRepetitions) * count > maxCount)) {
+                ++tableRepetitions;
+            }
+            loopCount = (repetitions / tableRepetitions) * count;
+        }
+
+        const std::size_t tableLength = block * tableRepetitions;
+        if (tableLength > TABLE_SIZE - startPos) {
+            return std::nullopt;
+        }
+
+        FoldedPattern pattern;
+        pattern.lines.assign(lines.begin(), lines.begin() + static_cast<std::ptrdiff_t>(tableLength));
+        pattern.startPos = startPos;
+        pattern.endPos = static_cast<std::uint8_t>(startPos + tableLength - 1);
+        pattern.count = static_cast<std::uint8_t>(loopCount);
+        return pattern;
+    }
+
+    bool PatternFolder::upload(Blink1Device& device, const FoldedPattern& pattern) noexcept {
+        if (pattern.lines.empty() || device.syncPattern(pattern.lines, pattern.startPos)) {
+            return false;
+        }
+        return device.playLoop(pattern.startPos, pattern.endPos, pattern.count);
+    }
+}
@@ -0,0 +1,182 @@
+#include "PatternSimplifier.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace blink1_lib {
+    using SimplifierColor = std::array<double, 3>;
+
+    static constexpr std::uint64_t MAX_FADE = std::numeric_limits<std::uint16_t>::max();
+
+    static SimplifierColor toColor(const RGB& rgb) noexcept {
+        return {static_cast<double>(rgb.r), static_cast<double>(rgb.g), static_cast<double>(rgb.b)};
+    }
+
+    static double toLinear(const double channel) noexcept {
+        const double c = channel / 255.0;
+        return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+    }
+
+    static double labCurve(const double t) noexcept {
+        constexpr double delta = 6.0 / 29.0;
+        return t > delta * delta * delta ? std::cbrt(t) : t / (3 * delta * delta) + 4.0 / 29.0;
+    }
+
+    // sRGB to CIELAB with a D65 white point
+    static SimplifierColor toLab(const SimplifierColor& rgb) noexcept {
+        const double r = toLinear(rgb[0]);
+        const double g = toLinear(rgb[1]);
+        const double b = toLinear(rgb[2]);
+
+        const double x = labCurve((0.4124564 * r + 0.3575761 * g + 0.1804375 * b) / 0.95047);
+        const double y = labCurve(0.2126729 * r + 0.7151522 * g + 0.0721750 * b);
+        const double z = labCurve((0.0193339 * r + 0.1191920 * g + 0.9503041 * b) / 1.08883);
+        return {116 * y - 16, 500 * (x - y), 200 * (y - z)};
+    }
+
+    static double colorDistance(const SimplifierColor& a, const SimplifierColor& b, const PatternSimplifier::COLOR_SPACE colorSpace) noexcept {
+        if (colorSpace == PatternSimplifier::COLOR_SPACE::CIELAB) {
+            const SimplifierColor labA = toLab(a);
+            const SimplifierColor labB = toLab(b);
+            return std::hypot(labA[0] - labB[0], labA[1] - labB[1], labA[2] - labB[2]);
+        }
+        return std::hypot(a[0] - b[0], a[1] - b[1], a[2] - b[2]);
+    }
+
+    PatternSimplifier::PatternSimplifier(const double _tolerance, const COLOR_SPACE _colorSpace) noexcept
+        : tolerance(_tolerance), colorSpace(_colorSpace)
+    {}
+
+    std::vector<bool> PatternSimplifier::keptLines(std::span<const RGB> colors, std::span<const std::uint16_t> fades) const {
+        const std::size_t count = colors.size();
+        std::vector<bool> kept(count, false);
+        if (count == 0) {
+            return kept;
+        }
+
+        // The time each line's color is reached
+        std::vector<std::uint64_t> times(count);
+        std::uint64_t time = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            time += fades[i];
+            times[i] = time;
+        }
+
+        kept.front() = true;
+        kept.back() = true;
+        std::vector<std::pair<std::size_t, std::size_t>> pending{{0, count - 1}};
+        while (!pending.empty()) {
+            const auto [from, to] = pending.back();
+            pending.pop_back();
+            if (to - from < 2) {
+                continue;
+            }
+
+            const auto length = times[to] - times[from];
+
+            std::size_t furthest = from + 1;
+            double furthestDistance = -1;
+            for (std::size_t i = from + 1; i < to; ++i) {
+                const double fraction = length > 0 ? static_cast<double>(times[i] - times[from]) / static_cast<double>(length) : 1.0;
+                const double distance = fadeError(colors[i], colors[from], colors[to], fraction, colorSpace);
+                if (distance > furthestDistance) {
+                    furthest = i;
+                    furthestDistance = distance;
+                }
+            }
+
+            // A fade that is too long for one line has to be split even if it's accurate enough
+            if (furthestDistance > tolerance || length > MAX_FADE) {
+                kept[furthest] = true;
+                pending.emplace_back(from, furthest);
+                pending.emplace_back(furthest, to);
+            }
+        }
+        return kept;
+    }
+
+    std::vector<PatternLine> PatternSimplifier::simplify(std::span<const PatternLine> lines) const {
+        std::vector<RGB> colors;
+        std::vector<std::uint16_t> fades;
+        colors.reserve(lines.size());
+        fades.reserve(lines.size());
+        for (const PatternLine& line : lines) {
+            colors.push_back(line.rgb);
+            fades.push_back(line.fadeMillis);
+        }
+
+        const std::vector<bool> kept = keptLines(colors, fades);
+        std::vector<PatternLine> simplified;
+        std::uint32_t fade = 0;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            fade += lines[i].fadeMillis;
+            if (kept[i]) {
+                simplified.emplace_back(lines[i].rgb, static_cast<std::uint16_t>(fade));
+                fade = 0;
+            }
+        }
+        return simplified;
+    }
+
+    std::vector<PatternLineN> PatternSimplifier::simplify(std::span<const PatternLineN> lines) const {
+        std::vector<PatternLineN> simplified;
+        std::vector<RGB> colors;
+        std::vector<std::uint16_t> fades;
+        std::size_t runStart = 0;
+        while (runStart < lines.size()) {
+            const std::uint8_t ledn = lines[runStart].rgbn.n;
+            std::size_t runEnd = runStart;
+            colors.clear();
+            fades.clear();
+            while (runEnd < lines.size() && lines[runEnd].rgbn.n == ledn) {
+                const RGBN& rgbn = lines[runEnd].rgbn;
+                colors.emplace_back(rgbn.r, rgbn.g, rgbn.b);
+                fades.push_back(lines[runEnd].fadeMillis);
+                ++runEnd;
+            }
+
+            const std::vector<bool> kept = keptLines(colors, fades);
+            std::uint32_t fade = 0;
+            for (std::size_t i = runStart; i < runEnd; ++i) {
+                fade += lines[i].fadeMillis;
+                if (kept[i - runStart]) {
+                    simplified.emplace_back(lines[i].rgbn, static_cast<std::uint16_t>(fade));
+                    fade = 0;
+                }
+            }
+            runStart = runEnd;
+        }
+        return simplified;
+    }
+
+    double PatternSimplifier::distance(const RGB& a, const RGB& b, const COLOR_SPACE colorSpace) noexcept {
+        return colorDistance(toColor(a), toColor(b), colorSpace);
+    }
+
+    double PatternSimplifier::fadeError(const RGB& color, const RGB& from, const RGB& to, const double fraction, const COLOR_SPACE colorSpace) noexcept {
+        const SimplifierColor start = toColor(from);
+        const SimplifierColor end = toColor(to);
+        const SimplifierColor expected{start[0] + (end[0] - start[0]) * fraction,
+                                       start[1] + (end[1] - start[1]) * fraction,
+                                       start[2] + (end[2] - start[2]) * fraction};
+        return colorDistance(toColor(color), expected, colorSpace);
+    }
+
+    void PatternSimplifier::setTolerance(const double _tolerance) noexcept {
+        tolerance = _tolerance;
+    }
+
+    double PatternSimplifier::getTolerance() const noexcept {
+        return tolerance;
+    }
+
+    void PatternSimplifier::setColorSpace(const COLOR_SPACE _colorSpace) noexcept {
+        colorSpace = _colorSpace;
+    }
+
+    PatternSimplifier::COLOR_SPACE PatternSimplifier::getColorSpace() const noexcept {
+        return colorSpace;
+    }
+}
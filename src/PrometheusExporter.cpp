@@ -0,0 +1,327 @@
+#include "PrometheusExporter.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string_view>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "DeviceMetrics.hpp"
+
+namespace blink1_lib {
+    // How long the serving thread waits for a connection before checking whether it should stop
+    static constexpr int ACCEPT_POLL_MILLIS = 100;
+
+    // How long to wait for a client to send its request before answering anyway
+    static constexpr int REQUEST_POLL_MILLIS = 100;
+
+    // Everything exported for one device, read up front so the output is consistent
+    struct DeviceSnapshot {
+        std::string serial;
+        bool up{false};
+        std::optional<DeviceMetrics> metrics;
+        std::uint64_t shadowCacheHits{0};
+        bool async{false};
+        std::size_t queueDepth{0};
+        std::size_t queueCapacity{0};
+        std::uint64_t coalescedWrites{0};
+    };
+
+    static std::string escapeLabel(const std::string_view value) {
+        std::string escaped;
+        escaped.reserve(value.size());
+        for (const char c : value) {
+            switch (c) {
+                case '\\': escaped += "\\\\"; break;
+                case '"':  escaped += "\\\""; break;
+                case '\n': escaped += "\\n";  break;
+                default:   escaped += c;      break;
+            }
+        }
+        return escaped;
+    }
+
+    static std::string formatValue(const double value) {
+        std::array<char, 32> buffer{};
+        const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+        return std::string(buffer.data(), result.ptr);
+    }
+
+    static double toSeconds(const std::chrono::nanoseconds duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    static void writeHeader(std::ostream& os, const std::string_view name, const std::string_view help, const std::string_view type) {
+        os << "# HELP " << name << ' ' << help << '\n'
+           << "# TYPE " << name << ' ' << type << '\n';
+    }
+
+    PrometheusExporter::~PrometheusExporter() {
+        stopServing();
+    }
+
+    bool PrometheusExporter::addSource(Source source) {
+        const Blink1Device& device = source.asyncDevice ? source.asyncDevice->getDevice() : *source.device;
+        std::lock_guard<std::mutex> lock(sourcesMutex);
+        for (const Source& existing : sources) {
+            const Blink1Device& existingDevice = existing.asyncDevice ? existing.asyncDevice->getDevice() : *existing.device;
+            // Samples with the same labels would make Prometheus reject the whole scrape
+            if (&existingDevice == &device || existing.serial == source.serial) {
+                return false;
+            }
+        }
+        sources.push_back(std::move(source));
+        return true;
+    }
+
+    bool PrometheusExporter::addDevice(std::shared_ptr<Blink1Device> device) {
+        const std::string serial(device->getSerial().value_or(""));
+        Source source{device, nullptr, escapeLabel(serial)};
+        if (!addSource(std::move(source))) {
+            return false;
+        }
+        device->setMetricsEnabled(true);
+        return true;
+    }
+
+    bool PrometheusExporter::addDevice(std::shared_ptr<AsyncBlink1Device> device) {
+        const std::string serial(device->getDevice().getSerial().value_or(""));
+        Source source{nullptr, device, escapeLabel(serial)};
+        if (!addSource(std::move(source))) {
+            return false;
+        }
+        device->getDevice().setMetricsEnabled(true);
+        return true;
+    }
+
+    void PrometheusExporter::clearDevices() {
+        std::lock_guard<std::mutex> lock(sourcesMutex);
+        sources.clear();
+    }
+
+    void PrometheusExporter::write(std::ostream& os) const {
+        std::vector<Source> currentSources;
+        {
+            std::lock_guard<std::mutex> lock(sourcesMutex);
+            currentSources = sources;
+        }
+
+        std::vector<DeviceSnapshot> snapshots;
+        snapshots.reserve(currentSources.size());
+        for (const Source& source : currentSources) {
+            const Blink1Device& device = source.asyncDevice ? source.asyncDevice->getDevice() : *source.device;
+            DeviceSnapshot& snapshot = snapshots.emplace_back();
+            snapshot.serial = source.serial;
+            // Derived from commands already sent, so scraping doesn't talk to the device
+            snapshot.up = device.good() && device.isResponding();
+            snapshot.metrics = device.getMetrics();
+            snapshot.shadowCacheHits = device.getShadowCacheHits();
+            if (source.asyncDevice) {
+                snapshot.async = true;
+                snapshot.queueDepth = source.asyncDevice->queueDepth();
+                snapshot.queueCapacity = source.asyncDevice->capacity();
+                snapshot.coalescedWrites = source.asyncDevice->coalescedCount();
+            }
+        }
+
+        // Writes one sample per operation for every device with metrics
+        auto writeOperations = [&os, &snapshots](const std::string_view name, auto value) {
+            for (const DeviceSnapshot& snapshot : snapshots) {
+                if (!snapshot.metrics) {
+                    continue;
+                }
+                for (std::size_t i = 0; i < DeviceMetrics::OPERATION_COUNT; ++i) {
+                    const auto operation = static_cast<DeviceMetrics::OPERATION>(i);
+                    os << name << "{serial=\"" << snapshot.serial << "\",operation=\"" << DeviceMetrics::getOperationName(operation) << "\"} "
+                       << value(snapshot.metrics->get(operation)) << '\n';
+                }
+            }
+        };
+
+        writeHeader(os, "blink1_up", "Whether the device responds to commands.", "gauge");
+        for (const DeviceSnapshot& snapshot : snapshots) {
+            os << "blink1_up{serial=\"" << snapshot.serial << "\"} " << (snapshot.up ? 1 : 0) << '\n';
+        }
+
+        writeHeader(os, "blink1_commands_total", "Commands sent to the device.", "counter");
+        writeOperations("blink1_commands_total", [](const DeviceMetrics::OperationMetrics& metrics) { return metrics.calls; });
+
+        writeHeader(os, "blink1_command_failures_total", "Commands sent to the device that failed.", "counter");
+        writeOperations("blink1_command_failures_total", [](const DeviceMetrics::OperationMetrics& metrics) { return metrics.failures; });
+
+        writeHeader(os, "blink1_command_latency_seconds", "How long commands sent to the device took.", "summary");
+        for (const DeviceSnapshot& snapshot : snapshots) {
+            if (!snapshot.metrics) {
+                continue;
+            }
+            for (std::size_t i = 0; i < DeviceMetrics::OPERATION_COUNT; ++i) {
+                const auto operation = static_cast<DeviceMetrics::OPERATION>(i);
+                const LatencyHistogram& latency = snapshot.metrics->get(operation).latency;
+                const std::string labels = "serial=\"" + snapshot.serial + "\",operation=\"" + std::string(DeviceMetrics::getOperationName(operation)) + "\"";
+                for (const double quantile : QUANTILES) {
+                    os << "blink1_command_latency_seconds{" << labels << ",quantile=\"" << formatValue(quantile) << "\"} "
+                       << formatValue(toSeconds(latency.percentile(quantile * 100))) << '\n';
+                }
+                os << "blink1_command_latency_seconds_sum{" << labels << "} " << formatValue(toSeconds(latency.sum())) << '\n';
+                os << "blink1_command_latency_seconds_count{" << labels << "} " << latency.count() << '\n';
+            }
+        }
+
+        writeHeader(os, "blink1_shadow_cache_hits_total", "Color writes skipped by the shadow cache.", "counter");
+        for (const DeviceSnapshot& snapshot : snapshots) {
+            os << "blink1_shadow_cache_hits_total{serial=\"" << snapshot.serial << "\"} " << snapshot.shadowCacheHits << '\n';
+        }
+
+        writeHeader(os, "blink1_queue_depth", "Commands waiting to be sent to the device.", "gauge");
+        for (const DeviceSnapshot& snapshot : snapshots) {
+            if (snapshot.async) {
+                os << "blink1_queue_depth{serial=\"" << snapshot.serial << "\"} " << snapshot.queueDepth << '\n';
+            }
+        }
+
+        writeHeader(os, "blink1_queue_capacity", "Most commands that can wait to be sent to the device.", "gauge");
+        for (const DeviceSnapshot& snapshot : snapshots) {
+            if (snapshot.async) {
+                os << "blink1_queue_capacity{serial=\"" << snapshot.serial << "\"} " << snapshot.queueCapacity << '\n';
+            }
+        }
+
+        writeHeader(os, "blink1_coalesced_writes_total", "Color writes replaced by a newer write before being sent.", "counter");
+        for (const DeviceSnapshot& snapshot : snapshots) {
+            if (snapshot.async) {
+                os << "blink1_coalesced_writes_total{serial=\"" << snapshot.serial << "\"} " << snapshot.coalescedWrites << '\n';
+            }
+        }
+    }
+
+    std::string PrometheusExporter::render() const {
+        std::ostringstream os;
+        write(os);
+        return os.str();
+    }
+
+    bool PrometheusExporter::writeTextfile(const std::string& path) const {
+        const std::string temporaryPath = path + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            write(file);
+            file.close();
+            if (!file) {
+                std::error_code error;
+                std::filesystem::remove(temporaryPath, error);
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, path, error);
+        if (error) {
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+        return true;
+    }
+
+    bool PrometheusExporter::serve(const std::string& path) {
+        std::lock_guard<std::mutex> lock(serveMutex);
+        sockaddr_un address{};
+        if (serving || path.empty() || path.size() >= sizeof(address.sun_path)) {
+            return false;
+        }
+
+        std::error_code error;
+        if (std::filesystem::is_socket(path, error)) {
+            std::filesystem::remove(path, error);
+        }
+
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return false;
+        }
+
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, path.size());
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        listenSocket = fd;
+        socketPath = path;
+        serving = true;
+        serveThread = std::thread(&PrometheusExporter::serveLoop, this);
+        return true;
+    }
+
+    void PrometheusExporter::stopServing() {
+        std::lock_guard<std::mutex> lock(serveMutex);
+        if (!serving) {
+            return;
+        }
+
+        serving = false;
+        serveThread.join();
+        ::close(listenSocket);
+        listenSocket = -1;
+
+        std::error_code error;
+        std::filesystem::remove(socketPath, error);
+        socketPath.clear();
+    }
+
+    bool PrometheusExporter::isServing() const noexcept {
+        return serving;
+    }
+
+    void PrometheusExporter::serveLoop() {
+        while (serving) {
+            pollfd listening{listenSocket, POLLIN, 0};
+            if (::poll(&listening, 1, ACCEPT_POLL_MILLIS) <= 0) {
+                continue;
+            }
+
+            const int connection = ::accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+            if (connection < 0) {
+                continue;
+            }
+            respond(connection);
+            ::close(connection);
+        }
+    }
+
+    void PrometheusExporter::respond(const int connection) const {
+        // The request is read and ignored, since every request gets the same answer
+        pollfd client{connection, POLLIN, 0};
+        if (::poll(&client, 1, REQUEST_POLL_MILLIS) > 0) {
+            std::array<char, 4096> request{};
+            [[maybe_unused]] const auto ignored = ::recv(connection, request.data(), request.size(), MSG_DONTWAIT);
+        }
+
+        const std::string body = render();
+        const std::string response = "HTTP/1.0 200 OK\r\n"
+                                     "Content-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                                     "\r\n" + body;
+
+        std::size_t sent = 0;
+        while (sent < response.size()) {
+            const auto result = ::send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (result <= 0) {
+                return;
+            }
+            sent += static_cast<std::size_t>(result);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "TraceReplayer.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace blink1_lib {
+    double TraceReplayer::Result::commandsPerSecond() const noexcept {
+        const std::chrono::duration<double> seconds = elapsed;
+        if (seconds.count() <= 0) {
+            return 0;
+        }
+        return static_cast<double>(commandsSent) / seconds.count();
+    }
+
+    TraceReplayer::TraceReplayer(Blink1Device& _device, std::shared_ptr<Clock> _clock)
+        : device(_device), clock(std::move(_clock))
+    {}
+
+    bool TraceReplayer::send(const CommandTrace::Entry& entry) noexcept {
+        const RGB rgb(entry.rgbn.r, entry.rgbn.g, entry.rgbn.b);
+        switch (entry.command) {
+            case CommandTrace::COMMAND::FADE_TO_RGB:
+                return device.fadeToRGB(entry.fadeMillis, rgb);
+            case CommandTrace::COMMAND::FADE_TO_RGBN:
+                return device.fadeToRGBN(entry.fadeMillis, entry.rgbn);
+            case CommandTrace::COMMAND::SET_RGB:
+                return device.setRGB(rgb);
+            case CommandTrace::COMMAND::SET_RGBN:
+                return device.setRGBN(entry.rgbn);
+            case CommandTrace::COMMAND::PLAY:
+                return device.play(entry.pos);
+            case CommandTrace::COMMAND::PLAY_LOOP:
+                return device.playLoop(entry.pos, entry.endPos, entry.count);
+            case CommandTrace::COMMAND::STOP:
+                return device.stop();
+            case CommandTrace::COMMAND::WRITE_PATTERN_LINE:
+                return device.writePatternLine(PatternLine(rgb, entry.fadeMillis), entry.pos);
+            case CommandTrace::COMMAND::WRITE_PATTERN_LINE_N:
+                return device.writePatternLineN(PatternLineN(entry.rgbn, entry.fadeMillis), entry.pos);
+            case CommandTrace::COMMAND::SAVE_PATTERN:
+                return device.savePattern();
+        }
+        return false;
+    }
+
+    // Returns start + offset, clamped to the latest time the clock can hold, since a very
+    // small speed scales recorded times far past it
+    static Clock::time_point deadlineAfter(const Clock::time_point start, const std::chrono::duration<double, std::micro> offset) noexcept {
+        if (!(offset < Clock::duration::max())) {
+            return Clock::time_point::max();
+        }
+        const auto scaled = std::chrono::duration_cast<Clock::duration>(offset);
+        if (scaled > Clock::time_point::max() - start) {
+            return Clock::time_point::max();
+        }
+        return start + scaled;
+    }
+
+    TraceReplayer::Result TraceReplayer::replay(const CommandTrace& trace, const double speed) {
+        // Written so that NaN also replays at MAX_SPEED
+        const bool timed = speed > 0 && std::isfinite(speed);
+
+        Result result;
+        const auto startTime = clock->now();
+        for (const auto& entry : trace.getEntries()) {
+            if (timed) {
+                clock->sleepUntil(deadlineAfter(startTime, entry.time / speed));
+            }
+
+            ++result.commandsSent;
+            if (!send(entry)) {
+                ++result.failures;
+            }
+        }
+        result.elapsed = clock->now() - startTime;
+        return result;
+    }
+}
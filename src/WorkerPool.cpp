@@ -0,0 +1,89 @@
+#include "WorkerPool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <latch>
+
+namespace blink1_lib {
+    WorkerPool::WorkerPool(std::size_t threadCount) {
+        if (threadCount == 0) {
+            threadCount = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back(&WorkerPool::run, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        taskAvailable.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void WorkerPool::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+
+            auto task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    void WorkerPool::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        taskAvailable.notify_one();
+    }
+
+    void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+        if (count == 0) {
+            return;
+        }
+
+        std::latch done(static_cast<std::ptrdiff_t>(count));
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (std::size_t i = 0; i < count; ++i) {
+                tasks.emplace_back([&task, &done, &errorMutex, &error, i] {
+                    try {
+                        task(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> errorLock(errorMutex);
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    done.count_down();
+                });
+            }
+        }
+        taskAvailable.notify_all();
+        done.wait();
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::size_t WorkerPool::size() const noexcept {
+        return workers.size();
+    }
+}
@@ -0,0 +1,246 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "AnimationEngine.hpp"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "Clock.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME AnimationEngine_test
+
+// 10 frames per second, so one frame every 100ms
+static constexpr double FRAME_RATE = 10;
+static constexpr auto FRAME_PERIOD = 100ms;
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+static bool waitForFrames(const AnimationEngine& engine, const std::uint64_t frames) {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (engine.getFrameCount() < frames) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestDefaults) {
+    AnimationEngine engine;
+    EXPECT_EQ(AnimationEngine::DEFAULT_FRAME_RATE, engine.getFrameRate());
+    EXPECT_EQ(0u, engine.playingCount());
+    EXPECT_EQ(0u, engine.getFrameCount());
+
+    AnimationEngine invalid(-1);
+    EXPECT_EQ(AnimationEngine::DEFAULT_FRAME_RATE, invalid.getFrameRate());
+
+    AnimationEngine notANumber(std::numeric_limits<double>::quiet_NaN());
+    EXPECT_EQ(AnimationEngine::DEFAULT_FRAME_RATE, notANumber.getFrameRate());
+}
+
+TEST_F(SUITE_NAME, TestClampsFrameRate) {
+    const std::array<PatternLineN, 2> keyframes{
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 255, 0, 1, 100)
+    };
+
+    AnimationEngine huge(1e300);
+    EXPECT_EQ(AnimationEngine::MAX_FRAME_RATE, huge.getFrameRate());
+
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        auto device = std::make_shared<Blink1Device>();
+        AnimationEngine engine(std::numeric_limits<double>::infinity(), clock);
+        EXPECT_EQ(AnimationEngine::MAX_FRAME_RATE, engine.getFrameRate());
+
+        engine.play(device, Animation(keyframes, true));
+        ASSERT_TRUE(waitForFrames(engine, 1));
+
+        // The next frame runs 9.5ms late, so the scheduler works out from the 1ms frame
+        // period that the nine frames after it have already passed
+        clock->advance(10500us);
+        ASSERT_TRUE(waitForFrames(engine, 2));
+        EXPECT_EQ(9u, engine.getSkippedFrameCount());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSendsOnlyKeyframeChanges) {
+    const std::array<PatternLineN, 3> keyframes{
+        PatternLineN(255, 0, 0, 1, 200),
+        PatternLineN(0, 0, 255, 1, 300),
+        PatternLineN(0, 255, 0, 2, 150)
+    };
+
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        auto device = std::make_shared<Blink1Device>();
+        AnimationEngine engine(FRAME_RATE, clock);
+        engine.play(device, Animation(keyframes));
+        EXPECT_TRUE(engine.isPlaying(*device));
+
+        ASSERT_TRUE(waitForFrames(engine, 1));
+        EXPECT_EQ(2u, engine.getCommandCount()) << "Expected one fade per track on the first frame";
+        EXPECT_EQ(RGB(255, 0, 0), fake_blink1_lib::GET_RGB(1));
+        EXPECT_EQ(200, fake_blink1_lib::GET_FADE_MILLIS(1));
+        EXPECT_EQ(RGB(0, 255, 0), fake_blink1_lib::GET_RGB(2));
+        EXPECT_EQ(150, fake_blink1_lib::GET_FADE_MILLIS(2));
+
+        clock->advance(FRAME_PERIOD);
+        ASSERT_TRUE(waitForFrames(engine, 2));
+        EXPECT_EQ(2u, engine.getCommandCount()) << "Expected nothing to be sent while the device is fading";
+
+        clock->advance(FRAME_PERIOD);
+        ASSERT_TRUE(waitForFrames(engine, 3));
+        EXPECT_EQ(3u, engine.getCommandCount());
+        EXPECT_EQ(RGB(0, 0, 255), fake_blink1_lib::GET_RGB(1));
+        EXPECT_EQ(300, fake_blink1_lib::GET_FADE_MILLIS(1));
+
+        clock->advance(3 * FRAME_PERIOD);
+        ASSERT_TRUE(waitForFrames(engine, 4));
+        EXPECT_EQ(3u, engine.getCommandCount());
+        EXPECT_FALSE(engine.isPlaying(*device)) << "Expected a finished animation to stop playing";
+        EXPECT_EQ(0u, engine.getFailedCommandCount());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSkipsLateFrames) {
+    const std::array<PatternLineN, 3> keyframes{
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 255, 0, 1, 100),
+        PatternLineN(0, 0, 255, 1, 100)
+    };
+
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        auto device = std::make_shared<Blink1Device>();
+        AnimationEngine engine(FRAME_RATE, clock);
+        engine.play(device, Animation(keyframes, true));
+        ASSERT_TRUE(waitForFrames(engine, 1));
+        EXPECT_EQ(1u, engine.getCommandCount());
+
+        // The next frame runs 250ms late, so the two frames after it have already passed
+        clock->advance(350ms);
+        ASSERT_TRUE(waitForFrames(engine, 2));
+        EXPECT_EQ(2u, engine.getSkippedFrameCount());
+
+        // The track has looped back to its first keyframe, which fades from the skipped last one
+        EXPECT_EQ(3u, engine.getCommandCount());
+        EXPECT_EQ(RGB(255, 0, 0), fake_blink1_lib::GET_RGB(1));
+        EXPECT_EQ(50, fake_blink1_lib::GET_FADE_MILLIS(1));
+
+        // Frames carry on from the skipped ones
+        clock->advance(49ms);
+        std::this_thread::sleep_for(20ms);
+        EXPECT_EQ(2u, engine.getFrameCount());
+        clock->advance(1ms);
+        ASSERT_TRUE(waitForFrames(engine, 3));
+        EXPECT_TRUE(engine.isPlaying(*device)) << "Expected a looping animation to keep playing";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestStop) {
+    const std::array<PatternLineN, 1> keyframes{PatternLineN(1, 2, 3, 1, 1000)};
+
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        auto device1 = std::make_shared<Blink1Device>();
+        auto device2 = std::make_shared<Blink1Device>();
+        AnimationEngine engine(FRAME_RATE, clock);
+        engine.play(device1, Animation(keyframes, true));
+        engine.play(device2, Animation(keyframes, true));
+        engine.play(device2, Animation(keyframes, true));
+        EXPECT_EQ(2u, engine.playingCount()) << "Expected playing again to replace the animation";
+
+        EXPECT_TRUE(engine.stop(*device1));
+        EXPECT_FALSE(engine.stop(*device1));
+        EXPECT_FALSE(engine.isPlaying(*device1));
+        EXPECT_TRUE(engine.isPlaying(*device2));
+
+        engine.stopAll();
+        EXPECT_EQ(0u, engine.playingCount());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestStopWaitsForFrame) {
+    const std::array<PatternLineN, 2> keyframes{
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 255, 0, 1, 100)
+    };
+
+    auto clock = std::make_shared<VirtualClock>();
+    fake_blink1_lib::SET_CLOCK(clock);
+    fake_blink1_lib::TimingModel timing;
+    timing.latency = 10ms;
+    fake_blink1_lib::SET_TIMING_MODEL(timing);
+    {
+        auto device = std::make_shared<Blink1Device>();
+        AnimationEngine engine(FRAME_RATE, clock);
+        engine.play(device, Animation(keyframes, true));
+
+        // The first frame's command is held up in the simulated USB latency
+        clock->waitForSleepers(1);
+        std::atomic<bool> stopped{false};
+        std::thread stopper([&engine, &device, &stopped] {
+            EXPECT_TRUE(engine.stop(*device));
+            stopped = true;
+        });
+        std::this_thread::sleep_for(20ms);
+        EXPECT_FALSE(stopped) << "Expected stop() to wait for the frame being sent";
+
+        clock->advance(10ms);
+        stopper.join();
+        EXPECT_EQ(1u, engine.getCommandCount());
+        EXPECT_EQ(RGB(255, 0, 0), fake_blink1_lib::GET_RGB(1));
+
+        // Nothing from the animation reaches the device once stop() has returned
+        fake_blink1_lib::SET_TIMING_MODEL(fake_blink1_lib::TimingModel());
+        EXPECT_TRUE(device->setRGB(RGB(1, 2, 3)));
+        clock->advance(5 * FRAME_PERIOD);
+        std::this_thread::sleep_for(20ms);
+        EXPECT_EQ(1u, engine.getCommandCount());
+        EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCountsFailures) {
+    const std::array<PatternLineN, 1> keyframes{PatternLineN(1, 2, 3, 1, 100)};
+
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        auto device = std::make_shared<Blink1Device>();
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        AnimationEngine engine(FRAME_RATE, clock);
+        engine.play(device, Animation(keyframes));
+        ASSERT_TRUE(waitForFrames(engine, 1));
+        EXPECT_EQ(1u, engine.getCommandCount());
+        EXPECT_EQ(1u, engine.getFailedCommandCount());
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,93 @@
+#include <array>
+#include <chrono>
+
+#include "gtest/gtest.h"
+#include "Animation.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME Animation_test
+
+static const std::array<PatternLineN, 4> KEYFRAMES{
+    PatternLineN(255, 0, 0, 1, 100),
+    PatternLineN(0, 255, 0, 1, 200),
+    PatternLineN(0, 0, 255, 2, 50),
+    PatternLineN(0, 0, 255, 1, 100)
+};
+
+TEST(SUITE_NAME, TestTracks) {
+    const Animation animation(KEYFRAMES);
+    EXPECT_FALSE(animation.empty());
+    EXPECT_FALSE(animation.isLooping());
+    EXPECT_EQ((std::vector<std::uint8_t>{1, 2}), animation.getLeds());
+    EXPECT_EQ(3u, animation.getTrack(1).size());
+    EXPECT_EQ(1u, animation.getTrack(2).size());
+    EXPECT_TRUE(animation.getTrack(3).empty());
+    EXPECT_EQ(400ms, animation.getDuration()) << "Expected the duration of the longest track";
+
+    EXPECT_TRUE(Animation().empty());
+    EXPECT_EQ(0ms, Animation().getDuration());
+}
+
+TEST(SUITE_NAME, TestSegmentAt) {
+    const Animation animation(KEYFRAMES);
+    EXPECT_FALSE(animation.segmentAt(3, 0ms));
+
+    auto segment = animation.segmentAt(1, 0ms);
+    ASSERT_TRUE(segment);
+    EXPECT_EQ(0u, segment->index);
+    EXPECT_EQ(KEYFRAMES[0], segment->keyframe);
+    EXPECT_FALSE(segment->previous);
+    EXPECT_EQ(100ms, segment->remaining);
+
+    segment = animation.segmentAt(1, 150ms + 500us);
+    ASSERT_TRUE(segment);
+    EXPECT_EQ(1u, segment->index);
+    EXPECT_EQ(KEYFRAMES[1], segment->keyframe);
+    EXPECT_EQ(KEYFRAMES[0], segment->previous);
+    EXPECT_EQ(150ms, segment->remaining) << "Expected the remaining time to be rounded up";
+
+    segment = animation.segmentAt(1, 1s);
+    ASSERT_TRUE(segment);
+    EXPECT_EQ(2u, segment->index);
+    EXPECT_EQ(KEYFRAMES[3], segment->keyframe);
+    EXPECT_EQ(0ms, segment->remaining) << "Expected a finished track to stay on its last keyframe";
+
+    segment = animation.segmentAt(2, 10ms);
+    ASSERT_TRUE(segment);
+    EXPECT_EQ(KEYFRAMES[2], segment->keyframe);
+    EXPECT_EQ(40ms, segment->remaining);
+}
+
+TEST(SUITE_NAME, TestLooping) {
+    Animation animation(KEYFRAMES);
+    animation.setLooping(true);
+    EXPECT_TRUE(animation.isLooping());
+
+    auto segment = animation.segmentAt(1, 450ms);
+    ASSERT_TRUE(segment);
+    EXPECT_EQ(3u, segment->index) << "Expected the index to keep counting once the track loops";
+    EXPECT_EQ(KEYFRAMES[0], segment->keyframe);
+    EXPECT_EQ(KEYFRAMES[3], segment->previous) << "Expected a looped track to fade from its last keyframe";
+    EXPECT_EQ(50ms, segment->remaining);
+
+    segment = animation.segmentAt(2, 120ms);
+    ASSERT_TRUE(segment);
+    EXPECT_EQ(2u, segment->index) << "Expected each track to loop on its own";
+    EXPECT_EQ(30ms, segment->remaining);
+}
+
+TEST(SUITE_NAME, TestIsFinished) {
+    Animation animation(KEYFRAMES);
+    EXPECT_FALSE(animation.isFinished(399ms));
+    EXPECT_TRUE(animation.isFinished(400ms));
+
+    animation.setLooping(true);
+    EXPECT_FALSE(animation.isFinished(1h));
+
+    Animation instant;
+    instant.addKeyframe(PatternLineN(1, 2, 3, 0, 0));
+    instant.setLooping(true);
+    EXPECT_TRUE(instant.isFinished(0ms)) << "Expected a looping animation with no length to finish straight away";
+}
@@ -0,0 +1,273 @@
+#include <future>
+
+#include "gtest/gtest.h"
+#include "AsyncBlink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME AsyncBlink1Device_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+// Keeps the I/O thread busy so that commands stay queued until unblock() is called
+class Blocker {
+    std::promise<void> release;
+    std::promise<void> started;
+
+    public:
+        std::future<bool> result;
+
+        explicit Blocker(AsyncBlink1Device& asyncDevice) {
+            std::shared_future<void> released = release.get_future().share();
+            result = asyncDevice.submit([this, released](Blink1Device&) {
+                started.set_value();
+                released.wait();
+                return true;
+            });
+            started.get_future().wait();
+        }
+
+        void unblock() {
+            release.set_value();
+            EXPECT_TRUE(result.get());
+        }
+};
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestFadeToRGB) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        RGB rgb(10, 11, 12);
+
+        auto ret = asyncDevice.fadeToRGB(100, rgb);
+
+        EXPECT_TRUE(ret.get()) << "Expected fadeToRGB to report success";
+        EXPECT_EQ(rgb, fake_blink1_lib::GET_RGB(0));
+        EXPECT_EQ(100, fake_blink1_lib::GET_FADE_MILLIS(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailureIsReported) {
+    {
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+
+        EXPECT_FALSE(asyncDevice.setRGB(RGB(1, 2, 3)).get()) << "Expected setRGB to report failure";
+        EXPECT_FALSE(asyncDevice.readPlayState().get()) << "Expected readPlayState to be empty";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCommandsRunInOrder) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        RGBN first(1, 2, 3, 2);
+        RGBN second(4, 5, 6, 2);
+
+        auto write1 = asyncDevice.setRGBN(first);
+        auto write2 = asyncDevice.setRGBN(second);
+        auto read = asyncDevice.readRGB(2);
+
+        EXPECT_TRUE(write1.get());
+        EXPECT_TRUE(write2.get());
+        auto actualRgb = read.get();
+        EXPECT_TRUE(actualRgb) << "Expected readRGB to return a value";
+        if (actualRgb) {
+            EXPECT_EQ(RGB(4, 5, 6), *actualRgb);
+        }
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestPatternCommands) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        PatternLineN line(1, 2, 3, 4, 5);
+
+        EXPECT_TRUE(asyncDevice.writePatternLineN(line, 7).get());
+        auto actualLine = asyncDevice.readPatternLineN(7).get();
+        EXPECT_TRUE(actualLine);
+        if (actualLine) {
+            EXPECT_EQ(line, *actualLine);
+        }
+
+        EXPECT_TRUE(asyncDevice.playLoop(1, 2, 3).get());
+        EXPECT_EQ(PlayState(true, 1, 2, 3, 0), fake_blink1_lib::GET_PLAY_STATE());
+        EXPECT_TRUE(asyncDevice.stop().get());
+        EXPECT_FALSE(fake_blink1_lib::GET_PLAY_STATE().playing);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestRejectWhenFull) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device, 1, AsyncBlink1Device::OVERFLOW_POLICY::REJECT);
+
+        Blocker blocker(asyncDevice);
+        auto queued = asyncDevice.setRGB(RGB(1, 1, 1));
+        auto rejected = asyncDevice.setRGB(RGB(2, 2, 2));
+
+        EXPECT_EQ(1, asyncDevice.queueDepth());
+        EXPECT_EQ(std::future_status::ready, rejected.wait_for(std::chrono::seconds(0))) << "Expected rejected command to complete immediately";
+        EXPECT_FALSE(rejected.get());
+
+        blocker.unblock();
+        EXPECT_TRUE(queued.get());
+        EXPECT_EQ(RGB(1, 1, 1), fake_blink1_lib::GET_RGB(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFlush) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+
+        for (std::uint8_t i = 0; i < 10; ++i) {
+            asyncDevice.setRGBN(RGBN(i, i, i, i));
+        }
+        asyncDevice.flush();
+
+        EXPECT_EQ(0, asyncDevice.queueDepth());
+        EXPECT_EQ(RGB(9, 9, 9), fake_blink1_lib::GET_RGB(9));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestDestructorDrainsQueue) {
+    std::future<bool> ret;
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        ret = asyncDevice.fadeToRGBN(10, RGBN(3, 4, 5, 1));
+    }
+    EXPECT_TRUE(ret.get()) << "Expected queued command to be sent before destruction";
+    EXPECT_EQ(RGB(3, 4, 5), fake_blink1_lib::GET_RGB(1));
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCoalescingDisabledByDefault) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        EXPECT_FALSE(asyncDevice.isCoalescing());
+
+        Blocker blocker(asyncDevice);
+        asyncDevice.setRGBN(RGBN(1, 1, 1, 1));
+        asyncDevice.setRGBN(RGBN(2, 2, 2, 1));
+
+        EXPECT_EQ(2, asyncDevice.queueDepth());
+        EXPECT_EQ(0, asyncDevice.coalescedCount());
+        blocker.unblock();
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCoalescePerLED) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        asyncDevice.setCoalescing(true);
+        EXPECT_TRUE(asyncDevice.isCoalescing());
+
+        Blocker blocker(asyncDevice);
+        auto write1 = asyncDevice.setRGBN(RGBN(1, 1, 1, 1));
+        auto write2 = asyncDevice.fadeToRGBN(10, RGBN(2, 2, 2, 2));
+        auto write3 = asyncDevice.fadeToRGBN(20, RGBN(3, 3, 3, 1));
+
+        EXPECT_EQ(2, asyncDevice.queueDepth());
+        EXPECT_EQ(1, asyncDevice.coalescedCount());
+        blocker.unblock();
+
+        EXPECT_TRUE(write1.get()) << "Expected superseded write to report the result of its replacement";
+        EXPECT_TRUE(write2.get());
+        EXPECT_TRUE(write3.get());
+        EXPECT_EQ(RGB(3, 3, 3), fake_blink1_lib::GET_RGB(1));
+        EXPECT_EQ(20, fake_blink1_lib::GET_FADE_MILLIS(1));
+        EXPECT_EQ(RGB(2, 2, 2), fake_blink1_lib::GET_RGB(2));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWholeDeviceWriteSupersedesPerLED) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        asyncDevice.setCoalescing(true);
+
+        Blocker blocker(asyncDevice);
+        auto write1 = asyncDevice.setRGBN(RGBN(1, 1, 1, 1));
+        auto write2 = asyncDevice.setRGBN(RGBN(2, 2, 2, 2));
+        auto write3 = asyncDevice.fadeToRGB(30, RGB(4, 5, 6));
+
+        EXPECT_EQ(1, asyncDevice.queueDepth());
+        EXPECT_EQ(2, asyncDevice.coalescedCount());
+        blocker.unblock();
+
+        EXPECT_TRUE(write1.get());
+        EXPECT_TRUE(write2.get());
+        EXPECT_TRUE(write3.get());
+        EXPECT_EQ(RGB(4, 5, 6), fake_blink1_lib::GET_RGB(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestPerLEDWriteDoesNotPassWholeDeviceWrite) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        asyncDevice.setCoalescing(true);
+
+        Blocker blocker(asyncDevice);
+        asyncDevice.setRGBN(RGBN(1, 1, 1, 1));
+        asyncDevice.setRGB(RGB(7, 7, 7));
+        asyncDevice.setRGBN(RGBN(2, 2, 2, 1));
+
+        EXPECT_EQ(2, asyncDevice.queueDepth());
+        EXPECT_EQ(1, asyncDevice.coalescedCount());
+        blocker.unblock();
+        asyncDevice.flush();
+
+        EXPECT_EQ(RGB(2, 2, 2), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestNoCoalescingAcrossOtherCommands) {
+    {
+        Blink1Device device;
+        AsyncBlink1Device asyncDevice(device);
+        asyncDevice.setCoalescing(true);
+
+        Blocker blocker(asyncDevice);
+        asyncDevice.setRGBN(RGBN(1, 1, 1, 1));
+        asyncDevice.play(0);
+        asyncDevice.setRGBN(RGBN(2, 2, 2, 1));
+        asyncDevice.setRGB(RGB(3, 3, 3));
+
+        EXPECT_EQ(3, asyncDevice.queueDepth());
+        EXPECT_EQ(1, asyncDevice.coalescedCount());
+        blocker.unblock();
+    }
+    checkDevicesFreed();
+}
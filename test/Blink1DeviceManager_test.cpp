@@ -0,0 +1,174 @@
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1DeviceManager.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1DeviceManager_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+            fake_blink1_lib::ADD_DEVICE("AAAA0001", "/dev/hidraw1");
+            fake_blink1_lib::ADD_DEVICE("AAAA0002", "/dev/hidraw2");
+            fake_blink1_lib::ADD_DEVICE("AAAA0003", "/dev/hidraw3");
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestEnumeratesOnce) {
+    {
+        Blink1DeviceManager manager;
+
+        EXPECT_EQ(1, fake_blink1_lib::GET_ENUMERATE_COUNT());
+        EXPECT_EQ(3, manager.deviceCount());
+        EXPECT_EQ((std::vector<std::string>{"AAAA0001", "AAAA0002", "AAAA0003"}), manager.getSerials());
+
+        auto info = manager.find("AAAA0002");
+        EXPECT_TRUE(info);
+        if (info) {
+            EXPECT_EQ("AAAA0002", info->serial);
+            EXPECT_EQ("/dev/hidraw2", info->path);
+            EXPECT_EQ(1, info->id);
+        }
+        EXPECT_FALSE(manager.find("BBBB0001"));
+
+        EXPECT_TRUE(manager.get("AAAA0001"));
+        EXPECT_TRUE(manager.get("AAAA0003"));
+        EXPECT_EQ(1, fake_blink1_lib::GET_ENUMERATE_COUNT()) << "Expected lookups of known devices not to enumerate again";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestGetReturnsCachedHandle) {
+    {
+        Blink1DeviceManager manager;
+
+        auto device1 = manager.get("AAAA0001");
+        auto device2 = manager.get("AAAA0001");
+
+        EXPECT_TRUE(device1);
+        EXPECT_EQ(device1, device2) << "Expected the same handle to be returned for the same serial";
+        EXPECT_NE(device1, manager.get("AAAA0002"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestUnknownSerialRefreshes) {
+    {
+        Blink1DeviceManager manager;
+        EXPECT_FALSE(manager.get("BBBB0001"));
+        EXPECT_EQ(2, fake_blink1_lib::GET_ENUMERATE_COUNT());
+
+        fake_blink1_lib::ADD_DEVICE("BBBB0001", "/dev/hidraw4");
+        EXPECT_TRUE(manager.get("BBBB0001")) << "Expected a newly connected device to be found";
+        EXPECT_EQ(3, fake_blink1_lib::GET_ENUMERATE_COUNT());
+        EXPECT_EQ(4, manager.deviceCount());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestOpenAll) {
+    {
+        Blink1DeviceManager manager;
+        auto first = manager.get("AAAA0002");
+
+        auto devices = manager.openAll();
+
+        ASSERT_EQ(3, devices.size());
+        for (const auto& device : devices) {
+            EXPECT_TRUE(device && device->good());
+        }
+        EXPECT_EQ(first, devices[1]) << "Expected an already open device to be reused";
+        EXPECT_EQ(devices[2], manager.get("AAAA0003"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestOpenFailure) {
+    {
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(false);
+        Blink1DeviceManager manager;
+
+        EXPECT_FALSE(manager.get("AAAA0001"));
+        EXPECT_TRUE(manager.openAll().empty());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestRefreshDropsRemovedDevices) {
+    std::shared_ptr<Blink1Device> held;
+    {
+        Blink1DeviceManager manager;
+        held = manager.get("AAAA0003");
+        manager.get("AAAA0001");
+
+        fake_blink1_lib::REMOVE_DEVICE("AAAA0003");
+        EXPECT_EQ(2, manager.refresh());
+        EXPECT_FALSE(manager.find("AAAA0003"));
+        EXPECT_TRUE(held) << "Expected handles held by callers to stay valid";
+    }
+    EXPECT_FALSE(fake_blink1_lib::ALL_DEVICES_FREED());
+    held.reset();
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReopensStaleHandle) {
+    {
+        Blink1DeviceManager manager;
+        auto device = manager.get("AAAA0002");
+        ASSERT_TRUE(device);
+
+        fake_blink1_lib::DISCONNECT("AAAA0002");
+        EXPECT_EQ(device, manager.get("AAAA0002")) << "Expected the handle to be kept until a command fails";
+        EXPECT_FALSE(device->setRGB(RGB(1, 2, 3)));
+        EXPECT_FALSE(manager.get("AAAA0002")) << "Expected an unplugged device not to be handed out";
+        EXPECT_EQ(2, fake_blink1_lib::GET_ENUMERATE_COUNT()) << "Expected a stale handle to enumerate again";
+
+        fake_blink1_lib::RECONNECT("AAAA0002");
+        auto reopened = manager.get("AAAA0002");
+        ASSERT_TRUE(reopened);
+        EXPECT_NE(device, reopened);
+        EXPECT_TRUE(reopened->setRGB(RGB(1, 2, 3)));
+        EXPECT_EQ(reopened, manager.get("AAAA0002"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestStaleHandleOfRemovedDevice) {
+    {
+        Blink1DeviceManager manager;
+        auto device = manager.get("AAAA0002");
+        ASSERT_TRUE(device);
+
+        fake_blink1_lib::DISCONNECT("AAAA0002");
+        fake_blink1_lib::REMOVE_DEVICE("AAAA0002");
+        EXPECT_FALSE(device->setRGB(RGB(1, 2, 3)));
+        EXPECT_FALSE(manager.get("AAAA0002")) << "Expected a device that is no longer enumerated not to be found";
+        EXPECT_FALSE(manager.find("AAAA0002"));
+        EXPECT_EQ(2, fake_blink1_lib::GET_ENUMERATE_COUNT()) << "Expected the bus to be enumerated only once more";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestClose) {
+    {
+        Blink1DeviceManager manager;
+        manager.get("AAAA0001");
+        manager.close("AAAA0001");
+        EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED());
+    }
+    checkDevicesFreed();
+}
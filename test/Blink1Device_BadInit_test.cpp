@@ -1,4 +1,5 @@
 #include <sstream>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "Blink1Device.hpp"
@@ -190,6 +191,29 @@ TEST_F(SUITE_NAME, TestReadPatternLineN) {
     checkDevicesFreed();
 }
 
+TEST_F(SUITE_NAME, TestWritePattern) {
+    {
+        Blink1Device device;
+
+        std::vector<PatternLineN> lines{PatternLineN(1, 2, 3, 4, 5), PatternLineN(6, 7, 8, 9, 10)};
+        auto failedPos = device.writePattern(lines, 20);
+        EXPECT_TRUE(failedPos);
+        if (failedPos) {
+            EXPECT_EQ(20, *failedPos);
+        }
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReadPattern) {
+    {
+        Blink1Device device;
+        auto actualLines = device.readPattern(20, 2);
+        EXPECT_FALSE(actualLines);
+    }
+    checkDevicesFreed();
+}
+
 TEST_F(SUITE_NAME, TestSavePattern) {
     {
         Blink1Device device;
@@ -1,4 +1,7 @@
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <thread>
 
 #include "gtest/gtest.h"
 #include "Blink1Device.hpp"
@@ -56,6 +59,29 @@ TEST_F(SUITE_NAME, TestBlocking) {
     EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(timeAfterFadeRgbn - currentTime).count(), 100) << "Expected fadeToRGBN to take at least 100ms";
 }
 
+TEST_F(SUITE_NAME, TestBlockingWithVirtualClock) {
+    auto clock = std::make_shared<VirtualClock>();
+
+    Blink1Device device;
+    device.setClock(clock);
+    device.setBlocking();
+
+    std::atomic<bool> done{false};
+    std::thread fader([&device, &done] {
+        EXPECT_TRUE(device.fadeToRGB(10000, RGB(10, 11, 12)));
+        done = true;
+    });
+
+    clock->waitForSleepers(1);
+    clock->advance(std::chrono::milliseconds(9999));
+    EXPECT_FALSE(done.load()) << "Expected fadeToRGB to wait for the whole fade";
+    EXPECT_EQ(1, clock->sleeperCount());
+
+    clock->advance(std::chrono::milliseconds(1));
+    fader.join();
+    EXPECT_TRUE(done.load());
+}
+
 TEST_F(SUITE_NAME, TestNonBlocking) {
     RGB rgb(10, 11, 12);
     RGBN rgbn(10, 11, 12, 20);
@@ -0,0 +1,142 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1Device_FadeWait_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestDeadlines) {
+    {
+        Blink1Device device;
+        EXPECT_LE(device.getFadeDeadline(), std::chrono::steady_clock::now()) << "Expected no fade to be in progress";
+
+        const auto before = std::chrono::steady_clock::now();
+        EXPECT_TRUE(device.fadeToRGB(100, RGB(1, 2, 3)));
+        EXPECT_TRUE(device.fadeToRGBN(300, RGBN(1, 2, 3, 2)));
+        const auto after = std::chrono::steady_clock::now();
+
+        EXPECT_GE(device.getFadeDeadline(1), before + std::chrono::milliseconds(100));
+        EXPECT_LE(device.getFadeDeadline(1), after + std::chrono::milliseconds(100));
+        EXPECT_GE(device.getFadeDeadline(2), before + std::chrono::milliseconds(300));
+        EXPECT_EQ(device.getFadeDeadline(2), device.getFadeDeadline(0)) << "Expected LED 0 to report the latest deadline";
+
+        EXPECT_TRUE(device.setRGB(RGB(4, 5, 6)));
+        EXPECT_LE(device.getFadeDeadline(), std::chrono::steady_clock::now()) << "Expected setRGB to end every fade";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailedFadeIsNotTracked) {
+    {
+        Blink1Device device;
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_FALSE(device.fadeToRGB(1000, RGB(1, 2, 3)));
+        EXPECT_LE(device.getFadeDeadline(), std::chrono::steady_clock::now());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWaitForFade) {
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.fadeToRGBN(100, RGBN(1, 2, 3, 1)));
+
+        EXPECT_FALSE(device.waitForFade(1, std::chrono::milliseconds(10))) << "Expected the wait to time out";
+        EXPECT_TRUE(device.waitForFade(1, std::chrono::seconds(5)));
+        EXPECT_LE(device.getFadeDeadline(1), std::chrono::steady_clock::now());
+
+        EXPECT_TRUE(device.waitForFade(2, std::chrono::milliseconds(0))) << "Expected an LED with no fade not to wait";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWhenFadeComplete) {
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.fadeToRGB(100, RGB(1, 2, 3)));
+        const auto deadline = device.getFadeDeadline();
+
+        auto future = device.whenFadeComplete();
+        EXPECT_EQ(std::future_status::timeout, future.wait_for(std::chrono::milliseconds(0)));
+        EXPECT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(5)));
+        EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestOnFadeComplete) {
+    std::promise<void> done;
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.fadeToRGBN(50, RGBN(1, 2, 3, 4)));
+        device.onFadeComplete(4, [&done] { done.set_value(); });
+    }
+    checkDevicesFreed();
+    EXPECT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5))) << "Expected the callback to run after the device is destroyed";
+}
+
+TEST_F(SUITE_NAME, TestManyConcurrentFades) {
+    {
+        Blink1Device device;
+        std::atomic<int> completed{0};
+        std::promise<void> allDone;
+
+        for (std::uint8_t i = 1; i <= 200; ++i) {
+            EXPECT_TRUE(device.fadeToRGBN(static_cast<std::uint16_t>(i), RGBN(i, i, i, i)));
+            device.onFadeComplete(i, [&completed, &allDone] {
+                if (++completed == 200) {
+                    allDone.set_value();
+                }
+            });
+        }
+
+        EXPECT_EQ(std::future_status::ready, allDone.get_future().wait_for(std::chrono::seconds(5)));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestVirtualClock) {
+    {
+        auto clock = std::make_shared<VirtualClock>();
+        Blink1Device device;
+        device.setClock(clock);
+        EXPECT_EQ(clock, device.getClock());
+
+        EXPECT_TRUE(device.fadeToRGBN(60000, RGBN(1, 2, 3, 1)));
+        EXPECT_EQ(clock->now() + std::chrono::minutes(1), device.getFadeDeadline(1));
+
+        auto future = device.whenFadeComplete(1);
+        clock->advance(std::chrono::seconds(59));
+        EXPECT_EQ(std::future_status::timeout, future.wait_for(std::chrono::milliseconds(20)));
+
+        clock->advance(std::chrono::seconds(1));
+        EXPECT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(5)));
+        EXPECT_TRUE(device.waitForFade(1, std::chrono::milliseconds(0)));
+
+        device.setClock(nullptr);
+        EXPECT_EQ(Clock::steady(), device.getClock());
+    }
+    checkDevicesFreed();
+}
@@ -1,4 +1,6 @@
+#include <cstdint>
 #include <sstream>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "Blink1Device.hpp"
@@ -299,6 +301,64 @@ TEST_F(SUITE_NAME, TestReadPatternLineN) {
     checkDevicesFreed();
 }
 
+TEST_F(SUITE_NAME, TestWritePattern) {
+    {
+        Blink1Device device;
+
+        std::vector<PatternLineN> lines{
+            PatternLineN(1, 2, 3, 1, 5),
+            PatternLineN(6, 7, 8, 1, 10),
+            PatternLineN(9, 10, 11, 2, 15)
+        };
+        auto failedPos = device.writePattern(lines, 20);
+
+        EXPECT_FALSE(failedPos) << "Expected every line to be written";
+        EXPECT_EQ(lines[0], fake_blink1_lib::GET_PATTERN_LINE(20));
+        EXPECT_EQ(lines[1], fake_blink1_lib::GET_PATTERN_LINE(21));
+        EXPECT_EQ(lines[2], fake_blink1_lib::GET_PATTERN_LINE(22));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWritePatternPastEnd) {
+    {
+        Blink1Device device;
+
+        std::vector<PatternLineN> lines{PatternLineN(1, 2, 3, 1, 5), PatternLineN(6, 7, 8, 1, 10)};
+        auto failedPos = device.writePattern(lines, 255);
+
+        EXPECT_TRUE(failedPos);
+        if (failedPos) {
+            EXPECT_EQ(256, *failedPos);
+        }
+        EXPECT_EQ(lines[0], fake_blink1_lib::GET_PATTERN_LINE(255));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReadPattern) {
+    {
+        Blink1Device device;
+
+        PatternLineN line1(1, 2, 3, 4, 5);
+        PatternLineN line2(6, 7, 8, 9, 10);
+        fake_blink1_lib::SET_PATTERN_LINE(line1, 20);
+        fake_blink1_lib::SET_PATTERN_LINE(line2, 21);
+
+        auto actualLines = device.readPattern(20, 2);
+        EXPECT_TRUE(actualLines);
+        if (actualLines) {
+            ASSERT_EQ(2, actualLines->size());
+            EXPECT_EQ(line1, (*actualLines)[0]);
+            EXPECT_EQ(line2, (*actualLines)[1]);
+        }
+
+        EXPECT_FALSE(device.readPattern(255, 2)) << "Expected reading past the end of the pattern to fail";
+        EXPECT_FALSE(device.readPattern(1, SIZE_MAX)) << "Expected a count that overflows to fail";
+    }
+    checkDevicesFreed();
+}
+
 TEST_F(SUITE_NAME, TestSavePattern) {
     {
         Blink1Device device;
@@ -0,0 +1,241 @@
+#include <array>
+#include <chrono>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "DeviceMetrics.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME Blink1Device_Metrics_test
+
+using OPERATION = DeviceMetrics::OPERATION;
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestDisabledByDefault) {
+    {
+        Blink1Device device;
+        EXPECT_FALSE(device.isMetricsEnabled());
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_FALSE(device.getMetrics());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCountsEachOperation) {
+    {
+        Blink1Device device;
+        device.setMetricsEnabled(true);
+        EXPECT_TRUE(device.isMetricsEnabled());
+
+        EXPECT_TRUE(device.fadeToRGB(0, RGB(1, 2, 3)));
+        EXPECT_TRUE(device.fadeToRGBN(0, RGBN(1, 2, 3, 1)));
+        EXPECT_TRUE(device.setRGBN(RGBN(1, 2, 3, 2)));
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device.readRGB(1));
+        EXPECT_TRUE(device.readRGBWithFade(1));
+        EXPECT_TRUE(device.play(0));
+        EXPECT_TRUE(device.playLoop(0, 1, 2));
+        EXPECT_TRUE(device.stop());
+        EXPECT_TRUE(device.readPlayState());
+        EXPECT_TRUE(device.writePatternLine(PatternLine(1, 2, 3, 4), 0));
+        EXPECT_TRUE(device.writePatternLineN(PatternLineN(1, 2, 3, 4, 1), 1));
+        EXPECT_TRUE(device.readPatternLine(0));
+        EXPECT_TRUE(device.readPatternLineN(1));
+        EXPECT_TRUE(device.savePattern());
+        EXPECT_TRUE(device.getVersion());
+
+        const auto metrics = device.getMetrics();
+        ASSERT_TRUE(metrics);
+        EXPECT_EQ(1, metrics->get(OPERATION::FADE_TO_RGB).calls);
+        EXPECT_EQ(2, metrics->get(OPERATION::FADE_TO_RGBN).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::SET_RGB).calls);
+        EXPECT_EQ(2, metrics->get(OPERATION::READ_RGB_WITH_FADE).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::PLAY).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::PLAY_LOOP).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::STOP).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::READ_PLAY_STATE).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::WRITE_PATTERN_LINE).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::WRITE_PATTERN_LINE_N).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::READ_PATTERN_LINE).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::READ_PATTERN_LINE_N).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::SAVE_PATTERN).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::GET_VERSION).calls);
+        EXPECT_EQ(16, metrics->totalCalls());
+        EXPECT_EQ(0, metrics->totalFailures());
+        EXPECT_EQ(2, metrics->get(OPERATION::FADE_TO_RGBN).latency.count());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCountsFailures) {
+    fake_blink1_lib::FaultModel model;
+    model.failingFunctions = {fake_blink1_lib::BLINK1_FUNCTION::SET_RGB};
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+
+    {
+        Blink1Device device;
+        device.setMetricsEnabled(true);
+        EXPECT_FALSE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_FALSE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device.fadeToRGB(0, RGB(1, 2, 3)));
+
+        const auto metrics = device.getMetrics();
+        ASSERT_TRUE(metrics);
+        EXPECT_EQ(2, metrics->get(OPERATION::SET_RGB).calls);
+        EXPECT_EQ(2, metrics->get(OPERATION::SET_RGB).failures);
+        EXPECT_EQ(2, metrics->get(OPERATION::SET_RGB).latency.count()) << "Expected failed calls to be timed too";
+        EXPECT_EQ(0, metrics->get(OPERATION::FADE_TO_RGB).failures);
+        EXPECT_EQ(2, metrics->totalFailures());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestIsResponding) {
+    fake_blink1_lib::FaultModel model;
+    model.failingFunctions = {fake_blink1_lib::BLINK1_FUNCTION::SET_RGB};
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+
+    {
+        // Tracked whether or not metrics are enabled
+        Blink1Device device;
+        EXPECT_TRUE(device.isResponding()) << "Expected a device nothing was sent to to be responding";
+        EXPECT_FALSE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_FALSE(device.isResponding());
+        EXPECT_TRUE(device.fadeToRGB(0, RGB(1, 2, 3)));
+        EXPECT_TRUE(device.isResponding());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestMeasuresLatency) {
+    fake_blink1_lib::TimingModel model;
+    model.latency = 500us;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    {
+        Blink1Device device;
+        device.setMetricsEnabled(true);
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_TRUE(device.readPlayState());
+        }
+
+        const auto metrics = device.getMetrics();
+        ASSERT_TRUE(metrics);
+        const auto& latency = metrics->get(OPERATION::READ_PLAY_STATE).latency;
+        EXPECT_EQ(10, latency.count());
+        EXPECT_GE(latency.min(), 500us);
+        EXPECT_GE(latency.percentile(99), 500us);
+        EXPECT_LT(latency.percentile(50), 1s);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestUsesDeviceClock) {
+    // Nothing advances the virtual clock, so every call should take no time at all
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        Blink1Device device;
+        device.setClock(clock);
+        device.setMetricsEnabled(true);
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+
+        const auto metrics = device.getMetrics();
+        ASSERT_TRUE(metrics);
+        EXPECT_EQ(0ns, metrics->get(OPERATION::SET_RGB).latency.max());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSkippedWritesAreNotCounted) {
+    {
+        Blink1Device device;
+        device.setMetricsEnabled(true);
+        device.setShadowCache(true);
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device.savePattern());
+        EXPECT_TRUE(device.savePatternIfChanged());
+
+        const auto metrics = device.getMetrics();
+        ASSERT_TRUE(metrics);
+        EXPECT_EQ(1, metrics->get(OPERATION::SET_RGB).calls);
+        EXPECT_EQ(1, metrics->get(OPERATION::SAVE_PATTERN).calls);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestBatchWritesCountEachLine) {
+    const std::array<PatternLineN, 3> lines{PatternLineN(1, 2, 3, 4, 1), PatternLineN(1, 2, 3, 4, 1), PatternLineN(1, 2, 3, 4, 2)};
+    {
+        Blink1Device device;
+        device.setMetricsEnabled(true);
+        EXPECT_FALSE(device.writePattern(lines, 0));
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+
+        const auto metrics = device.getMetrics();
+        ASSERT_TRUE(metrics);
+        EXPECT_EQ(3, metrics->get(OPERATION::WRITE_PATTERN_LINE_N).calls) << "Expected lines skipped by syncPattern not to be counted";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSnapshotAndReset) {
+    {
+        Blink1Device device;
+        device.setMetricsEnabled(true);
+        EXPECT_TRUE(device.stop());
+
+        const auto snapshot = device.getMetrics();
+        EXPECT_TRUE(device.stop());
+        ASSERT_TRUE(snapshot);
+        EXPECT_EQ(1, snapshot->get(OPERATION::STOP).calls) << "Expected the snapshot not to change";
+
+        device.setMetricsEnabled(true);
+        EXPECT_EQ(2, device.getMetrics()->get(OPERATION::STOP).calls) << "Expected re-enabling to keep the metrics";
+
+        device.resetMetrics();
+        EXPECT_EQ(0, device.getMetrics()->totalCalls());
+        EXPECT_TRUE(device.isMetricsEnabled());
+
+        EXPECT_TRUE(device.stop());
+        device.setMetricsEnabled(false);
+        EXPECT_FALSE(device.getMetrics());
+        device.setMetricsEnabled(true);
+        EXPECT_EQ(0, device.getMetrics()->totalCalls()) << "Expected disabling to discard the metrics";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestMergeMetrics) {
+    DeviceMetrics first;
+    DeviceMetrics second;
+    first.record(OPERATION::PLAY, true, 1ms);
+    second.record(OPERATION::PLAY, false, 3ms);
+    second.record(OPERATION::STOP, true, 2ms);
+
+    first.merge(second);
+    EXPECT_EQ(2, first.get(OPERATION::PLAY).calls);
+    EXPECT_EQ(1, first.get(OPERATION::PLAY).failures);
+    EXPECT_EQ(3ms, first.get(OPERATION::PLAY).latency.max());
+    EXPECT_EQ(3, first.totalCalls());
+    EXPECT_EQ("play_loop", DeviceMetrics::getOperationName(OPERATION::PLAY_LOOP));
+}
@@ -0,0 +1,158 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1Device_PatternMirror_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+// Written to the simulated pattern behind the device's back, so if a slot still holds
+// the marker afterwards, syncPattern must have skipped it
+static const PatternLineN MARKER(99, 98, 97, 1, 1234);
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        const std::vector<PatternLineN> lines{
+            PatternLineN(1, 2, 3, 1, 100),
+            PatternLineN(4, 5, 6, 1, 200),
+            PatternLineN(7, 8, 9, 2, 300)
+        };
+
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestSyncWritesUnknownLines) {
+    {
+        Blink1Device device;
+
+        EXPECT_FALSE(device.syncPattern(lines, 5));
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            EXPECT_EQ(lines[i], fake_blink1_lib::GET_PATTERN_LINE(static_cast<long>(5 + i)));
+            EXPECT_EQ(lines[i], device.getMirroredPatternLine(static_cast<std::uint8_t>(5 + i)));
+        }
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSyncWritesOnlyChangedLines) {
+    {
+        Blink1Device device;
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+
+        fake_blink1_lib::SET_PATTERN_LINE(MARKER, 0);
+        fake_blink1_lib::SET_PATTERN_LINE(MARKER, 1);
+        fake_blink1_lib::SET_PATTERN_LINE(MARKER, 2);
+
+        auto newLines = lines;
+        newLines[1] = PatternLineN(10, 11, 12, 2, 400);
+        EXPECT_FALSE(device.syncPattern(newLines, 0));
+
+        EXPECT_EQ(MARKER, fake_blink1_lib::GET_PATTERN_LINE(0)) << "Expected unchanged line to be skipped";
+        EXPECT_EQ(newLines[1], fake_blink1_lib::GET_PATTERN_LINE(1));
+        EXPECT_EQ(MARKER, fake_blink1_lib::GET_PATTERN_LINE(2)) << "Expected unchanged line to be skipped";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReadFillsMirror) {
+    {
+        Blink1Device device;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            fake_blink1_lib::SET_PATTERN_LINE(lines[i], static_cast<long>(i));
+        }
+        EXPECT_TRUE(device.readPattern(0, lines.size()));
+
+        fake_blink1_lib::SET_PATTERN_LINE(MARKER, 0);
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+
+        EXPECT_EQ(MARKER, fake_blink1_lib::GET_PATTERN_LINE(0)) << "Expected line read from the device to be skipped";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestClearPatternMirror) {
+    {
+        Blink1Device device;
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+
+        device.clearPatternMirror();
+        EXPECT_FALSE(device.getMirroredPatternLine(0));
+
+        fake_blink1_lib::SET_PATTERN_LINE(MARKER, 0);
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+        EXPECT_EQ(lines[0], fake_blink1_lib::GET_PATTERN_LINE(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWritePatternLineForgetsMirroredLine) {
+    {
+        Blink1Device device;
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+
+        EXPECT_TRUE(device.writePatternLine(PatternLine(1, 2, 3, 100), 0));
+        EXPECT_FALSE(device.getMirroredPatternLine(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailedSyncReportsPosition) {
+    {
+        Blink1Device device;
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+
+        auto failedPos = device.syncPattern(lines, 7);
+        EXPECT_TRUE(failedPos);
+        if (failedPos) {
+            EXPECT_EQ(7, *failedPos);
+        }
+        EXPECT_FALSE(device.getMirroredPatternLine(7));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSaveOnlyAfterChange) {
+    {
+        Blink1Device device;
+
+        // Failing operations make it visible whether the save reached the device
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_FALSE(device.savePatternIfChanged()) << "Expected first save to be sent";
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+        EXPECT_TRUE(device.savePatternIfChanged());
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_TRUE(device.savePatternIfChanged()) << "Expected save without changes to be skipped";
+        EXPECT_FALSE(device.savePattern()) << "Expected an explicit save to always be sent";
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+        EXPECT_TRUE(device.savePatternIfChanged());
+        EXPECT_FALSE(device.syncPattern(lines, 0));
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_TRUE(device.savePatternIfChanged()) << "Expected save after a no-op sync to be skipped";
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+        auto newLines = lines;
+        newLines[0].fadeMillis = 50;
+        EXPECT_FALSE(device.syncPattern(newLines, 0));
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_FALSE(device.savePatternIfChanged()) << "Expected save after a change to be sent";
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1Device_ShadowCache_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+// The simulated LED is changed behind the device's back, so if the color reads back
+// as the marker afterwards, the write must have been skipped
+static const RGB MARKER(99, 98, 97);
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestDisabledByDefault) {
+    {
+        Blink1Device device;
+        EXPECT_FALSE(device.isShadowCacheEnabled());
+
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        fake_blink1_lib::SET_RGB(MARKER, 0);
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+
+        EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB(0)) << "Expected write to be sent with the cache disabled";
+        EXPECT_EQ(0, device.getShadowCacheHits());
+        EXPECT_EQ(0, device.getShadowCacheMisses());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSkipsRepeatedFadeToRGBN) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+        EXPECT_TRUE(device.isShadowCacheEnabled());
+
+        EXPECT_TRUE(device.fadeToRGBN(50, RGBN(1, 2, 3, 1)));
+        fake_blink1_lib::SET_RGB(MARKER, 1);
+        EXPECT_TRUE(device.fadeToRGBN(50, RGBN(1, 2, 3, 1)));
+
+        EXPECT_EQ(MARKER, fake_blink1_lib::GET_RGB(1)) << "Expected repeated write to be skipped";
+        EXPECT_EQ(1, device.getShadowCacheHits());
+        EXPECT_EQ(1, device.getShadowCacheMisses());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestDifferentFadeMillisIsSent) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+
+        EXPECT_TRUE(device.fadeToRGBN(50, RGBN(1, 2, 3, 1)));
+        fake_blink1_lib::SET_RGB(MARKER, 1);
+        EXPECT_TRUE(device.fadeToRGBN(60, RGBN(1, 2, 3, 1)));
+
+        EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB(1));
+        EXPECT_EQ(0, device.getShadowCacheHits());
+        EXPECT_EQ(2, device.getShadowCacheMisses());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWholeDeviceWriteCoversEachLED) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+
+        EXPECT_TRUE(device.setRGB(RGB(4, 5, 6)));
+        fake_blink1_lib::SET_RGB(MARKER, 2);
+        EXPECT_TRUE(device.setRGBN(RGBN(4, 5, 6, 2)));
+        EXPECT_EQ(MARKER, fake_blink1_lib::GET_RGB(2)) << "Expected per-LED write matching the whole device to be skipped";
+
+        EXPECT_TRUE(device.setRGBN(RGBN(7, 8, 9, 2)));
+        fake_blink1_lib::SET_RGB(MARKER, 0);
+        EXPECT_TRUE(device.setRGB(RGB(4, 5, 6)));
+        EXPECT_EQ(RGB(4, 5, 6), fake_blink1_lib::GET_RGB(0)) << "Expected whole-device write to be sent after an LED changed";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestPlayInvalidates) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+
+        EXPECT_TRUE(device.setRGB(RGB(1, 1, 1)));
+        EXPECT_TRUE(device.play(0));
+        fake_blink1_lib::SET_RGB(MARKER, 0);
+        EXPECT_TRUE(device.setRGB(RGB(1, 1, 1)));
+        EXPECT_EQ(RGB(1, 1, 1), fake_blink1_lib::GET_RGB(0));
+
+        EXPECT_TRUE(device.playLoop(0, 1, 2));
+        fake_blink1_lib::SET_RGB(MARKER, 0);
+        EXPECT_TRUE(device.setRGB(RGB(1, 1, 1)));
+        EXPECT_EQ(RGB(1, 1, 1), fake_blink1_lib::GET_RGB(0));
+
+        EXPECT_EQ(0, device.getShadowCacheHits());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailedWriteInvalidates) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+
+        EXPECT_TRUE(device.fadeToRGB(10, RGB(1, 1, 1)));
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_FALSE(device.fadeToRGBN(10, RGBN(2, 2, 2, 1)));
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+
+        fake_blink1_lib::SET_RGB(MARKER, 1);
+        EXPECT_TRUE(device.fadeToRGBN(10, RGBN(1, 1, 1, 1)));
+        EXPECT_EQ(RGB(1, 1, 1), fake_blink1_lib::GET_RGB(1)) << "Expected write to be sent after a failed write";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestInvalidateShadowCache) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+
+        EXPECT_TRUE(device.setRGBN(RGBN(3, 3, 3, 1)));
+        device.invalidateShadowCache();
+        fake_blink1_lib::SET_RGB(MARKER, 1);
+        EXPECT_TRUE(device.setRGBN(RGBN(3, 3, 3, 1)));
+
+        EXPECT_EQ(RGB(3, 3, 3), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,177 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1Device_Stress_test
+
+static constexpr std::size_t DEVICE_COUNT = 4;
+static constexpr std::size_t THREADS_PER_DEVICE = 4;
+static constexpr int ITERATIONS = 200;
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+static std::string serialFor(std::size_t device) {
+    return "STRESS0" + std::to_string(device);
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+            for (std::size_t i = 0; i < DEVICE_COUNT; ++i) {
+                fake_blink1_lib::ADD_DEVICE(serialFor(i), "/dev/hidraw" + std::to_string(i));
+            }
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+
+        static void joinAll(std::vector<std::thread>& threads) {
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+};
+
+TEST_F(SUITE_NAME, TestFinalStateMatchesLastWrites) {
+    {
+        std::vector<std::unique_ptr<Blink1Device>> devices;
+        for (std::size_t i = 0; i < DEVICE_COUNT; ++i) {
+            devices.push_back(std::make_unique<Blink1Device>(serialFor(i), Blink1Device::STRING_INIT_TYPE::SERIAL));
+            ASSERT_TRUE(devices.back()->good());
+        }
+
+        // Each thread owns one LED and one pattern position on its device, so the final
+        // state is known even though the threads interleave arbitrarily
+        std::vector<std::thread> threads;
+        for (std::size_t d = 0; d < DEVICE_COUNT; ++d) {
+            for (std::size_t t = 0; t < THREADS_PER_DEVICE; ++t) {
+                threads.emplace_back([&device = *devices[d], d, t] {
+                    const auto ledn = static_cast<std::uint8_t>(t + 1);
+                    for (int i = 0; i < ITERATIONS; ++i) {
+                        const auto value = static_cast<std::uint8_t>(i + static_cast<int>(d));
+                        EXPECT_TRUE(device.fadeToRGBN(static_cast<std::uint16_t>(i), RGBN(value, ledn, static_cast<std::uint8_t>(d), ledn)));
+                        EXPECT_TRUE(device.writePatternLineN(PatternLineN(value, ledn, static_cast<std::uint8_t>(d), ledn, static_cast<std::uint16_t>(i)), ledn));
+                        EXPECT_TRUE(device.readRGB(ledn));
+                        EXPECT_TRUE(device.readPlayState());
+                    }
+                });
+            }
+        }
+        joinAll(threads);
+
+        for (std::size_t d = 0; d < DEVICE_COUNT; ++d) {
+            const auto last = static_cast<std::uint8_t>(ITERATIONS - 1 + static_cast<int>(d));
+            for (std::size_t t = 0; t < THREADS_PER_DEVICE; ++t) {
+                const auto ledn = static_cast<std::uint8_t>(t + 1);
+                EXPECT_EQ(RGB(last, ledn, static_cast<std::uint8_t>(d)), fake_blink1_lib::GET_RGB(serialFor(d), ledn));
+                EXPECT_EQ(ITERATIONS - 1, fake_blink1_lib::GET_FADE_MILLIS(serialFor(d), ledn));
+                EXPECT_EQ(PatternLineN(last, ledn, static_cast<std::uint8_t>(d), ledn, ITERATIONS - 1), fake_blink1_lib::GET_PATTERN_LINE(serialFor(d), ledn));
+            }
+        }
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestContendedWritesAreNotTorn) {
+    {
+        Blink1Device device(serialFor(0), Blink1Device::STRING_INIT_TYPE::SERIAL);
+        ASSERT_TRUE(device.good());
+        ASSERT_TRUE(device.fadeToRGBN(0, RGBN(0, 0, 0, 1)));
+
+        // Every write sets all three channels and the fade time to the same value, so any
+        // state where they differ is a mix of two writes
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < THREADS_PER_DEVICE * 2; ++t) {
+            threads.emplace_back([&device, t] {
+                for (int i = 0; i < ITERATIONS; ++i) {
+                    const auto value = static_cast<std::uint8_t>((i * 8 + static_cast<int>(t)) % 256);
+                    EXPECT_TRUE(device.fadeToRGBN(value, RGBN(value, value, value, 1)));
+                }
+            });
+        }
+        threads.emplace_back([&device] {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                const auto rgb = device.readRGB(1);
+                ASSERT_TRUE(rgb);
+                EXPECT_EQ(rgb->r, rgb->g);
+                EXPECT_EQ(rgb->r, rgb->b);
+            }
+        });
+        joinAll(threads);
+
+        const RGB finalRgb = fake_blink1_lib::GET_RGB(serialFor(0), 1);
+        EXPECT_EQ(finalRgb.r, finalRgb.g);
+        EXPECT_EQ(finalRgb.r, finalRgb.b);
+        EXPECT_EQ(finalRgb.r, fake_blink1_lib::GET_FADE_MILLIS(serialFor(0), 1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestConcurrentOpenAndClose) {
+    {
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < DEVICE_COUNT * THREADS_PER_DEVICE; ++t) {
+            threads.emplace_back([t] {
+                for (int i = 0; i < ITERATIONS; ++i) {
+                    Blink1Device device(serialFor(t % DEVICE_COUNT), Blink1Device::STRING_INIT_TYPE::SERIAL);
+                    EXPECT_TRUE(device.good());
+                    EXPECT_EQ(serialFor(t % DEVICE_COUNT), device.getSerial());
+                    EXPECT_TRUE(device.setRGBN(RGBN(1, 2, 3, static_cast<std::uint8_t>(t + 1))));
+                }
+            });
+        }
+        joinAll(threads);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestConcurrentPatternWrites) {
+    {
+        std::vector<std::unique_ptr<Blink1Device>> devices;
+        for (std::size_t i = 0; i < DEVICE_COUNT; ++i) {
+            devices.push_back(std::make_unique<Blink1Device>(serialFor(i), Blink1Device::STRING_INIT_TYPE::SERIAL));
+            ASSERT_TRUE(devices.back()->good());
+        }
+
+        // Each thread writes its own block of pattern positions
+        constexpr std::size_t BLOCK_SIZE = 8;
+        std::vector<std::thread> threads;
+        for (std::size_t d = 0; d < DEVICE_COUNT; ++d) {
+            for (std::size_t t = 0; t < THREADS_PER_DEVICE; ++t) {
+                threads.emplace_back([&device = *devices[d], t] {
+                    std::array<PatternLineN, BLOCK_SIZE> lines;
+                    for (std::size_t i = 0; i < BLOCK_SIZE; ++i) {
+                        const auto value = static_cast<std::uint8_t>(t * BLOCK_SIZE + i);
+                        lines[i] = PatternLineN(value, value, value, 0, value);
+                    }
+                    for (int i = 0; i < ITERATIONS / 10; ++i) {
+                        EXPECT_FALSE(device.writePattern(lines, static_cast<std::uint8_t>(t * BLOCK_SIZE)));
+                    }
+                });
+            }
+        }
+        joinAll(threads);
+
+        for (std::size_t d = 0; d < DEVICE_COUNT; ++d) {
+            for (std::size_t pos = 0; pos < THREADS_PER_DEVICE * BLOCK_SIZE; ++pos) {
+                const auto value = static_cast<std::uint8_t>(pos);
+                EXPECT_EQ(PatternLineN(value, value, value, 0, value), fake_blink1_lib::GET_PATTERN_LINE(serialFor(d), static_cast<long>(pos)));
+            }
+        }
+    }
+    checkDevicesFreed();
+}
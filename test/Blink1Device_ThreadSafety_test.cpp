@@ -0,0 +1,81 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1Device_ThreadSafety_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestConcurrentWrites) {
+    {
+        Blink1Device device;
+        device.setShadowCache(true);
+
+        std::vector<std::thread> threads;
+        for (std::uint8_t t = 1; t <= 4; ++t) {
+            threads.emplace_back([&device, t] {
+                for (std::uint8_t i = 0; i < 100; ++i) {
+                    EXPECT_TRUE(device.fadeToRGBN(0, RGBN(i, i, i, t)));
+                    EXPECT_TRUE(device.writePatternLineN(PatternLineN(i, i, i, t, 0), t));
+                    EXPECT_TRUE(device.readPlayState());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (std::uint8_t t = 1; t <= 4; ++t) {
+            EXPECT_EQ(RGB(99, 99, 99), fake_blink1_lib::GET_RGB(t));
+            EXPECT_EQ(PatternLineN(99, 99, 99, t, 0), device.getMirroredPatternLine(t));
+        }
+        EXPECT_EQ(400, device.getShadowCacheMisses());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReadsDoNotWaitForBlockingFades) {
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.fadeToRGB(0, RGB(0, 0, 0)));
+        device.setBlocking();
+
+        std::thread fader([&device] {
+            EXPECT_TRUE(device.fadeToRGB(500, RGB(1, 2, 3)));
+        });
+
+        // Wait for the fade to be sent
+        while (device.readRGB(0) != RGB(1, 2, 3)) {
+            std::this_thread::yield();
+        }
+
+        const auto startTime = std::chrono::steady_clock::now();
+        EXPECT_TRUE(device.readPlayState());
+        EXPECT_TRUE(device.setRGBN(RGBN(4, 5, 6, 1)));
+        const auto elapsed = std::chrono::steady_clock::now() - startTime;
+        EXPECT_LT(elapsed, std::chrono::milliseconds(250)) << "Expected commands not to wait for the blocking fade to finish";
+
+        fader.join();
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,177 @@
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1TestingLibrary_FaultInjection_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestDefaultInjectsNoFaults) {
+    {
+        Blink1Device device;
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        }
+        EXPECT_EQ(100, fake_blink1_lib::GET_CALL_COUNT());
+        EXPECT_EQ(0, fake_blink1_lib::GET_INJECTED_FAULT_COUNT());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailureProbability) {
+    fake_blink1_lib::FaultModel model;
+    model.failureProbability = 0.25;
+    model.seed = 1234;
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+
+    {
+        Blink1Device device;
+        int failures = 0;
+        for (int i = 0; i < 2000; ++i) {
+            if (!device.setRGB(RGB(1, 2, 3))) {
+                ++failures;
+            }
+        }
+        EXPECT_GT(failures, 400);
+        EXPECT_LT(failures, 600);
+        EXPECT_EQ(static_cast<std::uint64_t>(failures), fake_blink1_lib::GET_INJECTED_FAULT_COUNT());
+        EXPECT_EQ(2000, fake_blink1_lib::GET_CALL_COUNT());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailureProbabilityIsRepeatable) {
+    fake_blink1_lib::FaultModel model;
+    model.failureProbability = 0.5;
+    model.seed = 42;
+
+    auto run = [&model] {
+        fake_blink1_lib::SET_FAULT_MODEL(model);
+        Blink1Device device;
+        std::vector<bool> results;
+        for (int i = 0; i < 100; ++i) {
+            results.push_back(device.fadeToRGB(0, RGB(1, 2, 3)));
+        }
+        return results;
+    };
+
+    EXPECT_EQ(run(), run()) << "Expected the same seed to fail the same calls";
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailAfterCalls) {
+    fake_blink1_lib::FaultModel model;
+    model.failAfterCalls = 3;
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device.readPlayState());
+        EXPECT_TRUE(device.play(0));
+        EXPECT_FALSE(device.stop());
+        EXPECT_FALSE(device.readPlayState());
+        EXPECT_EQ(2, fake_blink1_lib::GET_INJECTED_FAULT_COUNT());
+
+        fake_blink1_lib::SET_FAULT_MODEL(model);
+        EXPECT_TRUE(device.stop()) << "Expected setting the model to restart the count";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailingFunctions) {
+    fake_blink1_lib::FaultModel model;
+    model.failingFunctions = {fake_blink1_lib::BLINK1_FUNCTION::READ_RGB, fake_blink1_lib::BLINK1_FUNCTION::SAVE_PATTERN};
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+    EXPECT_EQ(model.failingFunctions, fake_blink1_lib::GET_FAULT_MODEL().failingFunctions);
+
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.fadeToRGB(0, RGB(1, 2, 3)));
+        EXPECT_FALSE(device.readRGB(0));
+        EXPECT_TRUE(device.writePatternLine(PatternLine(1, 2, 3, 4), 0));
+        EXPECT_FALSE(device.savePattern());
+        EXPECT_TRUE(device.readPlayState());
+        EXPECT_EQ(2, fake_blink1_lib::GET_INJECTED_FAULT_COUNT());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestDisconnect) {
+    {
+        Blink1Device device;
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+
+        fake_blink1_lib::DISCONNECT();
+        EXPECT_FALSE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_FALSE(device.readPlayState());
+
+        Blink1Device whileDisconnected;
+        EXPECT_FALSE(whileDisconnected.good()) << "Expected a disconnected device not to open";
+
+        fake_blink1_lib::RECONNECT();
+        EXPECT_FALSE(device.setRGB(RGB(1, 2, 3))) << "Expected the old handle to stay invalid";
+
+        Blink1Device reopened;
+        ASSERT_TRUE(reopened.good());
+        EXPECT_TRUE(reopened.setRGB(RGB(4, 5, 6)));
+        EXPECT_EQ(RGB(4, 5, 6), fake_blink1_lib::GET_RGB(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestDisconnectOneOfSeveralDevices) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0001", "/dev/hidraw1");
+    fake_blink1_lib::ADD_DEVICE("AAAA0002", "/dev/hidraw2");
+    {
+        Blink1Device device1("AAAA0001", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        Blink1Device device2("AAAA0002", Blink1Device::STRING_INIT_TYPE::SERIAL);
+
+        fake_blink1_lib::DISCONNECT("AAAA0001");
+        EXPECT_FALSE(device1.setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device2.setRGB(RGB(1, 2, 3)));
+
+        fake_blink1_lib::RECONNECT("AAAA0001");
+        Blink1Device reopened("AAAA0001", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        EXPECT_TRUE(reopened.setRGB(RGB(1, 2, 3)));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestClearAllResetsFaults) {
+    fake_blink1_lib::FaultModel model;
+    model.failureProbability = 1;
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+    fake_blink1_lib::DISCONNECT();
+
+    fake_blink1_lib::CLEAR_ALL();
+    fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+    fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+    EXPECT_EQ(0, fake_blink1_lib::GET_FAULT_MODEL().failureProbability);
+
+    {
+        Blink1Device device;
+        ASSERT_TRUE(device.good());
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,149 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME Blink1TestingLibrary_SimulatedDevices_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestDefaultDeviceIsShared) {
+    {
+        Blink1Device device1;
+        Blink1Device device2("anything", Blink1Device::STRING_INIT_TYPE::SERIAL);
+
+        EXPECT_TRUE(device1.fadeToRGBN(10, RGBN(1, 2, 3, 1)));
+        EXPECT_EQ(RGB(1, 2, 3), device2.readRGB(1)) << "Expected devices to share state until any are added";
+        EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestDevicesHaveSeparateState) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0001", "/dev/hidraw1");
+    fake_blink1_lib::ADD_DEVICE("AAAA0002", "/dev/hidraw2");
+    {
+        Blink1Device device1("AAAA0001", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        Blink1Device device2("/dev/hidraw2", Blink1Device::STRING_INIT_TYPE::PATH);
+        ASSERT_TRUE(device1.good());
+        ASSERT_TRUE(device2.good());
+
+        EXPECT_TRUE(device1.fadeToRGB(10, RGB(1, 2, 3)));
+        EXPECT_TRUE(device2.fadeToRGB(20, RGB(4, 5, 6)));
+        EXPECT_TRUE(device1.writePatternLineN(PatternLineN(7, 8, 9, 1, 30), 0));
+        EXPECT_TRUE(device2.playLoop(1, 2, 3));
+
+        EXPECT_EQ(RGB(1, 2, 3), device1.readRGB(0));
+        EXPECT_EQ(RGB(4, 5, 6), device2.readRGB(0));
+        EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB("AAAA0001", 0));
+        EXPECT_EQ(20, fake_blink1_lib::GET_FADE_MILLIS("AAAA0002", 0));
+        EXPECT_EQ(PatternLineN(7, 8, 9, 1, 30), fake_blink1_lib::GET_PATTERN_LINE("AAAA0001", 0));
+        EXPECT_FALSE(fake_blink1_lib::GET_PLAY_STATE("AAAA0001").playing);
+        EXPECT_TRUE(fake_blink1_lib::GET_PLAY_STATE("AAAA0002").playing);
+
+        EXPECT_EQ("AAAA0001", device1.getSerial());
+        EXPECT_EQ("AAAA0002", device2.getSerial());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestOpenSelectsDevice) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0001", "/dev/hidraw1");
+    fake_blink1_lib::ADD_DEVICE("AAAA0002", "/dev/hidraw2");
+    {
+        Blink1Device byId(1);
+        EXPECT_EQ("AAAA0002", byId.getSerial());
+
+        EXPECT_FALSE(Blink1Device(2).good()) << "Expected opening a missing ID to fail";
+        EXPECT_FALSE(Blink1Device("BBBB0001", Blink1Device::STRING_INIT_TYPE::SERIAL).good());
+        EXPECT_FALSE(Blink1Device("/dev/hidraw3", Blink1Device::STRING_INIT_TYPE::PATH).good());
+
+        fake_blink1_lib::SET_SERIAL("DEFAULT");
+        EXPECT_EQ("DEFAULT", Blink1Device().getSerial()) << "Expected blink1_open() to open the default device";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestManyDevices) {
+    std::vector<std::string> serials;
+    for (int i = 0; i < 50; ++i) {
+        serials.push_back("SERIAL" + std::to_string(i));
+        fake_blink1_lib::ADD_DEVICE(serials.back(), "/dev/hidraw" + std::to_string(i));
+    }
+    {
+        std::vector<std::unique_ptr<Blink1Device>> devices;
+        for (std::size_t i = 0; i < serials.size(); ++i) {
+            devices.push_back(std::make_unique<Blink1Device>(serials[i], Blink1Device::STRING_INIT_TYPE::SERIAL));
+            EXPECT_TRUE(devices.back()->setRGBN(RGBN(static_cast<std::uint8_t>(i), 0, 0, 1)));
+        }
+
+        for (std::size_t i = 0; i < serials.size(); ++i) {
+            EXPECT_EQ(RGB(static_cast<std::uint8_t>(i), 0, 0), fake_blink1_lib::GET_RGB(serials[i], 1));
+        }
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestRemovedDeviceKeepsOpenHandles) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0001", "/dev/hidraw1");
+    {
+        Blink1Device device("AAAA0001", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        fake_blink1_lib::REMOVE_DEVICE("AAAA0001");
+
+        EXPECT_FALSE(fake_blink1_lib::GET_SIMULATED_DEVICE("AAAA0001"));
+        EXPECT_EQ(0, blink1_enumerate());
+        EXPECT_TRUE(device.fadeToRGB(0, RGB(1, 2, 3)));
+        EXPECT_EQ(RGB(1, 2, 3), device.readRGB(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestThousandsOfHandles) {
+    for (int i = 0; i < 2000; ++i) {
+        fake_blink1_lib::ADD_DEVICE("SERIAL" + std::to_string(i), "/dev/hidraw" + std::to_string(i));
+    }
+    {
+        std::vector<std::unique_ptr<Blink1Device>> devices;
+        for (int i = 0; i < 2000; ++i) {
+            devices.push_back(std::make_unique<Blink1Device>("/dev/hidraw" + std::to_string(i), Blink1Device::STRING_INIT_TYPE::PATH));
+            EXPECT_TRUE(devices.back()->good());
+        }
+        EXPECT_EQ(2000, fake_blink1_lib::blink1_devices.size());
+
+        // Close them in a different order than they were opened
+        for (std::size_t i = 0; i < devices.size(); i += 2) {
+            devices[i].reset();
+        }
+        EXPECT_EQ(1000, fake_blink1_lib::blink1_devices.size());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestClearAllFreesEveryHandle) {
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_NE(nullptr, blink1_open());
+    }
+    EXPECT_FALSE(fake_blink1_lib::ALL_DEVICES_FREED());
+
+    fake_blink1_lib::CLEAR_ALL();
+    checkDevicesFreed();
+}
@@ -0,0 +1,188 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME Blink1TestingLibrary_TimingModel_test
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+
+        template <typename F>
+        static std::chrono::steady_clock::duration timeOf(F&& f) {
+            const auto start = std::chrono::steady_clock::now();
+            f();
+            return std::chrono::steady_clock::now() - start;
+        }
+};
+
+TEST_F(SUITE_NAME, TestDefaultIsInstant) {
+    Blink1Device device;
+    const auto model = fake_blink1_lib::GET_TIMING_MODEL();
+    EXPECT_EQ(0us, model.latency);
+    EXPECT_EQ(0us, model.jitter);
+    EXPECT_FALSE(model.interpolateFades);
+
+    EXPECT_LT(timeOf([&device] {
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        }
+    }), 50ms);
+}
+
+TEST_F(SUITE_NAME, TestConstantLatency) {
+    fake_blink1_lib::TimingModel model;
+    model.latency = 5ms;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    Blink1Device device;
+    EXPECT_GE(timeOf([&device] { EXPECT_TRUE(device.setRGB(RGB(1, 2, 3))); }), 5ms);
+    EXPECT_GE(timeOf([&device] { EXPECT_TRUE(device.readPlayState()); }), 5ms);
+    EXPECT_GE(timeOf([&device] { EXPECT_TRUE(device.writePatternLineN(PatternLineN(1, 2, 3, 1, 0), 0)); }), 10ms) << "Expected both USB transfers to take time";
+}
+
+TEST_F(SUITE_NAME, TestJitter) {
+    for (const auto distribution : {fake_blink1_lib::LATENCY_DISTRIBUTION::UNIFORM, fake_blink1_lib::LATENCY_DISTRIBUTION::NORMAL}) {
+        fake_blink1_lib::TimingModel model;
+        model.latency = 2ms;
+        model.jitter = 1ms;
+        model.distribution = distribution;
+        fake_blink1_lib::SET_TIMING_MODEL(model);
+
+        Blink1Device device;
+        const auto elapsed = timeOf([&device] {
+            for (int i = 0; i < 20; ++i) {
+                EXPECT_TRUE(device.stop());
+            }
+        });
+        EXPECT_GE(elapsed, 20ms) << "Expected the average latency to be around 2ms";
+        EXPECT_LT(elapsed, 2s);
+    }
+}
+
+TEST_F(SUITE_NAME, TestNoJitterIsConstant) {
+    auto clock = std::make_shared<VirtualClock>();
+    fake_blink1_lib::SET_CLOCK(clock);
+
+    for (const auto distribution : {fake_blink1_lib::LATENCY_DISTRIBUTION::UNIFORM, fake_blink1_lib::LATENCY_DISTRIBUTION::NORMAL}) {
+        for (const auto jitter : {0ms, -1ms}) {
+            fake_blink1_lib::TimingModel model;
+            model.latency = 1h;
+            model.jitter = jitter;
+            model.distribution = distribution;
+            fake_blink1_lib::SET_TIMING_MODEL(model);
+
+            Blink1Device device;
+            std::thread caller([&device] { EXPECT_TRUE(device.stop()); });
+
+            clock->waitForSleepers(1);
+            clock->advance(59min);
+            EXPECT_EQ(1u, clock->sleeperCount()) << "Expected the call to take exactly the latency";
+            clock->advance(1min);
+            caller.join();
+        }
+    }
+}
+
+TEST_F(SUITE_NAME, TestWriteRateLimit) {
+    fake_blink1_lib::TimingModel model;
+    model.maxWritesPerSecond = 100;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    Blink1Device device;
+    EXPECT_GE(timeOf([&device] {
+        for (int i = 0; i < 11; ++i) {
+            EXPECT_TRUE(device.stop());
+        }
+    }), 100ms) << "Expected 11 writes to take at least 10 write intervals";
+
+    EXPECT_LT(timeOf([&device] {
+        for (int i = 0; i < 20; ++i) {
+            EXPECT_TRUE(device.readPlayState());
+        }
+    }), 50ms) << "Expected reads not to be rate limited";
+}
+
+TEST_F(SUITE_NAME, TestFadeInterpolation) {
+    auto clock = std::make_shared<VirtualClock>();
+    fake_blink1_lib::SET_CLOCK(clock);
+
+    fake_blink1_lib::TimingModel model;
+    model.interpolateFades = true;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    Blink1Device device;
+    EXPECT_TRUE(device.fadeToRGBN(0, RGBN(0, 0, 0, 1)));
+    EXPECT_TRUE(device.fadeToRGBN(400, RGBN(200, 100, 40, 1)));
+
+    EXPECT_EQ(RGB(200, 100, 40), fake_blink1_lib::GET_RGB(1)) << "Expected the target color to be reported immediately";
+    EXPECT_EQ(RGB(0, 0, 0), fake_blink1_lib::GET_DISPLAYED_RGB(1));
+
+    clock->advance(100ms);
+    EXPECT_EQ(RGB(50, 25, 10), device.readRGB(1));
+    EXPECT_EQ(RGB(50, 25, 10), fake_blink1_lib::GET_DISPLAYED_RGB(1));
+
+    clock->advance(300ms);
+    EXPECT_EQ(RGB(200, 100, 40), device.readRGB(1));
+
+    EXPECT_TRUE(device.setRGB(RGB(1, 1, 1)));
+    EXPECT_EQ(RGB(1, 1, 1), fake_blink1_lib::GET_DISPLAYED_RGB(1)) << "Expected setRGB to take effect immediately";
+}
+
+TEST_F(SUITE_NAME, TestFadeInterpolationFromMidway) {
+    auto clock = std::make_shared<VirtualClock>();
+    fake_blink1_lib::SET_CLOCK(clock);
+
+    fake_blink1_lib::TimingModel model;
+    model.interpolateFades = true;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    Blink1Device device;
+    EXPECT_TRUE(device.fadeToRGB(0, RGB(0, 0, 0)));
+    EXPECT_TRUE(device.fadeToRGB(200, RGB(200, 200, 200)));
+    clock->advance(100ms);
+
+    // Starts from wherever the first fade got to rather than jumping to its end
+    EXPECT_TRUE(device.fadeToRGB(1000, RGB(0, 0, 0)));
+    EXPECT_EQ(RGB(100, 100, 100), fake_blink1_lib::GET_DISPLAYED_RGB(0));
+
+    clock->advance(500ms);
+    EXPECT_EQ(RGB(50, 50, 50), fake_blink1_lib::GET_DISPLAYED_RGB(0));
+}
+
+TEST_F(SUITE_NAME, TestLatencyWithVirtualClock) {
+    auto clock = std::make_shared<VirtualClock>();
+    fake_blink1_lib::SET_CLOCK(clock);
+
+    fake_blink1_lib::TimingModel model;
+    model.latency = 1h;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    Blink1Device device;
+    std::atomic<bool> done{false};
+    std::thread caller([&device, &done] {
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        done = true;
+    });
+
+    clock->waitForSleepers(1);
+    EXPECT_FALSE(done.load()) << "Expected the call to wait for the clock";
+    clock->advance(1h);
+    caller.join();
+    EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB(0));
+}
@@ -0,0 +1,259 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "AsyncBlink1Device.hpp"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "ChromeTraceWriter.hpp"
+#include "Clock.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME ChromeTraceWriter_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+static std::string toJson(const ChromeTraceWriter& writer) {
+    std::ostringstream os;
+    writer.write(os);
+    return os.str();
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestWritesCompleteEvents) {
+    ChromeTraceWriter writer;
+    ChromeTraceWriter::Span span;
+    span.name = "fade_to_rgbn";
+    span.category = "usb";
+    span.serial = "AAAA0001";
+    span.start = Clock::time_point(1500ns);
+    span.end = Clock::time_point(4250ns);
+    span.ledn = 2;
+    span.fadeMillis = 100;
+    EXPECT_TRUE(writer.addSpan(span));
+
+    const std::string json = toJson(writer);
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"blink1 AAAA0001\"}}"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"fade_to_rgbn\",\"cat\":\"usb\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1.500,\"dur\":2.750,"
+                                           "\"args\":{\"serial\":\"AAAA0001\",\"ledn\":2,\"fadeMillis\":100,\"success\":true}}"));
+    EXPECT_EQ(json.size() - 4, json.find("\n]}\n"));
+}
+
+TEST_F(SUITE_NAME, TestWritesAsyncEventsAndTracks) {
+    ChromeTraceWriter writer;
+    ChromeTraceWriter::Span queued;
+    queued.name = "queued";
+    queued.category = "queue";
+    queued.serial = "BBBB0002";
+    queued.start = Clock::time_point(1us);
+    queued.end = Clock::time_point(3us);
+    queued.async = true;
+    EXPECT_TRUE(writer.addSpan(queued));
+
+    ChromeTraceWriter::Span other = queued;
+    other.serial = "A\"Q";
+    other.success = false;
+    EXPECT_TRUE(writer.addSpan(other));
+
+    const std::string json = toJson(writer);
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"queued\",\"cat\":\"queue\",\"ph\":\"b\",\"id\":1,\"pid\":1,\"tid\":1,\"ts\":1.000,"
+                                           "\"args\":{\"serial\":\"BBBB0002\",\"success\":true}}"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"queued\",\"cat\":\"queue\",\"ph\":\"e\",\"id\":1,\"pid\":1,\"tid\":1,\"ts\":3.000}"));
+    EXPECT_NE(std::string::npos, json.find("\"ph\":\"b\",\"id\":2,\"pid\":1,\"tid\":2,"));
+    EXPECT_NE(std::string::npos, json.find("\"args\":{\"serial\":\"A\\\"Q\",\"success\":false}")) << "Expected the serial to be escaped";
+}
+
+TEST_F(SUITE_NAME, TestKeepsRuntimeNames) {
+    ChromeTraceWriter writer;
+    {
+        // Long enough to be allocated, so a dangling copy would be caught by sanitizers
+        std::string name = "frame " + std::to_string(42) + " of an animation with a long label";
+        std::string category = "application";
+        ChromeTraceWriter::Span span;
+        span.name = name;
+        span.category = category;
+        EXPECT_TRUE(writer.addSpan(span));
+        name.assign(name.size(), 'x');
+        category.assign(category.size(), 'x');
+    }
+
+    const std::string json = toJson(writer);
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"frame 42 of an animation with a long label\",\"cat\":\"application\","))
+        << "Expected spans to keep their own copy of the name and category";
+}
+
+TEST_F(SUITE_NAME, TestCapacity) {
+    ChromeTraceWriter writer(2);
+    ChromeTraceWriter::Span span;
+    span.name = "stop";
+    span.category = "usb";
+    EXPECT_TRUE(writer.addSpan(span));
+    EXPECT_TRUE(writer.addSpan(span));
+    EXPECT_FALSE(writer.addSpan(span));
+    EXPECT_EQ(2u, writer.size());
+    EXPECT_EQ(1u, writer.getDroppedCount());
+
+    writer.clear();
+    EXPECT_EQ(0u, writer.size());
+    EXPECT_EQ(0u, writer.getDroppedCount());
+    EXPECT_EQ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n", toJson(writer));
+}
+
+TEST_F(SUITE_NAME, TestTracesDeviceCommands) {
+    fake_blink1_lib::SET_SERIAL("CCCC0003");
+    auto clock = std::make_shared<VirtualClock>();
+    auto writer = std::make_shared<ChromeTraceWriter>();
+    {
+        Blink1Device device;
+        device.setClock(clock);
+        EXPECT_FALSE(device.isTracing());
+        EXPECT_TRUE(device.setRGB(RGB(1, 2, 3)));
+        EXPECT_EQ(0u, writer->size()) << "Expected nothing to be traced before tracing is enabled";
+
+        device.setTraceWriter(writer);
+        EXPECT_TRUE(device.isTracing());
+        EXPECT_EQ(writer, device.getTraceWriter());
+
+        clock->advance(1ms);
+        EXPECT_TRUE(device.fadeToRGBN(250, RGBN(1, 2, 3, 2)));
+        EXPECT_TRUE(device.readRGB(2));
+        EXPECT_TRUE(device.play(0));
+
+        const auto spans = writer->getSpans();
+        ASSERT_EQ(4u, spans.size());
+        EXPECT_EQ("fade_to_rgbn", spans[0].name);
+        EXPECT_EQ("usb", spans[0].category);
+        EXPECT_EQ("CCCC0003", spans[0].serial);
+        EXPECT_EQ(2, spans[0].ledn);
+        EXPECT_EQ(250, spans[0].fadeMillis);
+        EXPECT_FALSE(spans[0].async);
+
+        EXPECT_EQ("fade", spans[1].name);
+        EXPECT_TRUE(spans[1].async);
+        EXPECT_EQ(Clock::time_point(1ms), spans[1].start);
+        EXPECT_EQ(Clock::time_point(251ms), spans[1].end);
+
+        EXPECT_EQ("read_rgb_with_fade", spans[2].name);
+        EXPECT_EQ(2, spans[2].ledn);
+        EXPECT_FALSE(spans[2].fadeMillis);
+        EXPECT_EQ("play", spans[3].name);
+        EXPECT_FALSE(spans[3].ledn);
+
+        device.setTraceWriter(nullptr);
+        EXPECT_FALSE(device.isTracing());
+        EXPECT_TRUE(device.stop());
+        EXPECT_EQ(4u, writer->size());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestTracesFailures) {
+    fake_blink1_lib::FaultModel model;
+    model.failingFunctions = {fake_blink1_lib::BLINK1_FUNCTION::FADE_TO_RGB};
+    fake_blink1_lib::SET_FAULT_MODEL(model);
+
+    auto writer = std::make_shared<ChromeTraceWriter>();
+    {
+        Blink1Device device;
+        device.setTraceWriter(writer);
+        EXPECT_FALSE(device.fadeToRGB(100, RGB(1, 2, 3)));
+
+        const auto spans = writer->getSpans();
+        ASSERT_EQ(1u, spans.size()) << "Expected no fade span for a failed fade";
+        EXPECT_FALSE(spans[0].success);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestTracesQueueing) {
+    auto writer = std::make_shared<ChromeTraceWriter>();
+    {
+        Blink1Device device;
+        device.setTraceWriter(writer);
+        {
+            AsyncBlink1Device async(device);
+            EXPECT_TRUE(async.setRGBN(RGBN(1, 2, 3, 1)).get());
+            EXPECT_TRUE(async.stop().get());
+        }
+
+        const auto spans = writer->getSpans();
+        ASSERT_EQ(4u, spans.size());
+        EXPECT_EQ("queued", spans[0].name);
+        EXPECT_EQ("queue", spans[0].category);
+        EXPECT_TRUE(spans[0].async);
+        EXPECT_EQ(1, spans[0].ledn);
+        EXPECT_LE(spans[0].start, spans[0].end);
+        EXPECT_LE(spans[0].end, spans[1].start) << "Expected the command to be sent after it left the queue";
+        EXPECT_EQ("fade_to_rgbn", spans[1].name);
+        EXPECT_EQ("queued", spans[2].name);
+        EXPECT_FALSE(spans[2].ledn);
+        EXPECT_EQ("stop", spans[3].name);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestQueueingDoesNotWaitForDevice) {
+    auto clock = std::make_shared<VirtualClock>();
+    fake_blink1_lib::SET_CLOCK(clock);
+    fake_blink1_lib::TimingModel model;
+    model.latency = 1h;
+    fake_blink1_lib::SET_TIMING_MODEL(model);
+
+    auto writer = std::make_shared<ChromeTraceWriter>();
+    {
+        Blink1Device device;
+        device.setTraceWriter(writer);
+        AsyncBlink1Device async(device);
+
+        // The I/O thread holds the device while the first command waits for the clock
+        auto first = async.setRGB(RGB(1, 2, 3));
+        clock->waitForSleepers(1);
+        auto second = async.setRGB(RGB(4, 5, 6));
+        EXPECT_EQ(1u, async.queueDepth()) << "Expected the second command to be queued while the first is sent";
+
+        clock->advance(1h);
+        EXPECT_TRUE(first.get());
+        clock->waitForSleepers(1);
+        clock->advance(1h);
+        EXPECT_TRUE(second.get());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestSave) {
+    const std::string path = ::testing::TempDir() + "ChromeTraceWriter_test.json";
+    ChromeTraceWriter writer;
+    ChromeTraceWriter::Span span;
+    span.name = "stop";
+    span.category = "usb";
+    writer.addSpan(span);
+
+    ASSERT_TRUE(writer.save(path));
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    EXPECT_EQ(toJson(writer), contents.str());
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(writer.save(::testing::TempDir() + "missing-directory/trace.json"));
+}
@@ -0,0 +1,96 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "Clock.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME Clock_test
+
+TEST(SUITE_NAME, TestSteadyClock) {
+    const auto& clock = Clock::steady();
+    EXPECT_EQ(clock, Clock::steady()) << "Expected the default clock to be shared";
+
+    const auto before = std::chrono::steady_clock::now();
+    clock->sleepFor(10ms);
+    EXPECT_GE(clock->now() - before, 10ms);
+}
+
+TEST(SUITE_NAME, TestVirtualClockOnlyMovesWhenAdvanced) {
+    VirtualClock clock;
+    const auto start = clock.now();
+    std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(start, clock.now());
+
+    clock.advance(1h);
+    EXPECT_EQ(start + 1h, clock.now());
+
+    clock.advanceTo(start);
+    EXPECT_EQ(start + 1h, clock.now()) << "Expected the clock not to move backwards";
+
+    clock.advanceTo(start + 2h);
+    EXPECT_EQ(start + 2h, clock.now());
+}
+
+TEST(SUITE_NAME, TestVirtualClockSleep) {
+    VirtualClock clock;
+    std::atomic<bool> woken{false};
+    std::thread sleeper([&clock, &woken] {
+        clock.sleepFor(10s);
+        woken = true;
+    });
+
+    clock.waitForSleepers(1);
+    EXPECT_EQ(1, clock.sleeperCount());
+    clock.advance(9s);
+    EXPECT_FALSE(woken.load());
+
+    clock.advance(1s);
+    sleeper.join();
+    EXPECT_TRUE(woken.load());
+    EXPECT_EQ(0, clock.sleeperCount());
+
+    clock.sleepUntil(clock.now() - 1s);  // Deadlines in the past return immediately
+}
+
+TEST(SUITE_NAME, TestVirtualClockWaitUntil) {
+    VirtualClock clock;
+    std::mutex mutex;
+    std::condition_variable condition;
+    const auto deadline = clock.now() + 1min;
+
+    std::thread waiter([&] {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (clock.now() < deadline) {
+            clock.waitUntil(lock, condition, deadline);
+        }
+    });
+
+    clock.advance(1min);
+    waiter.join();
+    EXPECT_EQ(deadline, clock.now());
+}
+
+TEST(SUITE_NAME, TestVirtualClockWaitUntilRace) {
+    // Advancing right as the waiter starts waiting must still wake it, or this never finishes
+    VirtualClock clock;
+    std::mutex mutex;
+    std::condition_variable condition;
+    for (int i = 0; i < 1000; ++i) {
+        const auto deadline = clock.now() + 1ms;
+        std::thread waiter([&] {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (clock.now() < deadline) {
+                clock.waitUntil(lock, condition, deadline);
+            }
+        });
+
+        clock.advance(1ms);
+        waiter.join();
+    }
+}
@@ -0,0 +1,104 @@
+#include <chrono>
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "CommandRecorder.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME CommandRecorder_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        std::shared_ptr<VirtualClock> clock = std::make_shared<VirtualClock>();
+
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestRecordsCommands) {
+    {
+        Blink1Device device;
+        CommandRecorder recorder(device, clock);
+        EXPECT_EQ(&device, &recorder.getDevice());
+
+        clock->advance(5ms);
+        EXPECT_TRUE(recorder.fadeToRGB(100, RGB(1, 2, 3)));
+        clock->advance(5ms);
+        EXPECT_TRUE(recorder.setRGBN(RGBN(4, 5, 6, 2)));
+        EXPECT_TRUE(recorder.writePatternLineN(PatternLineN(7, 8, 9, 1, 10), 3));
+        clock->advance(1s);
+        EXPECT_TRUE(recorder.playLoop(1, 2, 3));
+
+        const CommandTrace trace = recorder.getTrace();
+        ASSERT_EQ(4, trace.size());
+
+        const auto& entries = trace.getEntries();
+        EXPECT_EQ(5ms, entries[0].time);
+        EXPECT_EQ(CommandTrace::COMMAND::FADE_TO_RGB, entries[0].command);
+        EXPECT_EQ(100, entries[0].fadeMillis);
+        EXPECT_EQ(RGBN(1, 2, 3, 0), entries[0].rgbn);
+
+        EXPECT_EQ(10ms, entries[1].time);
+        EXPECT_EQ(CommandTrace::COMMAND::SET_RGBN, entries[1].command);
+        EXPECT_EQ(RGBN(4, 5, 6, 2), entries[1].rgbn);
+
+        EXPECT_EQ(10ms, entries[2].time);
+        EXPECT_EQ(CommandTrace::COMMAND::WRITE_PATTERN_LINE_N, entries[2].command);
+        EXPECT_EQ(10, entries[2].fadeMillis);
+        EXPECT_EQ(3, entries[2].pos);
+
+        EXPECT_EQ(1010ms, entries[3].time);
+        EXPECT_EQ(CommandTrace::COMMAND::PLAY_LOOP, entries[3].command);
+        EXPECT_EQ(1, entries[3].pos);
+        EXPECT_EQ(2, entries[3].endPos);
+        EXPECT_EQ(3, entries[3].count);
+
+        EXPECT_EQ(RGB(4, 5, 6), fake_blink1_lib::GET_RGB(2)) << "Expected commands to reach the device";
+        EXPECT_EQ(PatternLineN(7, 8, 9, 1, 10), fake_blink1_lib::GET_PATTERN_LINE(3));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestRecordsFailedCommands) {
+    {
+        Blink1Device device;
+        CommandRecorder recorder(device, clock);
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        EXPECT_FALSE(recorder.stop());
+        EXPECT_FALSE(recorder.savePattern());
+        EXPECT_EQ(2, recorder.getTrace().size());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestTakeTrace) {
+    {
+        Blink1Device device;
+        CommandRecorder recorder(device, clock);
+
+        EXPECT_TRUE(recorder.play(1));
+        EXPECT_EQ(1, recorder.takeTrace().size());
+        EXPECT_TRUE(recorder.getTrace().empty());
+
+        clock->advance(1s);
+        EXPECT_TRUE(recorder.setRGB(RGB(1, 2, 3)));
+        const CommandTrace trace = recorder.takeTrace();
+        ASSERT_EQ(1, trace.size());
+        EXPECT_EQ(1s, trace.getEntries()[0].time) << "Expected times to carry on after the trace is taken";
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "CommandTrace.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME CommandTrace_test
+
+static CommandTrace::Entry makeEntry(std::chrono::microseconds time, CommandTrace::COMMAND command) {
+    CommandTrace::Entry entry;
+    entry.time = time;
+    entry.command = command;
+    return entry;
+}
+
+// One entry of every command, using every argument that command stores
+static CommandTrace makeTrace() {
+    CommandTrace trace;
+
+    auto entry = makeEntry(0us, CommandTrace::COMMAND::FADE_TO_RGB);
+    entry.fadeMillis = 1000;
+    entry.rgbn = RGBN(1, 2, 3, 0);
+    trace.add(entry);
+
+    entry = makeEntry(10us, CommandTrace::COMMAND::FADE_TO_RGBN);
+    entry.fadeMillis = 65535;
+    entry.rgbn = RGBN(4, 5, 6, 7);
+    trace.add(entry);
+
+    entry = makeEntry(200us, CommandTrace::COMMAND::SET_RGB);
+    entry.rgbn = RGBN(8, 9, 10, 0);
+    trace.add(entry);
+
+    entry = makeEntry(3000us, CommandTrace::COMMAND::SET_RGBN);
+    entry.rgbn = RGBN(11, 12, 13, 14);
+    trace.add(entry);
+
+    entry = makeEntry(3000us, CommandTrace::COMMAND::PLAY);
+    entry.pos = 15;
+    trace.add(entry);
+
+    entry = makeEntry(40000us, CommandTrace::COMMAND::PLAY_LOOP);
+    entry.pos = 16;
+    entry.endPos = 17;
+    entry.count = 18;
+    trace.add(entry);
+
+    trace.add(makeEntry(500000us, CommandTrace::COMMAND::STOP));
+
+    entry = makeEntry(6s, CommandTrace::COMMAND::WRITE_PATTERN_LINE);
+    entry.fadeMillis = 19;
+    entry.rgbn = RGBN(20, 21, 22, 0);
+    entry.pos = 23;
+    trace.add(entry);
+
+    entry = makeEntry(70s, CommandTrace::COMMAND::WRITE_PATTERN_LINE_N);
+    entry.fadeMillis = 24;
+    entry.rgbn = RGBN(25, 26, 27, 28);
+    entry.pos = 29;
+    trace.add(entry);
+
+    trace.add(makeEntry(8h, CommandTrace::COMMAND::SAVE_PATTERN));
+    return trace;
+}
+
+TEST(SUITE_NAME, TestEmpty) {
+    CommandTrace trace;
+    EXPECT_TRUE(trace.empty());
+    EXPECT_EQ(0, trace.size());
+    EXPECT_EQ(0us, trace.duration());
+}
+
+TEST(SUITE_NAME, TestAdd) {
+    const CommandTrace trace = makeTrace();
+    EXPECT_FALSE(trace.empty());
+    EXPECT_EQ(10, trace.size());
+    EXPECT_EQ(8h, trace.duration());
+    EXPECT_EQ(CommandTrace::COMMAND::PLAY, trace.getEntries()[4].command);
+}
+
+TEST(SUITE_NAME, TestRoundTrip) {
+    const CommandTrace trace = makeTrace();
+
+    std::stringstream stream;
+    ASSERT_TRUE(trace.write(stream));
+    const auto read = CommandTrace::read(stream);
+    ASSERT_TRUE(read);
+    EXPECT_EQ(trace, *read);
+}
+
+TEST(SUITE_NAME, TestCompact) {
+    CommandTrace trace;
+    for (int i = 0; i < 1000; ++i) {
+        auto entry = makeEntry(std::chrono::milliseconds(i), CommandTrace::COMMAND::SET_RGBN);
+        entry.rgbn = RGBN(1, 2, 3, 4);
+        trace.add(entry);
+    }
+
+    std::stringstream stream;
+    ASSERT_TRUE(trace.write(stream));
+    // 9 byte header, then a time delta (1 byte for the first entry, 2 for the rest), a
+    // command byte and 4 argument bytes per entry
+    EXPECT_EQ(9 + 6 + 999 * 7, stream.str().size());
+}
+
+TEST(SUITE_NAME, TestOutOfOrderEntriesAreNotWritten) {
+    CommandTrace trace;
+    trace.add(makeEntry(10us, CommandTrace::COMMAND::STOP));
+    trace.add(makeEntry(5us, CommandTrace::COMMAND::STOP));
+
+    std::stringstream stream;
+    EXPECT_FALSE(trace.write(stream));
+    EXPECT_TRUE(stream.str().empty()) << "Expected nothing to be written for an invalid trace";
+}
+
+TEST(SUITE_NAME, TestInvalidInput) {
+    std::stringstream badMagic("B1TX\x01\x00\x00\x00\x00");
+    EXPECT_FALSE(CommandTrace::read(badMagic));
+
+    std::stringstream badVersion(std::string("B1TR\x02\x00\x00\x00\x00", 9));
+    EXPECT_FALSE(CommandTrace::read(badVersion));
+
+    std::stringstream badCommand(std::string("B1TR\x01\x01\x00\x00\x00\x00\xFF", 11));
+    EXPECT_FALSE(CommandTrace::read(badCommand));
+
+    std::stringstream valid;
+    ASSERT_TRUE(makeTrace().write(valid));
+    const std::string bytes = valid.str();
+    for (std::size_t length = 0; length < bytes.size(); ++length) {
+        std::stringstream truncated(bytes.substr(0, length));
+        EXPECT_FALSE(CommandTrace::read(truncated)) << "Expected a trace truncated to " << length << " bytes to be rejected";
+    }
+}
+
+TEST(SUITE_NAME, TestTimeOverflow) {
+    // The largest delta that fits, 2^63 - 1 microseconds, followed by a STOP
+    const std::string largest("\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x7F\x06", 10);
+
+    std::stringstream oneEntry(std::string("B1TR\x01\x01\x00\x00\x00", 9) + largest);
+    const auto trace = CommandTrace::read(oneEntry);
+    ASSERT_TRUE(trace);
+    EXPECT_EQ(std::chrono::microseconds::max(), trace->getEntries().front().time);
+
+    std::stringstream twoEntries(std::string("B1TR\x01\x02\x00\x00\x00", 9) + largest + std::string("\x02\x06", 2));
+    EXPECT_FALSE(CommandTrace::read(twoEntries)) << "Expected a delta past the largest time to be rejected";
+
+    std::stringstream tooLarge(std::string("B1TR\x01\x01\x00\x00\x00\x80\x80\x80\x80\x80\x80\x80\x80\x80\x01\x06", 20));
+    EXPECT_FALSE(CommandTrace::read(tooLarge)) << "Expected a delta of 2^63 to be rejected";
+}
+
+TEST(SUITE_NAME, TestSaveAndLoad) {
+    const std::string path = ::testing::TempDir() + "CommandTrace_test.b1tr";
+    const CommandTrace trace = makeTrace();
+
+    ASSERT_TRUE(trace.save(path));
+    EXPECT_EQ(trace, CommandTrace::load(path));
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(CommandTrace::load(path)) << "Expected a missing file not to load";
+}
+
+TEST(SUITE_NAME, TestInvalidSaveKeepsFile) {
+    const std::string path = ::testing::TempDir() + "CommandTrace_test_invalid.b1tr";
+    const CommandTrace trace = makeTrace();
+    ASSERT_TRUE(trace.save(path));
+
+    CommandTrace invalid;
+    invalid.add(makeEntry(10us, CommandTrace::COMMAND::STOP));
+    invalid.add(makeEntry(5us, CommandTrace::COMMAND::STOP));
+    EXPECT_FALSE(invalid.save(path));
+    EXPECT_EQ(trace, CommandTrace::load(path)) << "Expected a failed save to leave the existing file as it was";
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp")) << "Expected the temporary file to be removed";
+    std::remove(path.c_str());
+}
@@ -0,0 +1,128 @@
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "DeviceGroup.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME DeviceGroup_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+
+        static std::vector<std::shared_ptr<Blink1Device>> makeDevices(std::size_t count) {
+            std::vector<std::shared_ptr<Blink1Device>> devices;
+            for (std::size_t i = 0; i < count; ++i) {
+                devices.push_back(std::make_shared<Blink1Device>());
+            }
+            return devices;
+        }
+};
+
+TEST_F(SUITE_NAME, TestSize) {
+    {
+        DeviceGroup group(makeDevices(3));
+        EXPECT_EQ(3, group.size());
+        EXPECT_EQ(3, group.getDevices().size());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFadeToRGB) {
+    {
+        DeviceGroup group(makeDevices(3));
+
+        auto result = group.fadeToRGB(100, RGB(1, 2, 3));
+
+        EXPECT_EQ(std::vector<bool>({true, true, true}), result.succeeded);
+        EXPECT_TRUE(result.allSucceeded());
+        EXPECT_EQ(3, result.successCount());
+        EXPECT_EQ(RGB(1, 2, 3), fake_blink1_lib::GET_RGB(0));
+        EXPECT_EQ(100, fake_blink1_lib::GET_FADE_MILLIS(0));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestColorOperations) {
+    {
+        DeviceGroup group(makeDevices(2));
+
+        EXPECT_TRUE(group.setRGB(RGB(4, 5, 6)).allSucceeded());
+        EXPECT_EQ(RGB(4, 5, 6), fake_blink1_lib::GET_RGB(0));
+
+        EXPECT_TRUE(group.fadeToRGBN(50, RGBN(7, 8, 9, 2)).allSucceeded());
+        EXPECT_EQ(RGB(7, 8, 9), fake_blink1_lib::GET_RGB(2));
+        EXPECT_EQ(50, fake_blink1_lib::GET_FADE_MILLIS(2));
+
+        EXPECT_TRUE(group.setRGBN(RGBN(1, 1, 1, 1)).allSucceeded());
+        EXPECT_EQ(RGB(1, 1, 1), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestPlayOperations) {
+    {
+        DeviceGroup group(makeDevices(2));
+
+        EXPECT_TRUE(group.play(4).allSucceeded());
+        EXPECT_TRUE(fake_blink1_lib::GET_PLAY_STATE().playing);
+
+        EXPECT_TRUE(group.stop().allSucceeded());
+        EXPECT_FALSE(fake_blink1_lib::GET_PLAY_STATE().playing);
+
+        EXPECT_TRUE(group.playLoop(1, 2, 3).allSucceeded());
+        EXPECT_EQ(PlayState(true, 1, 2, 3, 0), fake_blink1_lib::GET_PLAY_STATE());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWritePattern) {
+    {
+        DeviceGroup group(makeDevices(2));
+        std::vector<PatternLineN> lines{PatternLineN(1, 2, 3, 1, 10), PatternLineN(4, 5, 6, 2, 20)};
+
+        EXPECT_TRUE(group.writePattern(lines, 3).allSucceeded());
+        EXPECT_EQ(lines[0], fake_blink1_lib::GET_PATTERN_LINE(3));
+        EXPECT_EQ(lines[1], fake_blink1_lib::GET_PATTERN_LINE(4));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestFailures) {
+    {
+        auto devices = makeDevices(2);
+        devices.push_back(nullptr);
+        DeviceGroup group(devices);
+
+        auto result = group.setRGB(RGB(1, 2, 3));
+        EXPECT_EQ(std::vector<bool>({true, true, false}), result.succeeded);
+        EXPECT_FALSE(result.allSucceeded());
+        EXPECT_EQ(2, result.successCount());
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        result = group.stop();
+        EXPECT_EQ(0, result.successCount());
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestEmptyGroup) {
+    DeviceGroup group({});
+    auto result = group.fadeToRGB(10, RGB(1, 2, 3));
+    EXPECT_TRUE(result.succeeded.empty());
+    EXPECT_TRUE(result.allSucceeded());
+}
@@ -0,0 +1,53 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "FadeTimer.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME FadeTimer_test
+
+TEST(SUITE_NAME, TestRunsInDeadlineOrder) {
+    FadeTimer timer;
+    std::mutex orderMutex;
+    std::vector<int> order;
+    std::promise<void> done;
+
+    const auto now = std::chrono::steady_clock::now();
+    auto record = [&orderMutex, &order](int i) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(i);
+    };
+    timer.schedule(now + std::chrono::milliseconds(60), [&record, &done] { record(3); done.set_value(); });
+    timer.schedule(now + std::chrono::milliseconds(20), [&record] { record(1); });
+    timer.schedule(now + std::chrono::milliseconds(40), [&record] { record(2); });
+
+    EXPECT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+    EXPECT_GE(std::chrono::steady_clock::now() - now, std::chrono::milliseconds(60));
+
+    std::lock_guard<std::mutex> lock(orderMutex);
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), order);
+}
+
+TEST(SUITE_NAME, TestPastDeadlineRunsImmediately) {
+    FadeTimer timer;
+    std::promise<void> done;
+
+    timer.schedule(std::chrono::steady_clock::now() - std::chrono::seconds(1), [&done] { done.set_value(); });
+
+    EXPECT_EQ(std::future_status::ready, done.get_future().wait_for(std::chrono::seconds(5)));
+}
+
+TEST(SUITE_NAME, TestDestructorDiscardsPending) {
+    std::atomic<bool> ran{false};
+    {
+        FadeTimer timer;
+        timer.schedule(std::chrono::steady_clock::now() + std::chrono::hours(1), [&ran] { ran = true; });
+        EXPECT_EQ(1, timer.pendingCount());
+    }
+    EXPECT_FALSE(ran.load());
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "LatencyHistogram.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME LatencyHistogram_test
+
+TEST(SUITE_NAME, TestEmpty) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.count());
+    EXPECT_EQ(0ns, histogram.min());
+    EXPECT_EQ(0ns, histogram.max());
+    EXPECT_EQ(0ns, histogram.mean());
+    EXPECT_EQ(0ns, histogram.percentile(99));
+}
+
+TEST(SUITE_NAME, TestSmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 10; ++i) {
+        histogram.record(std::chrono::nanoseconds(i));
+    }
+
+    EXPECT_EQ(10, histogram.count());
+    EXPECT_EQ(1ns, histogram.min());
+    EXPECT_EQ(10ns, histogram.max());
+    EXPECT_EQ(5ns, histogram.mean());
+    EXPECT_EQ(5ns, histogram.percentile(50));
+    EXPECT_EQ(9ns, histogram.percentile(90));
+    EXPECT_EQ(10ns, histogram.percentile(100));
+    EXPECT_EQ(1ns, histogram.percentile(0));
+}
+
+TEST(SUITE_NAME, TestPercentilesWithinPrecision) {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.record(std::chrono::microseconds(i));
+    }
+
+    EXPECT_EQ(1000, histogram.count());
+    EXPECT_EQ(1us, histogram.min());
+    EXPECT_EQ(1000us, histogram.max());
+    for (const double percentile : {50.0, 90.0, 99.0, 99.9}) {
+        const auto expected = std::chrono::duration<double, std::micro>(percentile * 10);
+        const auto actual = std::chrono::duration<double, std::micro>(histogram.percentile(percentile));
+        EXPECT_GE(actual.count(), expected.count()) << "p" << percentile;
+        EXPECT_LE(actual.count(), expected.count() * 1.0625) << "p" << percentile;
+    }
+    EXPECT_EQ(1000us, histogram.percentile(100)) << "Expected the top percentile to be capped at the max";
+}
+
+TEST(SUITE_NAME, TestBucketsCoverEveryValue) {
+    // Each bucket starts one past the end of the previous one
+    std::chrono::nanoseconds previous(-1);
+    for (std::size_t bucket = 0; bucket + 1 < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+        const auto upper = LatencyHistogram::getBucketUpperBound(bucket);
+        ASSERT_GT(upper, previous) << "bucket " << bucket;
+
+        LatencyHistogram histogram;
+        histogram.record(previous + 1ns);
+        histogram.record(upper);
+        ASSERT_EQ(2, histogram.getBuckets()[bucket]) << "bucket " << bucket;
+        previous = upper;
+    }
+    // The last bucket holds the top sixteenth of the range along with everything above it
+    EXPECT_EQ(std::chrono::nanoseconds((std::int64_t{31} << 31) - 1), previous);
+}
+
+TEST(SUITE_NAME, TestOutOfRangeValues) {
+    LatencyHistogram histogram;
+    histogram.record(-5ns);
+    histogram.record(std::chrono::hours(2));
+
+    EXPECT_EQ(1, histogram.getBuckets()[0]) << "Expected negative values to be recorded as 0";
+    EXPECT_EQ(1, histogram.getBuckets()[LatencyHistogram::BUCKET_COUNT - 1]);
+    EXPECT_EQ(std::chrono::hours(2), histogram.max());
+    EXPECT_EQ(std::chrono::hours(2), histogram.percentile(100));
+}
+
+TEST(SUITE_NAME, TestMergeAndReset) {
+    LatencyHistogram first;
+    LatencyHistogram second;
+    LatencyHistogram both;
+    for (int i = 0; i < 100; ++i) {
+        first.record(std::chrono::microseconds(i));
+        both.record(std::chrono::microseconds(i));
+        second.record(std::chrono::milliseconds(i));
+        both.record(std::chrono::milliseconds(i));
+    }
+
+    first.merge(second);
+    EXPECT_EQ(both, first);
+    EXPECT_NE(second, first);
+
+    first.reset();
+    EXPECT_EQ(LatencyHistogram(), first);
+}
@@ -0,0 +1,196 @@
+#include <array>
+#include <chrono>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "PatternCompiler.hpp"
+#include "PatternSimplifier.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME PatternCompiler_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestSingleTrackCompilesExactly) {
+    const std::array<PatternLineN, 3> keyframes{
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 255, 0, 1, 200),
+        PatternLineN(0, 0, 255, 1, 300)
+    };
+
+    const auto program = PatternCompiler().compile(Animation(keyframes));
+    ASSERT_TRUE(program);
+    EXPECT_EQ(std::vector<PatternLineN>(keyframes.begin(), keyframes.end()), program->lines);
+    EXPECT_EQ(0, program->startPos);
+    EXPECT_EQ(2, program->endPos);
+    EXPECT_EQ(1, program->count) << "Expected an animation that doesn't loop to play once";
+    EXPECT_EQ(0.0, program->colorError);
+    EXPECT_EQ(0ms, program->timeError);
+
+    const auto looping = PatternCompiler().compile(Animation(keyframes, true), 4);
+    ASSERT_TRUE(looping);
+    EXPECT_EQ(4, looping->startPos);
+    EXPECT_EQ(6, looping->endPos);
+    EXPECT_EQ(0, looping->count) << "Expected a looping animation to play forever";
+}
+
+TEST_F(SUITE_NAME, TestRemovesRedundantKeyframes) {
+    const std::array<PatternLineN, 4> keyframes{
+        PatternLineN(0, 0, 0, 1, 0),
+        PatternLineN(100, 0, 0, 1, 100),
+        PatternLineN(200, 0, 0, 1, 100),
+        PatternLineN(0, 0, 0, 1, 100)
+    };
+
+    const auto program = PatternCompiler().compile(Animation(keyframes));
+    ASSERT_TRUE(program);
+    const std::vector<PatternLineN> expected{
+        PatternLineN(0, 0, 0, 1, 0),
+        PatternLineN(200, 0, 0, 1, 200),
+        PatternLineN(0, 0, 0, 1, 100)
+    };
+    EXPECT_EQ(expected, program->lines) << "Expected the keyframe halfway along a straight fade to be removed";
+    EXPECT_EQ(0.0, program->colorError);
+}
+
+TEST_F(SUITE_NAME, TestFitsCapacityWithinTolerance) {
+    std::vector<PatternLineN> keyframes;
+    for (int i = 0; i < 40; ++i) {
+        keyframes.emplace_back(static_cast<std::uint8_t>(100 + (i % 2) * 4), 0, 0, 1, 50);
+    }
+    keyframes.emplace_back(0, 0, 0, 1, 50);
+    const Animation animation(keyframes);
+
+    PatternCompiler compiler;
+    EXPECT_FALSE(compiler.compile(animation)) << "Expected too many lines to fit exactly";
+
+    compiler.setColorTolerance(5);
+    EXPECT_EQ(5.0, compiler.getColorTolerance());
+    const auto program = compiler.compile(animation);
+    ASSERT_TRUE(program);
+    EXPECT_LE(program->lines.size(), PatternCompiler::DEFAULT_CAPACITY);
+    EXPECT_LE(program->colorError, 5.0);
+    EXPECT_EQ(keyframes.front(), program->lines.front());
+    EXPECT_EQ(keyframes.back(), program->lines.back());
+
+    compiler.setCapacity(2);
+    EXPECT_FALSE(compiler.compile(animation));
+}
+
+TEST_F(SUITE_NAME, TestToleranceMatchesSimplifier) {
+    const std::array<PatternLineN, 3> keyframes{
+        PatternLineN(0, 0, 0, 1, 0),
+        PatternLineN(53, 60, 47, 1, 100),
+        PatternLineN(100, 100, 100, 1, 100)
+    };
+
+    for (const auto colorSpace : {PatternSimplifier::COLOR_SPACE::RGB, PatternSimplifier::COLOR_SPACE::CIELAB}) {
+        const double error = PatternSimplifier::fadeError(RGB(53, 60, 47), RGB(0, 0, 0), RGB(100, 100, 100), 0.5, colorSpace);
+        for (const double tolerance : {error * 0.99, error}) {
+            PatternCompiler compiler(PatternCompiler::DEFAULT_CAPACITY, tolerance);
+            compiler.setColorSpace(colorSpace);
+            EXPECT_EQ(colorSpace, compiler.getColorSpace());
+            const auto program = compiler.compile(Animation(keyframes));
+            ASSERT_TRUE(program);
+
+            const auto simplified = PatternSimplifier(tolerance, colorSpace).simplify(keyframes);
+            EXPECT_EQ(simplified.size(), program->lines.size()) << "Expected both to agree on whether the middle keyframe is needed";
+            EXPECT_EQ(tolerance < error ? 0.0 : error, program->colorError);
+        }
+    }
+}
+
+TEST_F(SUITE_NAME, TestMergesTracks) {
+    const std::array<PatternLineN, 4> keyframes{
+        PatternLineN(0, 0, 0, 1, 10),
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 255, 0, 2, 300),
+        PatternLineN(0, 0, 255, 2, 100)
+    };
+    const Animation animation(keyframes);
+
+    PatternCompiler compiler;
+    EXPECT_FALSE(compiler.compile(animation)) << "Expected fades that overlap to need some timing tolerance";
+
+    compiler.setTimeTolerance(290ms);
+    const auto program = compiler.compile(animation);
+    ASSERT_TRUE(program);
+    const std::vector<PatternLineN> expected{
+        PatternLineN(0, 0, 0, 1, 0),
+        PatternLineN(0, 255, 0, 2, 10),
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(255, 0, 0, 1, 190),
+        PatternLineN(0, 0, 255, 2, 100)
+    };
+    EXPECT_EQ(expected, program->lines);
+    EXPECT_EQ(290ms, program->timeError);
+}
+
+TEST_F(SUITE_NAME, TestFoldsRepeats) {
+    const std::array<PatternLineN, 6> keyframes{
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 0, 255, 1, 100),
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 0, 255, 1, 100),
+        PatternLineN(255, 0, 0, 1, 100),
+        PatternLineN(0, 0, 255, 1, 100)
+    };
+
+    const auto program = PatternCompiler().compile(Animation(keyframes, true));
+    ASSERT_TRUE(program);
+    const std::vector<PatternLineN> expected{keyframes[0], keyframes[1]};
+    EXPECT_EQ(expected, program->lines);
+    EXPECT_EQ(1, program->endPos);
+    EXPECT_EQ(0, program->count);
+
+    const auto once = PatternCompiler().compile(Animation(keyframes));
+    ASSERT_TRUE(once);
+    EXPECT_EQ(expected, once->lines);
+    EXPECT_EQ(3, once->count) << "Expected the repetitions to be played with a loop count";
+}
+
+TEST_F(SUITE_NAME, TestRejectsInvalidAnimations) {
+    PatternCompiler compiler;
+    EXPECT_FALSE(compiler.compile(Animation()));
+
+    const std::array<PatternLineN, 2> keyframes{PatternLineN(1, 2, 3, 1, 100), PatternLineN(1, 2, 3, 2, 200)};
+    EXPECT_FALSE(compiler.compile(Animation(keyframes, true))) << "Expected looping tracks of different lengths to fail";
+    EXPECT_FALSE(compiler.compile(Animation(keyframes), PatternCompiler::DEFAULT_CAPACITY)) << "Expected a start past the end of the table to fail";
+}
+
+TEST_F(SUITE_NAME, TestUpload) {
+    const std::array<PatternLineN, 2> keyframes{PatternLineN(255, 0, 0, 1, 100), PatternLineN(0, 0, 255, 2, 0)};
+    const auto program = PatternCompiler().compile(Animation(keyframes), 3);
+    ASSERT_TRUE(program);
+    {
+        Blink1Device device;
+        EXPECT_TRUE(PatternCompiler::upload(device, *program));
+        for (std::size_t i = 0; i < program->lines.size(); ++i) {
+            EXPECT_EQ(program->lines[i], fake_blink1_lib::GET_PATTERN_LINE(static_cast<long>(program->startPos + i)));
+        }
+        EXPECT_EQ(PlayState(true, program->startPos, program->endPos, program->count, 0), fake_blink1_lib::GET_PLAY_STATE());
+
+        fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(false);
+        device.clearPatternMirror();
+        EXPECT_FALSE(PatternCompiler::upload(device, *program));
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,103 @@
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "PatternFolder.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME PatternFolder_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+static std::vector<PatternLineN> repeat(const std::vector<PatternLineN>& block, const std::size_t times) {
+    std::vector<PatternLineN> lines;
+    for (std::size_t i = 0; i < times; ++i) {
+        lines.insert(lines.end(), block.begin(), block.end());
+    }
+    return lines;
+}
+
+static const std::vector<PatternLineN> BLOCK{
+    PatternLineN(255, 0, 0, 1, 100),
+    PatternLineN(0, 0, 0, 1, 100),
+    PatternLineN(0, 0, 255, 2, 200)
+};
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestPeriod) {
+    EXPECT_EQ(0u, PatternFolder::period(std::vector<PatternLineN>()));
+    EXPECT_EQ(3u, PatternFolder::period(BLOCK));
+    EXPECT_EQ(3u, PatternFolder::period(repeat(BLOCK, 5)));
+
+    auto partial = repeat(BLOCK, 2);
+    partial.pop_back();
+    EXPECT_EQ(partial.size(), PatternFolder::period(partial)) << "Expected a pattern that only partly repeats not to have a shorter period";
+
+    const std::vector<PatternLineN> same(4, BLOCK.front());
+    EXPECT_EQ(1u, PatternFolder::period(same));
+}
+
+TEST_F(SUITE_NAME, TestFold) {
+    const auto folded = PatternFolder::fold(repeat(BLOCK, 4), 2, 10);
+    ASSERT_TRUE(folded);
+    EXPECT_EQ(BLOCK, folded->lines);
+    EXPECT_EQ(10, folded->startPos);
+    EXPECT_EQ(12, folded->endPos);
+    EXPECT_EQ(8, folded->count) << "Expected the repetitions to multiply the loop count";
+
+    const auto forever = PatternFolder::fold(repeat(BLOCK, 4), 0);
+    ASSERT_TRUE(forever);
+    EXPECT_EQ(BLOCK, forever->lines);
+    EXPECT_EQ(0, forever->count);
+
+    auto partial = repeat(BLOCK, 2);
+    partial.pop_back();
+    const auto unfolded = PatternFolder::fold(partial);
+    ASSERT_TRUE(unfolded);
+    EXPECT_EQ(partial, unfolded->lines);
+    EXPECT_EQ(1, unfolded->count);
+}
+
+TEST_F(SUITE_NAME, TestFoldKeepsLoopCountInRange) {
+    const std::vector<PatternLineN> lines(100, BLOCK.front());
+    const auto folded = PatternFolder::fold(lines, 3);
+    ASSERT_TRUE(folded);
+    EXPECT_EQ(2u, folded->lines.size()) << "Expected two repetitions to stay in the table so the count fits";
+    EXPECT_EQ(150, folded->count);
+}
+
+TEST_F(SUITE_NAME, TestFoldFailures) {
+    EXPECT_FALSE(PatternFolder::fold(std::vector<PatternLineN>()));
+    EXPECT_FALSE(PatternFolder::fold(BLOCK, 1, 254)) << "Expected a pattern past the end of the table to fail";
+    EXPECT_TRUE(PatternFolder::fold(repeat(BLOCK, 10), 1, 253)) << "Expected a folded pattern to fit where the whole one wouldn't";
+}
+
+TEST_F(SUITE_NAME, TestUpload) {
+    const auto folded = PatternFolder::fold(repeat(BLOCK, 3), 1, 4);
+    ASSERT_TRUE(folded);
+    {
+        Blink1Device device;
+        EXPECT_TRUE(PatternFolder::upload(device, *folded));
+        for (std::size_t i = 0; i < BLOCK.size(); ++i) {
+            EXPECT_EQ(BLOCK[i], fake_blink1_lib::GET_PATTERN_LINE(static_cast<long>(4 + i)));
+        }
+        EXPECT_EQ(PlayState(true, 4, 6, 3, 0), fake_blink1_lib::GET_PLAY_STATE());
+    }
+    checkDevicesFreed();
+}
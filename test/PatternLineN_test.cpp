@@ -1,3 +1,4 @@
+#include <array>
 #include <sstream>
 
 #include "gtest/gtest.h"
@@ -48,6 +49,16 @@ TEST(SUITE_NAME, TestEqual) {
     EXPECT_NE(patternLine, notEqualPatternLine5);
 }
 
+TEST(SUITE_NAME, TestCompare) {
+    // A pattern table built at compile time
+    constexpr std::array<PatternLineN, 2> table{PatternLineN(255, 0, 0, 1, 100), PatternLineN(RGBN(0, 0, 255, 2), 100)};
+    static_assert(table[0] == PatternLineN(RGBN(255, 0, 0, 1), 100));
+    static_assert(table[1] < table[0]);
+    static_assert(PatternLineN(0, 0, 0, 0, 101) > table[0]);
+
+    EXPECT_NE(table[0], table[1]);
+}
+
 TEST(SUITE_NAME, TestOutputOperator) {
     PatternLineN patternLine(1, 2, 3, 4, 5);
     std::stringstream ss;
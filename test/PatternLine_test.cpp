@@ -43,6 +43,15 @@ TEST(SUITE_NAME, TestEqual) {
     EXPECT_NE(patternLine, notEqualPatternLine4);
 }
 
+TEST(SUITE_NAME, TestCompare) {
+    constexpr PatternLine line(RGB(1, 2, 3), 100);
+    static_assert(line == PatternLine(1, 2, 3, 100));
+    static_assert(line < PatternLine(0, 0, 0, 101));
+    static_assert(line > PatternLine(1, 2, 2, 100));
+
+    EXPECT_GT(PatternLine(0, 0, 1, 5), PatternLine(0, 0, 0, 5));
+}
+
 TEST(SUITE_NAME, TestOutputOperator) {
     PatternLine patternLine(1, 2, 3, 4);
     std::stringstream ss;
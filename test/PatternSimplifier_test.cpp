@@ -0,0 +1,87 @@
+#include <array>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "PatternSimplifier.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME PatternSimplifier_test
+
+using COLOR_SPACE = PatternSimplifier::COLOR_SPACE;
+
+TEST(SUITE_NAME, TestRemovesLinesOnAStraightFade) {
+    const std::array<PatternLine, 5> lines{
+        PatternLine(0, 0, 0, 100),
+        PatternLine(50, 0, 0, 100),
+        PatternLine(100, 0, 0, 100),
+        PatternLine(150, 0, 0, 100),
+        PatternLine(0, 0, 0, 200)
+    };
+
+    const std::vector<PatternLine> expected{PatternLine(0, 0, 0, 100), PatternLine(150, 0, 0, 300), PatternLine(0, 0, 0, 200)};
+    EXPECT_EQ(expected, PatternSimplifier().simplify(lines));
+}
+
+TEST(SUITE_NAME, TestTolerance) {
+    const std::array<PatternLine, 4> lines{
+        PatternLine(0, 0, 0, 0),
+        PatternLine(110, 0, 0, 100),
+        PatternLine(200, 0, 0, 100),
+        PatternLine(200, 30, 0, 100)
+    };
+
+    PatternSimplifier simplifier;
+    EXPECT_EQ(4u, simplifier.simplify(lines).size()) << "Expected every line to be kept with no tolerance";
+
+    simplifier.setTolerance(10);
+    EXPECT_EQ(10, simplifier.getTolerance());
+    const std::vector<PatternLine> expected{PatternLine(0, 0, 0, 0), PatternLine(200, 0, 0, 200), PatternLine(200, 30, 0, 100)};
+    EXPECT_EQ(expected, simplifier.simplify(lines)) << "Expected the line furthest from the fade to be kept";
+
+    simplifier.setTolerance(100);
+    const std::vector<PatternLine> merged{PatternLine(0, 0, 0, 0), PatternLine(200, 30, 0, 300)};
+    EXPECT_EQ(merged, simplifier.simplify(lines));
+}
+
+TEST(SUITE_NAME, TestKeepsFadesShortEnoughForOneLine) {
+    const std::array<PatternLine, 3> lines{PatternLine(0, 0, 0, 0), PatternLine(0, 0, 0, 40000), PatternLine(0, 0, 0, 40000)};
+    EXPECT_EQ(3u, PatternSimplifier().simplify(lines).size());
+}
+
+TEST(SUITE_NAME, TestSimplifiesEachLedSeparately) {
+    const std::array<PatternLineN, 6> lines{
+        PatternLineN(0, 0, 0, 1, 100),
+        PatternLineN(10, 0, 0, 1, 100),
+        PatternLineN(20, 0, 0, 1, 100),
+        PatternLineN(0, 0, 0, 2, 100),
+        PatternLineN(0, 10, 0, 2, 100),
+        PatternLineN(0, 20, 0, 2, 100)
+    };
+
+    const std::vector<PatternLineN> expected{
+        PatternLineN(0, 0, 0, 1, 100),
+        PatternLineN(20, 0, 0, 1, 200),
+        PatternLineN(0, 0, 0, 2, 100),
+        PatternLineN(0, 20, 0, 2, 200)
+    };
+    EXPECT_EQ(expected, PatternSimplifier().simplify(lines));
+    EXPECT_TRUE(PatternSimplifier().simplify(std::span<const PatternLineN>()).empty());
+}
+
+TEST(SUITE_NAME, TestColorSpaces) {
+    EXPECT_DOUBLE_EQ(5, PatternSimplifier::distance(RGB(0, 3, 4), RGB(0, 0, 0), COLOR_SPACE::RGB));
+    EXPECT_NEAR(100, PatternSimplifier::distance(RGB(0, 0, 0), RGB(255, 255, 255), COLOR_SPACE::CIELAB), 0.01);
+
+    // The same step in RGB is easier to see in green than in blue
+    const double green = PatternSimplifier::distance(RGB(0, 128, 0), RGB(0, 138, 0), COLOR_SPACE::CIELAB);
+    const double blue = PatternSimplifier::distance(RGB(0, 0, 128), RGB(0, 0, 138), COLOR_SPACE::CIELAB);
+    EXPECT_GT(green, blue);
+
+    const std::array<PatternLine, 3> lines{PatternLine(0, 0, 245, 0), PatternLine(0, 0, 255, 100), PatternLine(0, 0, 245, 100)};
+    PatternSimplifier simplifier(6, COLOR_SPACE::RGB);
+    EXPECT_EQ(3u, simplifier.simplify(lines).size());
+    simplifier.setColorSpace(COLOR_SPACE::CIELAB);
+    EXPECT_EQ(COLOR_SPACE::CIELAB, simplifier.getColorSpace());
+    EXPECT_EQ(2u, simplifier.simplify(lines).size()) << "Expected a step that is hard to see to be merged";
+}
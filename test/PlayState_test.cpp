@@ -41,6 +41,14 @@ TEST(SUITE_NAME, TestEqual) {
     EXPECT_NE(playState, notEqualPlayState5);
 }
 
+TEST(SUITE_NAME, TestCompare) {
+    static_assert(PlayState(true, 1, 2, 3, 4) == PlayState(true, 1, 2, 3, 4));
+    static_assert(PlayState(false, 9, 9, 9, 9) < PlayState(true, 0, 0, 0, 0));
+    static_assert(PlayState(true, 1, 2, 3, 4) < PlayState(true, 1, 2, 3, 5));
+
+    EXPECT_EQ(PlayState(), PlayState(false, 0, 0, 0, 0));
+}
+
 TEST(SUITE_NAME, TestOutputOperator) {
     PlayState playState(true, 1, 2, 3, 4);
     std::stringstream ss;
@@ -0,0 +1,251 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+#include "AsyncBlink1Device.hpp"
+#include "Blink1Device.hpp"
+#include "Blink1TestingLibrary.hpp"
+#include "PrometheusExporter.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME PrometheusExporter_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+static bool contains(const std::string& text, const std::string& line) {
+    return text.find(line + "\n") != std::string::npos;
+}
+
+// Connects to a unix socket, sends a request and returns everything sent back
+static std::string scrape(const std::string& path) {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return "";
+    }
+
+    const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    EXPECT_EQ(static_cast<ssize_t>(request.size()), ::send(fd, request.data(), request.size(), MSG_NOSIGNAL));
+
+    std::string response;
+    std::array<char, 4096> buffer{};
+    ssize_t received = 0;
+    while ((received = ::recv(fd, buffer.data(), buffer.size(), 0)) > 0) {
+        response.append(buffer.data(), static_cast<std::size_t>(received));
+    }
+    ::close(fd);
+    return response;
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+};
+
+TEST_F(SUITE_NAME, TestExportsCommandsAndFailures) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0001", "/dev/hidraw1");
+    {
+        auto device = std::make_shared<Blink1Device>("AAAA0001", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        PrometheusExporter exporter;
+        exporter.addDevice(device);
+        EXPECT_TRUE(device->isMetricsEnabled()) << "Expected adding the device to enable metrics";
+
+        EXPECT_TRUE(device->setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(device->setRGB(RGB(4, 5, 6)));
+        fake_blink1_lib::DISCONNECT("AAAA0001");
+        EXPECT_FALSE(device->play(0));
+
+        const std::string text = exporter.render();
+        EXPECT_TRUE(contains(text, "# TYPE blink1_commands_total counter"));
+        EXPECT_TRUE(contains(text, "blink1_up{serial=\"AAAA0001\"} 0")) << "Expected an unplugged device to be down";
+        EXPECT_TRUE(contains(text, "blink1_commands_total{serial=\"AAAA0001\",operation=\"set_rgb\"} 2"));
+        EXPECT_TRUE(contains(text, "blink1_commands_total{serial=\"AAAA0001\",operation=\"play\"} 1"));
+        EXPECT_TRUE(contains(text, "blink1_command_failures_total{serial=\"AAAA0001\",operation=\"set_rgb\"} 0"));
+        EXPECT_TRUE(contains(text, "blink1_command_failures_total{serial=\"AAAA0001\",operation=\"play\"} 1"));
+        EXPECT_TRUE(contains(text, "blink1_command_latency_seconds_count{serial=\"AAAA0001\",operation=\"set_rgb\"} 2"));
+        EXPECT_NE(std::string::npos, text.find("blink1_command_latency_seconds{serial=\"AAAA0001\",operation=\"set_rgb\",quantile=\"0.99\"} "));
+        EXPECT_TRUE(contains(text, "# TYPE blink1_queue_depth gauge"));
+        EXPECT_EQ(std::string::npos, text.find("blink1_queue_depth{")) << "Expected no queue metrics without an AsyncBlink1Device";
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestExportsLatencyQuantiles) {
+    auto clock = std::make_shared<VirtualClock>();
+    {
+        auto device = std::make_shared<Blink1Device>();
+        device->setClock(clock);
+        PrometheusExporter exporter;
+        exporter.addDevice(device);
+        EXPECT_TRUE(device->stop());
+
+        // Nothing advances the virtual clock, so the command took no time
+        const std::string text = exporter.render();
+        EXPECT_TRUE(contains(text, "# TYPE blink1_command_latency_seconds summary"));
+        EXPECT_TRUE(contains(text, "blink1_command_latency_seconds{serial=\"\",operation=\"stop\",quantile=\"0.5\"} 0"));
+        EXPECT_TRUE(contains(text, "blink1_command_latency_seconds{serial=\"\",operation=\"stop\",quantile=\"0.9\"} 0"));
+        EXPECT_TRUE(contains(text, "blink1_command_latency_seconds_sum{serial=\"\",operation=\"stop\"} 0"));
+        EXPECT_TRUE(contains(text, "blink1_command_latency_seconds_count{serial=\"\",operation=\"stop\"} 1"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestExportsQueue) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0002", "/dev/hidraw2");
+    {
+        Blink1Device device("AAAA0002", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        auto async = std::make_shared<AsyncBlink1Device>(device, 16);
+        PrometheusExporter exporter;
+        exporter.addDevice(async);
+        EXPECT_TRUE(device.isMetricsEnabled());
+
+        EXPECT_TRUE(async->setRGB(RGB(1, 2, 3)).get());
+        async->flush();
+
+        const std::string text = exporter.render();
+        EXPECT_TRUE(contains(text, "blink1_queue_depth{serial=\"AAAA0002\"} 0"));
+        EXPECT_TRUE(contains(text, "blink1_queue_capacity{serial=\"AAAA0002\"} 16"));
+        EXPECT_TRUE(contains(text, "blink1_coalesced_writes_total{serial=\"AAAA0002\"} 0"));
+        EXPECT_TRUE(contains(text, "blink1_commands_total{serial=\"AAAA0002\",operation=\"set_rgb\"} 1"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestEscapesLabels) {
+    fake_blink1_lib::SET_SERIAL("A\"B\\C");
+    {
+        PrometheusExporter exporter;
+        exporter.addDevice(std::make_shared<Blink1Device>());
+        EXPECT_TRUE(contains(exporter.render(), "blink1_up{serial=\"A\\\"B\\\\C\"} 1"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestUpFollowsConnection) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0003", "/dev/hidraw3");
+    {
+        auto device = std::make_shared<Blink1Device>("AAAA0003", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        PrometheusExporter exporter;
+        EXPECT_TRUE(exporter.addDevice(device));
+        EXPECT_TRUE(contains(exporter.render(), "blink1_up{serial=\"AAAA0003\"} 1"));
+
+        // Scraping doesn't talk to the device, so it stays up until a command fails
+        fake_blink1_lib::DISCONNECT("AAAA0003");
+        EXPECT_TRUE(contains(exporter.render(), "blink1_up{serial=\"AAAA0003\"} 1"));
+        EXPECT_FALSE(device->setRGB(RGB(1, 2, 3)));
+        EXPECT_TRUE(contains(exporter.render(), "blink1_up{serial=\"AAAA0003\"} 0"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestRejectsDuplicates) {
+    fake_blink1_lib::ADD_DEVICE("AAAA0004", "/dev/hidraw4");
+    fake_blink1_lib::ADD_DEVICE("AAAA0005", "/dev/hidraw5");
+    {
+        auto device = std::make_shared<Blink1Device>("AAAA0004", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        auto async = std::make_shared<AsyncBlink1Device>(*device);
+        PrometheusExporter exporter;
+        EXPECT_TRUE(exporter.addDevice(device));
+        EXPECT_FALSE(exporter.addDevice(device)) << "Expected adding the same device twice to fail";
+        EXPECT_FALSE(exporter.addDevice(async)) << "Expected adding a device through its queue to fail";
+        EXPECT_FALSE(exporter.addDevice(std::make_shared<Blink1Device>("AAAA0004", Blink1Device::STRING_INIT_TYPE::SERIAL)))
+            << "Expected a second device with the same serial to fail";
+
+        // Both serials are unreadable, so both would be labelled with an empty serial
+        auto first = std::make_shared<Blink1Device>("AAAA0005", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        auto second = std::make_shared<Blink1Device>("AAAA0005", Blink1Device::STRING_INIT_TYPE::SERIAL);
+        fake_blink1_lib::DISCONNECT("AAAA0005");
+        EXPECT_TRUE(exporter.addDevice(first));
+        EXPECT_FALSE(exporter.addDevice(second)) << "Expected a second device without a serial to fail";
+
+        const std::string text = exporter.render();
+        EXPECT_EQ(text.find("blink1_up{serial=\"AAAA0004\"}"), text.rfind("blink1_up{serial=\"AAAA0004\"}"));
+        EXPECT_EQ(text.find("blink1_up{serial=\"\"}"), text.rfind("blink1_up{serial=\"\"}"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestClearDevices) {
+    {
+        PrometheusExporter exporter;
+        exporter.addDevice(std::make_shared<Blink1Device>());
+        exporter.clearDevices();
+        EXPECT_EQ(std::string::npos, exporter.render().find("blink1_up{"));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestWriteTextfile) {
+    const std::string path = ::testing::TempDir() + "PrometheusExporter_test.prom";
+    {
+        PrometheusExporter exporter;
+        exporter.addDevice(std::make_shared<Blink1Device>());
+        ASSERT_TRUE(exporter.writeTextfile(path));
+
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string text = contents.str();
+        EXPECT_EQ(exporter.render(), text);
+        EXPECT_TRUE(contains(text, "blink1_up{serial=\"\"} 1"));
+        EXPECT_TRUE(contains(text, "blink1_commands_total{serial=\"\",operation=\"read_play_state\"} 0")) << "Expected scraping not to send commands";
+        EXPECT_TRUE(contains(text, "# TYPE blink1_coalesced_writes_total counter"));
+        EXPECT_FALSE(std::filesystem::exists(path + ".tmp")) << "Expected the temporary file to be renamed";
+    }
+    std::remove(path.c_str());
+    checkDevicesFreed();
+
+    PrometheusExporter exporter;
+    EXPECT_FALSE(exporter.writeTextfile(::testing::TempDir() + "missing-directory/metrics.prom"));
+}
+
+TEST_F(SUITE_NAME, TestServeOverSocket) {
+    const std::string path = ::testing::TempDir() + "PrometheusExporter_test.sock";
+    {
+        auto device = std::make_shared<Blink1Device>();
+        PrometheusExporter exporter;
+        exporter.addDevice(device);
+        EXPECT_TRUE(device->setRGB(RGB(1, 2, 3)));
+
+        ASSERT_TRUE(exporter.serve(path));
+        EXPECT_TRUE(exporter.isServing());
+        EXPECT_FALSE(exporter.serve(path)) << "Expected serving twice to fail";
+
+        const std::string response = scrape(path);
+        EXPECT_EQ(0u, response.find("HTTP/1.0 200 OK\r\n"));
+        EXPECT_NE(std::string::npos, response.find("Content-Type: text/plain; version=0.0.4\r\n"));
+        EXPECT_TRUE(contains(response, "blink1_commands_total{serial=\"\",operation=\"set_rgb\"} 1"));
+
+        EXPECT_TRUE(device->setRGB(RGB(4, 5, 6)));
+        EXPECT_TRUE(contains(scrape(path), "blink1_commands_total{serial=\"\",operation=\"set_rgb\"} 2"));
+
+        exporter.stopServing();
+        EXPECT_FALSE(exporter.isServing());
+        EXPECT_FALSE(std::filesystem::exists(path)) << "Expected the socket to be removed";
+        EXPECT_EQ("", scrape(path));
+    }
+    checkDevicesFreed();
+}
@@ -36,6 +36,14 @@ TEST(SUITE_NAME, TestEqual) {
     EXPECT_NE(rgbn, notEqualRGBN4);
 }
 
+TEST(SUITE_NAME, TestCompare) {
+    static_assert(RGBN(1, 2, 3, 4) == RGBN(1, 2, 3, 4));
+    static_assert(RGBN(1, 2, 3, 4) < RGBN(1, 2, 3, 5));
+    static_assert(RGBN(1, 2, 4, 0) > RGBN(1, 2, 3, 5));
+
+    EXPECT_LT(RGBN(0, 0, 0, 1), RGBN(0, 0, 1, 0));
+}
+
 TEST(SUITE_NAME, TestOutputOperator) {
     std::stringstream ss;
     RGBN rgbn(5, 6, 7, 8);
@@ -32,6 +32,15 @@ TEST(SUITE_NAME, TestEqual) {
     EXPECT_NE(rgb, notEqualRGB3);
 }
 
+TEST(SUITE_NAME, TestCompare) {
+    static_assert(RGB(1, 2, 3) == RGB(1, 2, 3));
+    static_assert(RGB(1, 2, 3) < RGB(1, 2, 4));
+    static_assert(RGB(2, 0, 0) > RGB(1, 255, 255));
+
+    EXPECT_LT(RGB(0, 5, 9), RGB(0, 6, 0));
+    EXPECT_EQ(std::strong_ordering::equal, RGB(4, 5, 6) <=> RGB(4, 5, 6));
+}
+
 TEST(SUITE_NAME, TestOutputOperator) {
     std::stringstream ss;
     RGB rgb(5, 6, 7);
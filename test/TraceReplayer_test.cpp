@@ -0,0 +1,153 @@
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "TraceReplayer.hpp"
+#include "Blink1TestingLibrary.hpp"
+
+using namespace blink1_lib;
+using namespace std::chrono_literals;
+
+#define SUITE_NAME TraceReplayer_test
+
+static void checkDevicesFreed() {
+    EXPECT_TRUE(fake_blink1_lib::ALL_DEVICES_FREED()) << "Expected all devices to be freed at the end of the test";
+}
+
+class SUITE_NAME : public ::testing::Test {
+    protected:
+        std::shared_ptr<VirtualClock> clock = std::make_shared<VirtualClock>();
+
+        void SetUp() override {
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_OPERATION(true);
+            fake_blink1_lib::SET_BLINK1_SUCCESSFUL_INIT(true);
+        }
+
+        void TearDown() override {
+            fake_blink1_lib::CLEAR_ALL();
+        }
+
+        // Sets LED 1 to (i, i, i) at i seconds, for i from 1 to 3
+        static CommandTrace makeTrace() {
+            CommandTrace trace;
+            for (std::uint8_t i = 1; i <= 3; ++i) {
+                CommandTrace::Entry entry;
+                entry.time = std::chrono::seconds(i);
+                entry.command = CommandTrace::COMMAND::SET_RGBN;
+                entry.rgbn = RGBN(i, i, i, 1);
+                trace.add(entry);
+            }
+            return trace;
+        }
+};
+
+TEST_F(SUITE_NAME, TestReplaysAtRecordedSpeed) {
+    {
+        Blink1Device device;
+        TraceReplayer replayer(device, clock);
+
+        TraceReplayer::Result result;
+        std::thread replay([&replayer, &result] {
+            result = replayer.replay(makeTrace());
+        });
+
+        // Deadlines are absolute, so this only needs to wait for the replay to start
+        clock->waitForSleepers(1);
+        clock->advance(3s);
+        replay.join();
+
+        EXPECT_EQ(3, result.commandsSent);
+        EXPECT_EQ(0, result.failures);
+        EXPECT_EQ(3s, result.elapsed);
+        EXPECT_DOUBLE_EQ(1.0, result.commandsPerSecond());
+        EXPECT_EQ(RGB(3, 3, 3), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReplaysFaster) {
+    {
+        Blink1Device device;
+        TraceReplayer replayer(device, clock);
+
+        TraceReplayer::Result result;
+        std::thread replay([&replayer, &result] {
+            result = replayer.replay(makeTrace(), 4);
+        });
+
+        clock->waitForSleepers(1);
+        clock->advance(750ms);
+        replay.join();
+
+        EXPECT_EQ(3, result.commandsSent);
+        EXPECT_EQ(750ms, result.elapsed);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestReplaysAtMaxSpeed) {
+    {
+        Blink1Device device;
+        TraceReplayer replayer(device, clock);
+
+        const auto result = replayer.replay(makeTrace(), TraceReplayer::MAX_SPEED);
+        EXPECT_EQ(3, result.commandsSent);
+        EXPECT_EQ(0s, result.elapsed) << "Expected the clock never to be waited on";
+        EXPECT_EQ(0, result.commandsPerSecond());
+        EXPECT_EQ(RGB(3, 3, 3), fake_blink1_lib::GET_RGB(1));
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestNonFiniteSpeedsAreMaxSpeed) {
+    {
+        Blink1Device device;
+        TraceReplayer replayer(device, clock);
+
+        for (const double speed : {std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()}) {
+            const auto result = replayer.replay(makeTrace(), speed);
+            EXPECT_EQ(3, result.commandsSent);
+            EXPECT_EQ(0s, result.elapsed) << "Expected the clock never to be waited on";
+        }
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestTinySpeedIsClamped) {
+    {
+        Blink1Device device;
+        TraceReplayer replayer(device, clock);
+
+        TraceReplayer::Result result;
+        std::thread replay([&replayer, &result] {
+            result = replayer.replay(makeTrace(), std::numeric_limits<double>::denorm_min());
+        });
+
+        // Every scaled time is past what the clock can hold, so every deadline is the latest time
+        clock->waitForSleepers(1);
+        clock->advanceTo(Clock::time_point::max());
+        replay.join();
+
+        EXPECT_EQ(3, result.commandsSent);
+        EXPECT_EQ(Clock::time_point::max() - Clock::time_point{}, result.elapsed);
+    }
+    checkDevicesFreed();
+}
+
+TEST_F(SUITE_NAME, TestCountsFailures) {
+    {
+        Blink1Device device;
+        TraceReplayer replayer(device, clock);
+
+        fake_blink1_lib::FaultModel model;
+        model.failAfterCalls = 1;
+        fake_blink1_lib::SET_FAULT_MODEL(model);
+
+        const auto result = replayer.replay(makeTrace(), TraceReplayer::MAX_SPEED);
+        EXPECT_EQ(3, result.commandsSent);
+        EXPECT_EQ(2, result.failures);
+    }
+    checkDevicesFreed();
+}
@@ -0,0 +1,66 @@
+#include <atomic>
+#include <latch>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "WorkerPool.hpp"
+
+using namespace blink1_lib;
+
+#define SUITE_NAME WorkerPool_test
+
+TEST(SUITE_NAME, TestSize) {
+    WorkerPool pool(3);
+    EXPECT_EQ(3, pool.size());
+
+    WorkerPool defaultPool;
+    EXPECT_LE(1, defaultPool.size());
+}
+
+TEST(SUITE_NAME, TestParallelFor) {
+    WorkerPool pool(4);
+    std::vector<int> values(100, 0);
+
+    pool.parallelFor(values.size(), [&values](std::size_t i) {
+        values[i] = static_cast<int>(i) * 2;
+    });
+
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(static_cast<int>(i) * 2, values[i]);
+    }
+}
+
+TEST(SUITE_NAME, TestParallelForRunsConcurrently) {
+    WorkerPool pool(4);
+
+    // Every task waits for all of the others, so this only finishes if they run at the same time
+    std::latch allStarted(4);
+    pool.parallelFor(4, [&allStarted](std::size_t) {
+        allStarted.arrive_and_wait();
+    });
+}
+
+TEST(SUITE_NAME, TestParallelForRethrows) {
+    WorkerPool pool(2);
+    std::atomic<int> finished{0};
+
+    EXPECT_THROW(pool.parallelFor(10, [&finished](std::size_t i) {
+        if (i == 3) {
+            throw std::runtime_error("failure");
+        }
+        ++finished;
+    }), std::runtime_error);
+    EXPECT_EQ(9, finished.load()) << "Expected the other tasks to run to completion";
+}
+
+TEST(SUITE_NAME, TestDestructorRunsQueuedTasks) {
+    std::atomic<int> finished{0};
+    {
+        WorkerPool pool(1);
+        for (int i = 0; i < 10; ++i) {
+            pool.submit([&finished] { ++finished; });
+        }
+    }
+    EXPECT_EQ(10, finished.load());
+}